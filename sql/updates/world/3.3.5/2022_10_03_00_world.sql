@@ -0,0 +1,7 @@
+--
+DELETE FROM `command` WHERE `name`='debug opcodestats';
+INSERT INTO `command` (`name`,`help`) VALUES
+('debug opcodestats', "Syntax: .debug opcodestats [reset] [#count]
+
+Shows the #count (default 10) client opcodes with the highest total handler time, with packet and byte counts, handler time percentiles and queue wait time, followed by the sessions with the highest handler time since login.
+Use reset to clear the opcode statistics.");
@@ -0,0 +1,6 @@
+--
+DELETE FROM `command` WHERE `name`='debug mapupdate';
+INSERT INTO `command` (`name`,`help`) VALUES
+('debug mapupdate', "Syntax: .debug mapupdate
+
+Shows the median, 99th percentile and maximum time of every update phase of your current map over the last ticks, and the phase breakdown of the last update that exceeded MapUpdate.SpikeThreshold.");
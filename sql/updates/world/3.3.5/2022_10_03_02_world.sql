@@ -0,0 +1,7 @@
+--
+DELETE FROM `command` WHERE `name`='debug smartai';
+INSERT INTO `command` (`name`,`help`) VALUES
+('debug smartai', "Syntax: .debug smartai [#iterations]
+
+Runs every loaded smart_scripts action #iterations times (default 1) with the selected SmartAI creature as owner and you as invoker, and shows the time of target selection and action dispatch through the interpreter and through the handlers compiled at load time.
+Compiled actions are dispatched without targets, so nothing is cast.");
@@ -23,6 +23,7 @@
 #include <G3D/AABox.h>
 
 #include "Define.h"
+#include "Errors.h"
 
 #include <stdexcept>
 #include <vector>
@@ -31,7 +32,15 @@
 #include <cmath>
 #include "string.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BIH_SSE 1
+#include <emmintrin.h>
+#else
+#define BIH_SSE 0
+#endif
+
 #define MAX_STACK_SIZE 64
+#define BIH_RAY_PACKET_SIZE 4
 
 // https://stackoverflow.com/a/4328396
 
@@ -252,6 +261,239 @@ class TC_COMMON_API BIH
             }
         }
 
+        /** Traverses the tree with up to BIH_RAY_PACKET_SIZE rays at once, stopping each ray at its first hit.
+            Nodes are visited once for the whole packet and the node tests are done for all rays with SSE.
+            Leaf objects are passed to the callback per active ray, a ray is retired from the packet as soon as
+            the callback reports a hit for it. Without SSE the rays are traced one by one.
+            hits[i] is set to true for every ray that hit something within maxDist[i], false otherwise. */
+        template<typename RayCallback>
+        void intersectRayPacket(G3D::Ray const* rays, uint32 count, float const* maxDist, RayCallback& intersectCallback, bool* hits) const
+        {
+            ASSERT(count <= BIH_RAY_PACKET_SIZE);
+
+#if BIH_SSE
+            alignas(16) float org[3][BIH_RAY_PACKET_SIZE];
+            alignas(16) float invDir[3][BIH_RAY_PACKET_SIZE];
+            alignas(16) float negDir[3][BIH_RAY_PACKET_SIZE];
+            alignas(16) float initMin[BIH_RAY_PACKET_SIZE];
+            alignas(16) float initMax[BIH_RAY_PACKET_SIZE];
+            float dist[BIH_RAY_PACKET_SIZE];
+
+            uint32 activeMask = 0;
+            uint32 retiredMask = 0;
+            for (uint32 lane = 0; lane < BIH_RAY_PACKET_SIZE; ++lane)
+            {
+                // pad unused lanes with a copy of the first ray, they never become active
+                G3D::Ray const& ray = rays[lane < count ? lane : 0];
+                G3D::Vector3 const& o = ray.origin();
+                G3D::Vector3 const& d = ray.direction();
+
+                float intervalMin = -1.f;
+                float intervalMax = -1.f;
+                dist[lane] = maxDist[lane < count ? lane : 0];
+                bool missed = false;
+                for (int i = 0; i < 3; ++i)
+                {
+                    org[i][lane] = o[i];
+                    invDir[i][lane] = 1.f / d[i];
+                    negDir[i][lane] = intBitsToFloat((floatToRawIntBits(d[i]) >> 31) ? 0xFFFFFFFF : 0);
+                    if (G3D::fuzzyNe(d[i], 0.0f))
+                    {
+                        float t1 = (bounds.low()[i] - o[i]) * invDir[i][lane];
+                        float t2 = (bounds.high()[i] - o[i]) * invDir[i][lane];
+                        if (t1 > t2)
+                            std::swap(t1, t2);
+                        if (t1 > intervalMin)
+                            intervalMin = t1;
+                        if (t2 < intervalMax || intervalMax < 0.f)
+                            intervalMax = t2;
+                        if (intervalMax <= 0 || intervalMin >= dist[lane])
+                            missed = true;
+                    }
+                }
+
+                if (lane < count)
+                    hits[lane] = false;
+
+                initMin[lane] = std::max(intervalMin, 0.f);
+                initMax[lane] = std::min(intervalMax, dist[lane]);
+                if (lane < count && !missed && intervalMin <= intervalMax)
+                    activeMask |= 1 << lane;
+            }
+
+            if (!activeMask)
+                return;
+
+            // near child order for the packet, decided by the direction of the majority of rays
+            uint32 rightFirst[3];
+            for (int i = 0; i < 3; ++i)
+            {
+                uint32 negCount = 0;
+                uint32 activeCount = 0;
+                for (uint32 lane = 0; lane < count; ++lane)
+                {
+                    if (!(activeMask & (1 << lane)))
+                        continue;
+
+                    negCount += floatToRawIntBits(negDir[i][lane]) & 1;
+                    ++activeCount;
+                }
+                rightFirst[i] = negCount * 2 > activeCount;
+            }
+
+            __m128 intervalMin = _mm_load_ps(initMin);
+            __m128 intervalMax = _mm_load_ps(initMax);
+
+            PacketStackNode stack[MAX_STACK_SIZE];
+            int stackPos = 0;
+            int node = 0;
+
+            while (true)
+            {
+                while (true)
+                {
+                    uint32 tn = tree[node];
+                    uint32 axis = (tn & (3 << 30)) >> 30;
+                    bool BVH2 = (tn & (1 << 29)) != 0;
+                    int offset = tn & ~(7 << 29);
+                    if (!BVH2)
+                    {
+                        if (axis < 3)
+                        {
+                            // "normal" interior node, left clip is the max of the left child, right clip the min of the right child
+                            __m128 o = _mm_load_ps(org[axis]);
+                            __m128 inv = _mm_load_ps(invDir[axis]);
+                            __m128 neg = _mm_load_ps(negDir[axis]);
+                            __m128 tl = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(intBitsToFloat(tree[node + 1])), o), inv);
+                            __m128 tr = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(intBitsToFloat(tree[node + 2])), o), inv);
+                            __m128 tf = Select(neg, tr, tl);
+                            __m128 tb = Select(neg, tl, tr);
+                            // same comparisons as intersectRay, so NaN clip distances keep the interval unchanged
+                            __m128 nearMax = Select(_mm_cmple_ps(tf, intervalMax), tf, intervalMax);
+                            __m128 farMin = Select(_mm_cmpge_ps(tb, intervalMin), tb, intervalMin);
+                            __m128 leftMin = Select(neg, farMin, intervalMin);
+                            __m128 leftMax = Select(neg, intervalMax, nearMax);
+                            __m128 rightMin = Select(neg, intervalMin, farMin);
+                            __m128 rightMax = Select(neg, nearMax, intervalMax);
+
+                            uint32 leftMask = uint32(_mm_movemask_ps(_mm_cmple_ps(leftMin, leftMax))) & activeMask;
+                            uint32 rightMask = uint32(_mm_movemask_ps(_mm_cmple_ps(rightMin, rightMax))) & activeMask;
+
+                            // packet passes between clip zones
+                            if (!leftMask && !rightMask)
+                                break;
+
+                            if (!rightMask || (leftMask && !rightFirst[axis]))
+                            {
+                                if (rightMask)
+                                {
+                                    // packet passes through both nodes, push back the right one
+                                    stack[stackPos].node = offset + 3;
+                                    stack[stackPos].mask = rightMask;
+                                    stack[stackPos].tnear = rightMin;
+                                    stack[stackPos].tfar = rightMax;
+                                    stackPos++;
+                                }
+                                node = offset;
+                                activeMask = leftMask;
+                                intervalMin = leftMin;
+                                intervalMax = leftMax;
+                            }
+                            else
+                            {
+                                if (leftMask)
+                                {
+                                    // packet passes through both nodes, push back the left one
+                                    stack[stackPos].node = offset;
+                                    stack[stackPos].mask = leftMask;
+                                    stack[stackPos].tnear = leftMin;
+                                    stack[stackPos].tfar = leftMax;
+                                    stackPos++;
+                                }
+                                node = offset + 3;
+                                activeMask = rightMask;
+                                intervalMin = rightMin;
+                                intervalMax = rightMax;
+                            }
+                            continue;
+                        }
+                        else
+                        {
+                            // leaf - test some objects for every ray still in the packet
+                            int n = tree[node + 1];
+                            while (n > 0)
+                            {
+                                for (uint32 lane = 0; lane < count; ++lane)
+                                {
+                                    if (!(activeMask & (1 << lane)))
+                                        continue;
+
+                                    if (intersectCallback(rays[lane], objects[offset], dist[lane], true))
+                                    {
+                                        hits[lane] = true;
+                                        retiredMask |= 1 << lane;
+                                        activeMask &= ~(1 << lane);
+                                    }
+                                }
+
+                                if (retiredMask == (1u << count) - 1)
+                                    return;
+
+                                if (!activeMask)
+                                    break;
+
+                                --n;
+                                ++offset;
+                            }
+                            break;
+                        }
+                    }
+                    else
+                    {
+                        if (axis > 2)
+                            return; // should not happen
+                        __m128 o = _mm_load_ps(org[axis]);
+                        __m128 inv = _mm_load_ps(invDir[axis]);
+                        __m128 neg = _mm_load_ps(negDir[axis]);
+                        __m128 lo = _mm_set1_ps(intBitsToFloat(tree[node + 1]));
+                        __m128 hi = _mm_set1_ps(intBitsToFloat(tree[node + 2]));
+                        __m128 tf = _mm_mul_ps(_mm_sub_ps(Select(neg, hi, lo), o), inv);
+                        __m128 tb = _mm_mul_ps(_mm_sub_ps(Select(neg, lo, hi), o), inv);
+                        node = offset;
+                        intervalMin = Select(_mm_cmpge_ps(tf, intervalMin), tf, intervalMin);
+                        intervalMax = Select(_mm_cmple_ps(tb, intervalMax), tb, intervalMax);
+                        activeMask &= uint32(_mm_movemask_ps(_mm_cmple_ps(intervalMin, intervalMax)));
+                        if (!activeMask)
+                            break;
+                        continue;
+                    }
+                } // traversal loop
+                do
+                {
+                    // stack is empty?
+                    if (stackPos == 0)
+                        return;
+                    // move back up the stack
+                    stackPos--;
+                    activeMask = stack[stackPos].mask & ~retiredMask;
+                    if (!activeMask)
+                        continue;
+                    node = stack[stackPos].node;
+                    intervalMin = stack[stackPos].tnear;
+                    intervalMax = stack[stackPos].tfar;
+                    break;
+                } while (true);
+            }
+#else
+            for (uint32 i = 0; i < count; ++i)
+            {
+                float distance = maxDist[i];
+                intersectRay(rays[i], intersectCallback, distance, true);
+                hits[i] = distance < maxDist[i];
+            }
+#endif
+        }
+
         template<typename IsectCallback>
         void intersectPoint(const G3D::Vector3 &p, IsectCallback& intersectCallback) const
         {
@@ -351,6 +593,17 @@ class TC_COMMON_API BIH
             float tnear;
             float tfar;
         };
+#if BIH_SSE
+        struct PacketStackNode
+        {
+            uint32 node;
+            uint32 mask;
+            __m128 tnear;
+            __m128 tfar;
+        };
+
+        static __m128 Select(__m128 mask, __m128 a, __m128 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+#endif
 
         class BuildStats
         {
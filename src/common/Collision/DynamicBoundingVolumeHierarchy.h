@@ -0,0 +1,475 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DYNAMIC_BVH_H
+#define _DYNAMIC_BVH_H
+
+#include "Define.h"
+#include "Errors.h"
+#include <G3D/AABox.h>
+#include <G3D/BoundsTrait.h>
+#include <G3D/Ray.h>
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+// bounds of leaves are enlarged by this margin, objects moving inside of them do not touch the tree
+#define DYNAMIC_BVH_FAT_MARGIN 2.0f
+// maximum number of leaves re-inserted by one balance() call
+#define DYNAMIC_BVH_MAX_REINSERTS 32
+
+/**
+    Incrementally updated bounding volume hierarchy for moving objects.
+    Insert and remove are O(log n) and keep the tree balanced with local rotations, so the tree never has to be rebuilt.
+    A moved object that leaves its fat bounds only has its leaf and ancestors refitted, the leaf is re-inserted
+    at a better place later by balance(), which handles at most DYNAMIC_BVH_MAX_REINSERTS leaves per call.
+*/
+template<class T, class BoundsFunc = BoundsTrait<T> >
+class DynamicBVH
+{
+    static constexpr int32 NULL_NODE = -1;
+
+    struct Node
+    {
+        G3D::AABox bounds;
+        T const* object;
+        int32 parent;               // next free node for nodes in the free list
+        int32 children[2];
+        int32 height;               // 0 for leaves, -1 for free nodes
+        bool pendingReinsert;
+        uint8 splitAxis;            // axis along which the centers of the children are furthest apart
+        bool secondIsHigher;        // children[1] has the higher center along splitAxis
+
+        bool isLeaf() const { return children[0] == NULL_NODE; }
+    };
+
+public:
+    DynamicBVH() : m_root(NULL_NODE), m_freeList(NULL_NODE) { }
+
+    void insert(T const& obj)
+    {
+        ASSERT(m_leaves.find(&obj) == m_leaves.end());
+
+        int32 leaf = allocateNode();
+        m_nodes[leaf].bounds = getFatBounds(obj);
+        m_nodes[leaf].object = &obj;
+        m_nodes[leaf].height = 0;
+        m_leaves[&obj] = leaf;
+        insertLeaf(leaf);
+    }
+
+    void remove(T const& obj)
+    {
+        auto itr = m_leaves.find(&obj);
+        if (itr == m_leaves.end())
+            return;
+
+        int32 leaf = itr->second;
+        m_leaves.erase(itr);
+        removeLeaf(leaf);
+        freeNode(leaf);
+    }
+
+    // must be called after the bounds of obj changed
+    void update(T const& obj)
+    {
+        auto itr = m_leaves.find(&obj);
+        if (itr == m_leaves.end())
+            return;
+
+        G3D::AABox bounds;
+        BoundsFunc::getBounds(obj, bounds);
+
+        int32 leaf = itr->second;
+        if (m_nodes[leaf].bounds.contains(bounds))
+            return;
+
+        // refit: grow the leaf and its ancestors so queries stay correct, re-insertion can wait
+        m_nodes[leaf].bounds = getFatBounds(obj);
+        for (int32 index = m_nodes[leaf].parent; index != NULL_NODE; index = m_nodes[index].parent)
+        {
+            if (m_nodes[index].bounds.contains(m_nodes[leaf].bounds))
+                break;
+
+            m_nodes[index].bounds.merge(m_nodes[leaf].bounds);
+        }
+
+        if (!m_nodes[leaf].pendingReinsert)
+        {
+            m_nodes[leaf].pendingReinsert = true;
+            m_pendingReinserts.push_back(&obj);
+        }
+    }
+
+    bool contains(T const& obj) const { return m_leaves.find(&obj) != m_leaves.end(); }
+    bool empty() const { return m_leaves.empty(); }
+    uint32 size() const { return uint32(m_leaves.size()); }
+    int32 getHeight() const { return m_root != NULL_NODE ? m_nodes[m_root].height : 0; }
+    uint32 getPendingReinsertCount() const { return uint32(m_pendingReinserts.size()); }
+
+    // bounded maintenance, re-inserts refitted leaves
+    void balance()
+    {
+        uint32 count = std::min<uint32>(m_pendingReinserts.size(), DYNAMIC_BVH_MAX_REINSERTS);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            T const* obj = m_pendingReinserts[i];
+            auto itr = m_leaves.find(obj);
+            // removed (and maybe inserted again) since it was queued
+            if (itr == m_leaves.end() || !m_nodes[itr->second].pendingReinsert)
+                continue;
+
+            int32 leaf = itr->second;
+            m_nodes[leaf].pendingReinsert = false;
+            removeLeaf(leaf);
+            m_nodes[leaf].bounds = getFatBounds(*obj);
+            insertLeaf(leaf);
+        }
+
+        m_pendingReinserts.erase(m_pendingReinserts.begin(), m_pendingReinserts.begin() + count);
+    }
+
+    // same contract as BIH::intersectRay, the callback shortens maxDist on a hit
+    // without stopAtFirst the children are visited front to back so farther nodes are pruned early
+    template<typename RayCallback>
+    void intersectRay(G3D::Ray const& ray, RayCallback& intersectCallback, float& maxDist, bool stopAtFirst = false) const
+    {
+        if (m_root == NULL_NODE)
+            return;
+
+        int32 stack[64];
+        uint32 stackSize = 0;
+        stack[stackSize++] = m_root;
+        while (stackSize)
+        {
+            Node const& node = m_nodes[stack[--stackSize]];
+            if (!intersectsRay(node.bounds, ray, maxDist))
+                continue;
+
+            if (node.isLeaf())
+            {
+                bool hit = intersectCallback(ray, *node.object, maxDist);
+                if (stopAtFirst && hit)
+                    return;
+                continue;
+            }
+
+            // the nearer child is pushed last so it is popped first, any order will do when any hit is enough
+            int32 nearSlot = stopAtFirst ? 1 : int32((ray.direction()[node.splitAxis] < 0.0f) == node.secondIsHigher);
+
+            ASSERT(stackSize + 2 <= 64);
+            stack[stackSize++] = node.children[1 - nearSlot];
+            stack[stackSize++] = node.children[nearSlot];
+        }
+    }
+
+    template<typename IsectCallback>
+    void intersectPoint(G3D::Vector3 const& point, IsectCallback& intersectCallback) const
+    {
+        if (m_root == NULL_NODE)
+            return;
+
+        int32 stack[64];
+        uint32 stackSize = 0;
+        stack[stackSize++] = m_root;
+        while (stackSize)
+        {
+            Node const& node = m_nodes[stack[--stackSize]];
+            if (!node.bounds.contains(point))
+                continue;
+
+            if (node.isLeaf())
+            {
+                intersectCallback(point, *node.object);
+                continue;
+            }
+
+            ASSERT(stackSize + 2 <= 64);
+            stack[stackSize++] = node.children[0];
+            stack[stackSize++] = node.children[1];
+        }
+    }
+
+private:
+    static G3D::AABox getFatBounds(T const& obj)
+    {
+        G3D::AABox bounds;
+        BoundsFunc::getBounds(obj, bounds);
+        G3D::Vector3 const margin(DYNAMIC_BVH_FAT_MARGIN, DYNAMIC_BVH_FAT_MARGIN, DYNAMIC_BVH_FAT_MARGIN);
+        return G3D::AABox(bounds.low() - margin, bounds.high() + margin);
+    }
+
+    static G3D::AABox merged(G3D::AABox const& a, G3D::AABox const& b)
+    {
+        G3D::AABox result(a);
+        result.merge(b);
+        return result;
+    }
+
+    static float halfArea(G3D::AABox const& box)
+    {
+        G3D::Vector3 extent = box.high() - box.low();
+        return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+    }
+
+    static bool intersectsRay(G3D::AABox const& box, G3D::Ray const& ray, float maxDist)
+    {
+        float tNear = 0.0f;
+        float tFar = maxDist;
+        for (int32 axis = 0; axis < 3; ++axis)
+        {
+            float invDir = ray.invDirection()[axis];
+            float t1 = (box.low()[axis] - ray.origin()[axis]) * invDir;
+            float t2 = (box.high()[axis] - ray.origin()[axis]) * invDir;
+            // NaN from 0 * inf (origin on a slab boundary of an axis parallel ray) must not reject the box,
+            // std::min and std::max return their first argument when comparing with NaN
+            tNear = std::max(tNear, std::min(t1, t2));
+            tFar = std::min(tFar, std::max(t1, t2));
+        }
+
+        return tNear <= tFar;
+    }
+
+    void updateSplit(Node& node) const
+    {
+        G3D::AABox const& first = m_nodes[node.children[0]].bounds;
+        G3D::AABox const& second = m_nodes[node.children[1]].bounds;
+        float maxSeparation = -1.0f;
+        for (int32 axis = 0; axis < 3; ++axis)
+        {
+            float separation = second.low()[axis] + second.high()[axis] - first.low()[axis] - first.high()[axis];
+            if (std::fabs(separation) > maxSeparation)
+            {
+                maxSeparation = std::fabs(separation);
+                node.splitAxis = uint8(axis);
+                node.secondIsHigher = separation > 0.0f;
+            }
+        }
+    }
+
+    int32 allocateNode()
+    {
+        int32 index;
+        if (m_freeList != NULL_NODE)
+        {
+            index = m_freeList;
+            m_freeList = m_nodes[index].parent;
+        }
+        else
+        {
+            index = int32(m_nodes.size());
+            m_nodes.emplace_back();
+        }
+
+        Node& node = m_nodes[index];
+        node.object = nullptr;
+        node.parent = NULL_NODE;
+        node.children[0] = NULL_NODE;
+        node.children[1] = NULL_NODE;
+        node.height = 0;
+        node.pendingReinsert = false;
+        node.splitAxis = 0;
+        node.secondIsHigher = true;
+        return index;
+    }
+
+    void freeNode(int32 index)
+    {
+        m_nodes[index].object = nullptr;
+        m_nodes[index].height = -1;
+        m_nodes[index].pendingReinsert = false;
+        m_nodes[index].parent = m_freeList;
+        m_freeList = index;
+    }
+
+    void insertLeaf(int32 leaf)
+    {
+        if (m_root == NULL_NODE)
+        {
+            m_root = leaf;
+            m_nodes[leaf].parent = NULL_NODE;
+            return;
+        }
+
+        // find the best sibling by descending towards the child with the lowest surface area increase
+        G3D::AABox const leafBounds = m_nodes[leaf].bounds;
+        int32 index = m_root;
+        while (!m_nodes[index].isLeaf())
+        {
+            Node const& node = m_nodes[index];
+            float area = halfArea(node.bounds);
+            float combinedArea = halfArea(merged(node.bounds, leafBounds));
+
+            // cost of creating a new parent for this node and the leaf
+            float cost = 2.0f * combinedArea;
+            // minimum cost of pushing the leaf further down the tree
+            float inheritanceCost = 2.0f * (combinedArea - area);
+
+            float childCost[2];
+            for (int32 i = 0; i < 2; ++i)
+            {
+                Node const& child = m_nodes[node.children[i]];
+                float enlarged = halfArea(merged(child.bounds, leafBounds));
+                childCost[i] = (child.isLeaf() ? enlarged : enlarged - halfArea(child.bounds)) + inheritanceCost;
+            }
+
+            if (cost < childCost[0] && cost < childCost[1])
+                break;
+
+            index = childCost[0] < childCost[1] ? node.children[0] : node.children[1];
+        }
+
+        int32 sibling = index;
+        int32 oldParent = m_nodes[sibling].parent;
+        int32 newParent = allocateNode();
+        m_nodes[newParent].parent = oldParent;
+        m_nodes[newParent].bounds = merged(leafBounds, m_nodes[sibling].bounds);
+        m_nodes[newParent].height = m_nodes[sibling].height + 1;
+        m_nodes[newParent].children[0] = sibling;
+        m_nodes[newParent].children[1] = leaf;
+        m_nodes[sibling].parent = newParent;
+        m_nodes[leaf].parent = newParent;
+
+        if (oldParent != NULL_NODE)
+        {
+            if (m_nodes[oldParent].children[0] == sibling)
+                m_nodes[oldParent].children[0] = newParent;
+            else
+                m_nodes[oldParent].children[1] = newParent;
+        }
+        else
+            m_root = newParent;
+
+        refitAncestors(newParent);
+    }
+
+    void removeLeaf(int32 leaf)
+    {
+        if (leaf == m_root)
+        {
+            m_root = NULL_NODE;
+            return;
+        }
+
+        int32 parent = m_nodes[leaf].parent;
+        int32 grandParent = m_nodes[parent].parent;
+        int32 sibling = m_nodes[parent].children[0] == leaf ? m_nodes[parent].children[1] : m_nodes[parent].children[0];
+
+        if (grandParent != NULL_NODE)
+        {
+            if (m_nodes[grandParent].children[0] == parent)
+                m_nodes[grandParent].children[0] = sibling;
+            else
+                m_nodes[grandParent].children[1] = sibling;
+
+            m_nodes[sibling].parent = grandParent;
+            freeNode(parent);
+            refitAncestors(grandParent);
+        }
+        else
+        {
+            m_root = sibling;
+            m_nodes[sibling].parent = NULL_NODE;
+            freeNode(parent);
+        }
+    }
+
+    // walks up from index, restoring bounds and heights and rotating unbalanced nodes
+    void refitAncestors(int32 index)
+    {
+        while (index != NULL_NODE)
+        {
+            index = rotate(index);
+
+            Node& node = m_nodes[index];
+            Node const& left = m_nodes[node.children[0]];
+            Node const& right = m_nodes[node.children[1]];
+            node.height = 1 + std::max(left.height, right.height);
+            node.bounds = merged(left.bounds, right.bounds);
+            updateSplit(node);
+
+            index = node.parent;
+        }
+    }
+
+    // AVL style rotation, promotes the higher grandchild if the children heights differ by more than one
+    // returns the index of the node that took the place of a
+    int32 rotate(int32 a)
+    {
+        Node& nodeA = m_nodes[a];
+        if (nodeA.isLeaf() || nodeA.height < 2)
+            return a;
+
+        int32 b = nodeA.children[0];
+        int32 c = nodeA.children[1];
+        int32 balance = m_nodes[c].height - m_nodes[b].height;
+
+        if (balance > 1)
+            return promote(a, c, b, 1);
+        if (balance < -1)
+            return promote(a, b, c, 0);
+
+        return a;
+    }
+
+    // raises child (in slot childSlot of a) above a, a keeps other and the lower grandchild
+    int32 promote(int32 a, int32 child, int32 other, int32 childSlot)
+    {
+        Node& nodeA = m_nodes[a];
+        Node& nodeC = m_nodes[child];
+        int32 f = nodeC.children[0];
+        int32 g = nodeC.children[1];
+
+        nodeC.children[0] = a;
+        nodeC.parent = nodeA.parent;
+        nodeA.parent = child;
+
+        if (nodeC.parent != NULL_NODE)
+        {
+            if (m_nodes[nodeC.parent].children[0] == a)
+                m_nodes[nodeC.parent].children[0] = child;
+            else
+                m_nodes[nodeC.parent].children[1] = child;
+        }
+        else
+            m_root = child;
+
+        // keep the higher grandchild under child, give the lower one to a
+        int32 high = m_nodes[f].height > m_nodes[g].height ? f : g;
+        int32 low = high == f ? g : f;
+
+        nodeC.children[1] = high;
+        nodeA.children[childSlot] = low;
+        m_nodes[low].parent = a;
+
+        nodeA.bounds = merged(m_nodes[other].bounds, m_nodes[low].bounds);
+        nodeA.height = 1 + std::max(m_nodes[other].height, m_nodes[low].height);
+        updateSplit(nodeA);
+        nodeC.bounds = merged(nodeA.bounds, m_nodes[high].bounds);
+        nodeC.height = 1 + std::max(nodeA.height, m_nodes[high].height);
+        return child;
+    }
+
+    std::vector<Node> m_nodes;
+    int32 m_root;
+    int32 m_freeList;
+    std::unordered_map<T const*, int32> m_leaves;
+    std::vector<T const*> m_pendingReinserts;
+};
+
+#endif // _DYNAMIC_BVH_H
@@ -16,7 +16,7 @@
  */
 
 #include "DynamicTree.h"
-#include "BoundingIntervalHierarchyWrapper.h"
+#include "DynamicBoundingVolumeHierarchy.h"
 #include "GameObjectModel.h"
 #include "Log.h"
 #include "MapTree.h"
@@ -30,15 +30,10 @@
 #include <G3D/AABox.h>
 #include <G3D/Ray.h>
 #include <G3D/Vector3.h>
+#include <vector>
 
 using VMAP::ModelInstance;
 
-namespace {
-
-int CHECK_TREE_PERIOD = 200;
-
-} // namespace
-
 template<> struct HashTrait< GameObjectModel>{
     static size_t hashCode(GameObjectModel const& g) { return (size_t)(void*)&g; }
 };
@@ -58,53 +53,84 @@ static bool operator==(GameObjectModel const& mdl, GameObjectModel const& mdl2){
 }
 */
 
-typedef RegularGrid2D<GameObjectModel, BIHWrap<GameObjectModel> > ParentTree;
+typedef RegularGrid2D<GameObjectModel, DynamicBVH<GameObjectModel> > ParentTree;
 
 struct DynTreeImpl : public ParentTree/*, public Intersectable*/
 {
     typedef GameObjectModel Model;
     typedef ParentTree base;
 
-    DynTreeImpl() :
-        rebalance_timer(CHECK_TREE_PERIOD),
-        unbalanced_times(0)
-    {
-    }
+    typedef DynamicBVH<GameObjectModel> Node;
 
-    void insert(Model const& mdl)
+    // models that stay within the same grid cells are updated in place, refitting their leaves
+    void relocate(Model const& mdl)
     {
+        G3D::AABox bounds;
+        BoundsTrait<Model>::getBounds(mdl, bounds);
+        Cell low = Cell::ComputeCell(bounds.low().x, bounds.low().y);
+        Cell high = Cell::ComputeCell(bounds.high().x, bounds.high().y);
+
+        if (low.isValid() && high.isValid() && isInCells(mdl, low, high))
+        {
+            for (auto& p : Trinity::Containers::MapEqualRange(memberTable, &mdl))
+            {
+                Node* node = p.second;
+                bool wasPending = node->getPendingReinsertCount() != 0;
+                node->update(mdl);
+                if (!wasPending && node->getPendingReinsertCount())
+                    pendingNodes.push_back(node);
+            }
+            return;
+        }
+
+        base::remove(mdl);
         base::insert(mdl);
-        ++unbalanced_times;
     }
 
-    void remove(Model const& mdl)
+    bool isInCells(Model const& mdl, Cell const& low, Cell const& high) const
     {
-        base::remove(mdl);
-        ++unbalanced_times;
+        std::size_t cellCount = 0;
+        for (auto& p : Trinity::Containers::MapEqualRange(memberTable, &mdl))
+        {
+            Node const* node = p.second;
+            bool found = false;
+            for (int x = low.x; x <= high.x && !found; ++x)
+                for (int y = low.y; y <= high.y && !found; ++y)
+                    found = nodes[x][y] == node;
+
+            if (!found)
+                return false;
+
+            ++cellCount;
+        }
+
+        return cellCount == std::size_t(high.x - low.x + 1) * std::size_t(high.y - low.y + 1);
     }
 
+    // re-inserts a bounded number of moved leaves, only in the cells that have any queued
     void balance()
     {
-        base::balance();
-        unbalanced_times = 0;
+        for (std::size_t i = 0; i < pendingNodes.size();)
+        {
+            pendingNodes[i]->balance();
+            if (pendingNodes[i]->getPendingReinsertCount())
+                ++i;
+            else
+            {
+                pendingNodes[i] = pendingNodes.back();
+                pendingNodes.pop_back();
+            }
+        }
     }
 
-    void update(uint32 difftime)
+    void update(uint32 /*difftime*/)
     {
-        if (empty())
-            return;
-
-        rebalance_timer.Update(difftime);
-        if (rebalance_timer.Passed())
-        {
-            rebalance_timer.Reset(CHECK_TREE_PERIOD);
-            if (unbalanced_times > 0)
-                balance();
-        }
+        // the tree itself never needs a rebuild
+        balance();
     }
 
-    TimeTracker rebalance_timer;
-    int unbalanced_times;
+    // cells with leaves queued for re-insertion, nodes are only deleted with the grid
+    std::vector<Node*> pendingNodes;
 };
 
 DynamicMapTree::DynamicMapTree() : impl(new DynTreeImpl()) { }
@@ -124,6 +150,11 @@ void DynamicMapTree::remove(GameObjectModel const& mdl)
     impl->remove(mdl);
 }
 
+void DynamicMapTree::relocate(GameObjectModel const& mdl)
+{
+    impl->relocate(mdl);
+}
+
 bool DynamicMapTree::contains(GameObjectModel const& mdl) const
 {
     return impl->contains(mdl);
@@ -139,15 +170,19 @@ void DynamicMapTree::update(uint32 t_diff)
     impl->update(t_diff);
 }
 
+// every hit shortens the distance, the tree keeps searching for a nearer one unless any hit is enough
 struct DynamicTreeIntersectionCallback
 {
     bool did_hit;
     uint32 phase_mask;
-    DynamicTreeIntersectionCallback(uint32 phasemask) : did_hit(false), phase_mask(phasemask) { }
+    bool stop_at_first_hit;
+    DynamicTreeIntersectionCallback(uint32 phasemask, bool stopAtFirstHit) : did_hit(false), phase_mask(phasemask), stop_at_first_hit(stopAtFirstHit) { }
     bool operator()(G3D::Ray const& r, GameObjectModel const& obj, float& distance)
     {
-        did_hit = obj.intersectRay(r, distance, true, phase_mask, VMAP::ModelIgnoreFlags::Nothing);
-        return did_hit;
+        bool hit = obj.intersectRay(r, distance, stop_at_first_hit, phase_mask, VMAP::ModelIgnoreFlags::Nothing);
+        if (hit)
+            did_hit = true;
+        return hit;
     }
     bool didHit() const { return did_hit;}
 };
@@ -213,8 +248,8 @@ bool DynamicMapTree::getIntersectionTime(const uint32 phasemask, const G3D::Ray&
                                          const G3D::Vector3& endPos, float& maxDist) const
 {
     float distance = maxDist;
-    DynamicTreeIntersectionCallback callback(phasemask);
-    impl->intersectRay(ray, callback, distance, endPos);
+    DynamicTreeIntersectionCallback callback(phasemask, false);
+    impl->intersectRay(ray, callback, distance, endPos, false);
     if (callback.didHit())
         maxDist = distance;
     return callback.didHit();
@@ -270,8 +305,8 @@ bool DynamicMapTree::isInLineOfSight(float x1, float y1, float z1, float x2, flo
         return true;
 
     G3D::Ray r(v1, (v2-v1) / maxDist);
-    DynamicTreeIntersectionCallback callback(phasemask);
-    impl->intersectRay(r, callback, maxDist, v2);
+    DynamicTreeIntersectionCallback callback(phasemask, true);
+    impl->intersectRay(r, callback, maxDist, v2, true);
 
     return !callback.did_hit;
 }
@@ -280,8 +315,8 @@ float DynamicMapTree::getHeight(float x, float y, float z, float maxSearchDist,
 {
     G3D::Vector3 v(x, y, z);
     G3D::Ray r(v, G3D::Vector3(0, 0, -1));
-    DynamicTreeIntersectionCallback callback(phasemask);
-    impl->intersectZAllignedRay(r, callback, maxSearchDist);
+    DynamicTreeIntersectionCallback callback(phasemask, false);
+    impl->intersectZAllignedRay(r, callback, maxSearchDist, false);
 
     if (callback.didHit())
         return v.z - maxSearchDist;
@@ -59,6 +59,8 @@ public:
 
     void insert(GameObjectModel const&);
     void remove(GameObjectModel const&);
+    // must be called after the position of an inserted model changed
+    void relocate(GameObjectModel const&);
     bool contains(GameObjectModel const&) const;
 
     void balance();
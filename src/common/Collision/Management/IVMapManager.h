@@ -49,6 +49,9 @@ namespace VMAP
     #define VMAP_INVALID_HEIGHT       -100000.0f            // for check
     #define VMAP_INVALID_HEIGHT_VALUE -200000.0f            // real assigned value in unknown height case
 
+    // batched line of sight keeps this many rays on the stack, enough for an area spell hitting a full raid
+    static constexpr uint32 LOS_BATCH_INLINE_SIZE = 40;
+
     struct AreaAndLiquidData
     {
         struct AreaInfo
@@ -90,6 +93,11 @@ namespace VMAP
             virtual void unloadMap(unsigned int pMapId) = 0;
 
             virtual bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2, ModelIgnoreFlags ignoreFlags) = 0;
+            /**
+            line of sight for many rays at once, segments holds count x1, y1, z1, x2, y2, z2 sextuplets
+            results[i] is set to true if the end of segment i is in line of sight of its start
+            */
+            virtual void isInLineOfSight(unsigned int pMapId, float const* segments, bool* results, uint32 count, ModelIgnoreFlags ignoreFlags) = 0;
             virtual float getHeight(unsigned int pMapId, float x, float y, float z, float maxSearchDist) = 0;
             /**
             test if we hit an object. return true if we hit one. rx, ry, rz will hold the hit position or the dest position, if no intersection was found
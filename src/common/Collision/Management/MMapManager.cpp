@@ -185,6 +185,7 @@ namespace MMAP
         if (dtStatusSucceed(mmap->navMesh->addTile(data, fileHeader.size, DT_TILE_FREE_DATA, 0, &tileRef)))
         {
             mmap->loadedTileRefs.insert(std::pair<uint32, dtTileRef>(packedGridPos, tileRef));
+            mmap->tileGraph.AddTile(mmap->navMesh->getTileByRef(tileRef));
             ++loadedTiles;
             TC_LOG_DEBUG("maps", "MMAP:loadMap: Loaded mmtile %03i[%02i, %02i] into %03i[%02i, %02i]", mapId, x, y, mapId, header->x, header->y);
             return true;
@@ -220,6 +221,8 @@ namespace MMAP
         }
 
         dtTileRef tileRef = mmap->loadedTileRefs[packedGridPos];
+        if (dtMeshTile const* tile = mmap->navMesh->getTileByRef(tileRef))
+            mmap->tileGraph.RemoveTile(tile->header->x, tile->header->y);
 
         // unload, and mark as non loaded
         if (dtStatusFailed(mmap->navMesh->removeTile(tileRef, nullptr, nullptr)))
@@ -309,6 +312,15 @@ namespace MMAP
         return itr->second->navMesh;
     }
 
+    MMapTileGraph const* MMapManager::GetTileGraph(uint32 mapId)
+    {
+        MMapDataSet::const_iterator itr = GetMMapData(mapId);
+        if (itr == loadedMMaps.end())
+            return nullptr;
+
+        return &itr->second->tileGraph;
+    }
+
     dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId, uint32 instanceId)
     {
         MMapDataSet::const_iterator itr = GetMMapData(mapId);
@@ -21,6 +21,7 @@
 #include "Define.h"
 #include "DetourNavMesh.h"
 #include "DetourNavMeshQuery.h"
+#include "MMapTileGraph.h"
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -49,6 +50,7 @@ namespace MMAP
 
         dtNavMesh* navMesh;
         MMapTileSet loadedTileRefs;        // maps [map grid coords] to [dtTile]
+        MMapTileGraph tileGraph;           // tile level graph of loaded tiles, used for long distance paths
     };
 
     typedef std::unordered_map<uint32, MMapData*> MMapDataSet;
@@ -70,6 +72,7 @@ namespace MMAP
             // the returned [dtNavMeshQuery const*] is NOT threadsafe
             dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId, uint32 instanceId);
             dtNavMesh const* GetNavMesh(uint32 mapId);
+            MMapTileGraph const* GetTileGraph(uint32 mapId);
 
             uint32 getLoadedTilesCount() const { return loadedTiles; }
             uint32 getLoadedMapsCount() const { return uint32(loadedMMaps.size()); }
@@ -0,0 +1,323 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MMapTileGraph.h"
+#include "DetourCommon.h"
+#include "DetourNavMesh.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <queue>
+
+namespace MMAP
+{
+    namespace
+    {
+        // tile offsets for every side, see dtNavMesh::getNeighbourTilesAt
+        int32 const SideOffsetX[MMAP_TILE_SIDES] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+        int32 const SideOffsetY[MMAP_TILE_SIDES] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+
+        // chebyshev distance in tiles, exact for a graph with unit cost steps in 8 directions
+        uint32 Heuristic(int32 x1, int32 y1, int32 x2, int32 y2)
+        {
+            return uint32(std::max(std::abs(x1 - x2), std::abs(y1 - y2)));
+        }
+
+        // border edges closer than this along the border belong to the same portal
+        float const PortalRunGap = 0.1f;
+        // and their heights must not differ more than this, edges above each other are separate portals
+        float const PortalRunClimb = 2.0f;
+        // portal points are moved this far from the border edge towards the polygon center
+        float const PortalInset = 0.1f;
+
+        struct BorderEdge
+        {
+            float min;          // position along the border
+            float max;
+            float va[3];
+            float vb[3];
+            float polyCenter[3];
+        };
+
+        struct PortalRun
+        {
+            float min;
+            float max;
+            float endHeight;
+            std::vector<BorderEdge const*> edges;
+        };
+
+        // detour axis that runs along the tile border of a side, x for the diagonal corners
+        uint8 GetBorderAxis(uint8 side)
+        {
+            return (side == 0 || side == 4) ? 2 : 0;
+        }
+    }
+
+    void MMapTileGraph::AddTile(dtMeshTile const* tile)
+    {
+        if (!tile || !tile->header)
+            return;
+
+        std::vector<BorderEdge> edges[MMAP_TILE_SIDES];
+        for (int32 i = 0; i < tile->header->polyCount; ++i)
+        {
+            dtPoly const& poly = tile->polys[i];
+            if (poly.getType() == DT_POLYTYPE_OFFMESH_CONNECTION)
+                continue;
+
+            float polyCenter[3] = { };
+            for (uint8 j = 0; j < poly.vertCount; ++j)
+                dtVadd(polyCenter, polyCenter, &tile->verts[poly.verts[j] * 3]);
+            dtVscale(polyCenter, polyCenter, 1.0f / float(poly.vertCount));
+
+            for (uint8 j = 0; j < poly.vertCount; ++j)
+            {
+                if (!(poly.neis[j] & DT_EXT_LINK))
+                    continue;
+
+                uint8 side = uint8(poly.neis[j] & (MMAP_TILE_SIDES - 1));
+                uint8 axis = GetBorderAxis(side);
+
+                BorderEdge edge;
+                dtVcopy(edge.va, &tile->verts[poly.verts[j] * 3]);
+                dtVcopy(edge.vb, &tile->verts[poly.verts[(j + 1) % poly.vertCount] * 3]);
+                if (edge.va[axis] > edge.vb[axis])
+                    std::swap(edge.va, edge.vb);
+
+                edge.min = edge.va[axis];
+                edge.max = edge.vb[axis];
+                dtVcopy(edge.polyCenter, polyCenter);
+                edges[side].push_back(edge);
+            }
+        }
+
+        Node node;
+        node.portalSides = 0;
+        for (uint8 side = 0; side < MMAP_TILE_SIDES; ++side)
+        {
+            if (edges[side].empty())
+                continue;
+
+            std::sort(edges[side].begin(), edges[side].end(), [](BorderEdge const& left, BorderEdge const& right) { return left.min < right.min; });
+
+            // split the border into connected runs, every run is one portal
+            std::vector<PortalRun> runs;
+            for (BorderEdge const& edge : edges[side])
+            {
+                auto run = std::find_if(runs.begin(), runs.end(), [&edge](PortalRun const& run)
+                {
+                    return edge.min <= run.max + PortalRunGap && std::abs(edge.va[1] - run.endHeight) <= PortalRunClimb;
+                });
+
+                if (run == runs.end())
+                {
+                    runs.push_back(PortalRun{ edge.min, edge.max, edge.vb[1], { } });
+                    run = std::prev(runs.end());
+                }
+                else if (edge.max > run->max)
+                {
+                    run->max = edge.max;
+                    run->endHeight = edge.vb[1];
+                }
+
+                run->edges.push_back(&edge);
+            }
+
+            for (PortalRun const& run : runs)
+            {
+                // the middle of a run is not always on an edge of it, use the closest edge then
+                float middle = (run.min + run.max) * 0.5f;
+                BorderEdge const* portalEdge = run.edges.front();
+                float portalEdgeDist = std::numeric_limits<float>::max();
+                for (BorderEdge const* edge : run.edges)
+                {
+                    float dist = middle < edge->min ? edge->min - middle : (middle > edge->max ? middle - edge->max : 0.0f);
+                    if (dist < portalEdgeDist)
+                    {
+                        portalEdge = edge;
+                        portalEdgeDist = dist;
+                    }
+                }
+
+                float length = portalEdge->max - portalEdge->min;
+                float t = length > 0.0f ? std::clamp((middle - portalEdge->min) / length, 0.0f, 1.0f) : 0.5f;
+
+                Portal portal;
+                dtVlerp(portal.pos, portalEdge->va, portalEdge->vb, t);
+
+                // polygons are convex, so moving towards the center keeps the point on the polygon and off the border
+                float toCenter = dtVdist2D(portal.pos, portalEdge->polyCenter);
+                if (toCenter > 0.0f)
+                    dtVlerp(portal.pos, portal.pos, portalEdge->polyCenter, std::min(PortalInset / toCenter, 0.5f));
+
+                node.portals[side].push_back(portal);
+            }
+
+            node.portalSides |= 1 << side;
+        }
+
+        std::unique_lock<std::shared_mutex> lock(_lock);
+        _nodes[PackTileID(tile->header->x, tile->header->y)] = node;
+    }
+
+    void MMapTileGraph::RemoveTile(int32 tileX, int32 tileY)
+    {
+        std::unique_lock<std::shared_mutex> lock(_lock);
+        _nodes.erase(PackTileID(tileX, tileY));
+    }
+
+    bool MMapTileGraph::FindRoute(int32 startTileX, int32 startTileY, float const* startPos, int32 endTileX, int32 endTileY, float const* endPos,
+        std::vector<MMapTileRouteStep>& route, uint32 maxVisitedNodes) const
+    {
+        route.clear();
+
+        struct SearchNode
+        {
+            uint32 parent;
+            uint32 cost;
+            uint8 entrySide;    // side of the parent tile this node was entered through
+            bool closed;
+        };
+
+        typedef std::pair<uint32 /*cost + heuristic*/, uint32 /*packed tile id*/> OpenEntry;
+
+        std::shared_lock<std::shared_mutex> lock(_lock);
+
+        uint32 const startId = PackTileID(startTileX, startTileY);
+        uint32 const endId = PackTileID(endTileX, endTileY);
+        if (_nodes.find(startId) == _nodes.end() || _nodes.find(endId) == _nodes.end())
+            return false;
+
+        std::unordered_map<uint32, SearchNode> visited;
+        std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry>> open;
+
+        visited[startId] = { startId, 0, 0, false };
+        open.emplace(Heuristic(startTileX, startTileY, endTileX, endTileY), startId);
+
+        bool found = false;
+        while (!open.empty())
+        {
+            uint32 const currentId = open.top().second;
+            open.pop();
+
+            SearchNode& current = visited[currentId];
+            if (current.closed)
+                continue;
+
+            current.closed = true;
+            if (currentId == endId)
+            {
+                found = true;
+                break;
+            }
+
+            if (visited.size() >= maxVisitedNodes)
+                break;
+
+            int32 const x = int16(currentId >> 16);
+            int32 const y = int16(currentId & 0xFFFF);
+            uint8 const portalSides = _nodes.at(currentId).portalSides;
+            uint32 const cost = current.cost + 1;
+
+            for (uint8 side = 0; side < MMAP_TILE_SIDES; ++side)
+            {
+                if (!(portalSides & (1 << side)))
+                    continue;
+
+                int32 const nx = x + SideOffsetX[side];
+                int32 const ny = y + SideOffsetY[side];
+                uint32 const neighbourId = PackTileID(nx, ny);
+
+                auto neighbour = _nodes.find(neighbourId);
+                if (neighbour == _nodes.end() || !(neighbour->second.portalSides & (1 << dtOppositeTile(side))))
+                    continue;
+
+                auto itr = visited.find(neighbourId);
+                if (itr != visited.end() && (itr->second.closed || itr->second.cost <= cost))
+                    continue;
+
+                visited[neighbourId] = { currentId, cost, side, false };
+                open.emplace(cost + Heuristic(nx, ny, endTileX, endTileY), neighbourId);
+            }
+        }
+
+        if (!found)
+            return false;
+
+        std::vector<uint32> tiles;
+        for (uint32 id = endId; ; id = visited[id].parent)
+        {
+            tiles.push_back(id);
+            if (id == startId)
+                break;
+        }
+
+        std::reverse(tiles.begin(), tiles.end());
+
+        float previousPos[3];
+        dtVcopy(previousPos, startPos);
+        for (uint32 id : tiles)
+        {
+            MMapTileRouteStep step;
+            step.tileX = int16(id >> 16);
+            step.tileY = int16(id & 0xFFFF);
+            memset(step.portal, 0, sizeof(step.portal));
+            if (id != startId)
+            {
+                // shortest detour over the portals of the crossed border
+                SearchNode const& searchNode = visited[id];
+                float bestCost = std::numeric_limits<float>::max();
+                for (Portal const& portal : _nodes.at(searchNode.parent).portals[searchNode.entrySide])
+                {
+                    float cost = dtVdist2D(previousPos, portal.pos) + dtVdist2D(portal.pos, endPos);
+                    if (cost < bestCost)
+                    {
+                        bestCost = cost;
+                        dtVcopy(step.portal, portal.pos);
+                    }
+                }
+            }
+
+            if (id != startId)
+                dtVcopy(previousPos, step.portal);
+
+            route.push_back(step);
+        }
+
+        return true;
+    }
+
+    uint32 MMapTileGraph::GetPortalCount(int32 tileX, int32 tileY, uint8 side) const
+    {
+        std::shared_lock<std::shared_mutex> lock(_lock);
+        auto itr = _nodes.find(PackTileID(tileX, tileY));
+        if (itr == _nodes.end() || side >= MMAP_TILE_SIDES)
+            return 0;
+
+        return uint32(itr->second.portals[side].size());
+    }
+
+    uint32 MMapTileGraph::GetNodeCount() const
+    {
+        std::shared_lock<std::shared_mutex> lock(_lock);
+        return uint32(_nodes.size());
+    }
+}
@@ -0,0 +1,79 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _MMAP_TILE_GRAPH_H
+#define _MMAP_TILE_GRAPH_H
+
+#include "Define.h"
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+struct dtMeshTile;
+
+namespace MMAP
+{
+    // detour tile sides, see dtNavMesh::getNeighbourTilesAt
+    static constexpr uint8 MMAP_TILE_SIDES = 8;
+
+    // one step of a coarse route over the tile graph
+    struct TC_COMMON_API MMapTileRouteStep
+    {
+        int32 tileX;
+        int32 tileY;
+        float portal[3];    // detour (y-up) position on a polygon where the route enters this tile, undefined for the first step
+    };
+
+    // abstract graph of the loaded navmesh tiles
+    // every tile is a node, two tiles are connected when both have portal polygon edges on the shared border
+    // portal edges are encoded in the tile data by the generator, so the graph does not depend on neighbour tiles being loaded
+    class TC_COMMON_API MMapTileGraph
+    {
+        public:
+            void AddTile(dtMeshTile const* tile);
+            void RemoveTile(int32 tileX, int32 tileY);
+
+            // A* over the tile graph, route contains start and end tile
+            // of the portals on every crossed border the one closest to the straight line from startPos to endPos is used
+            // returns false if the end tile cannot be reached within maxVisitedNodes
+            bool FindRoute(int32 startTileX, int32 startTileY, float const* startPos, int32 endTileX, int32 endTileY, float const* endPos,
+                std::vector<MMapTileRouteStep>& route, uint32 maxVisitedNodes = 4096) const;
+
+            uint32 GetNodeCount() const;
+            // number of separate portals on one side of a tile, 0 if the tile is not loaded
+            uint32 GetPortalCount(int32 tileX, int32 tileY, uint8 side) const;
+
+            static uint32 PackTileID(int32 tileX, int32 tileY) { return uint32(tileX) << 16 | (uint32(tileY) & 0xFFFF); }
+
+        private:
+            struct Portal
+            {
+                float pos[3];
+            };
+
+            struct Node
+            {
+                uint8 portalSides;                                  // bitmask of sides with at least one portal
+                std::vector<Portal> portals[MMAP_TILE_SIDES];       // one portal per connected run of border edges
+            };
+
+            std::unordered_map<uint32, Node> _nodes;
+            mutable std::shared_mutex _lock;
+    };
+}
+
+#endif
@@ -15,6 +15,7 @@
  * with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 #include <string>
@@ -27,6 +28,7 @@
 #include "Log.h"
 #include "VMapDefinitions.h"
 #include "Errors.h"
+#include <boost/container/small_vector.hpp>
 
 using G3D::Vector3;
 
@@ -45,10 +47,6 @@ namespace VMAP
         {
             delete iInstanceMapTree.second;
         }
-        for (std::pair<std::string const, ManagedModel>& iLoadedModelFile : iLoadedModelFiles)
-        {
-            delete iLoadedModelFile.second.getModel();
-        }
     }
 
     void VMapManager2::InitializeThreadUnsafe(const std::vector<uint32>& mapIds)
@@ -180,6 +178,32 @@ namespace VMAP
         return true;
     }
 
+    void VMapManager2::isInLineOfSight(unsigned int mapId, float const* segments, bool* results, uint32 count, ModelIgnoreFlags ignoreFlags)
+    {
+        InstanceTreeMap::const_iterator instanceTree = iInstanceMapTrees.end();
+        if (isLineOfSightCalcEnabled() && !IsVMAPDisabledForPtr(mapId, VMAP_DISABLE_LOS))
+            instanceTree = GetMapTree(mapId);
+
+        if (instanceTree == iInstanceMapTrees.end())
+        {
+            std::fill(results, results + count, true);
+            return;
+        }
+
+        boost::container::small_vector<Vector3, LOS_BATCH_INLINE_SIZE> pos1;
+        boost::container::small_vector<Vector3, LOS_BATCH_INLINE_SIZE> pos2;
+        pos1.reserve(count);
+        pos2.reserve(count);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            float const* segment = segments + i * 6;
+            pos1.push_back(convertPositionToInternalRep(segment[0], segment[1], segment[2]));
+            pos2.push_back(convertPositionToInternalRep(segment[3], segment[4], segment[5]));
+        }
+
+        instanceTree->second->isInLineOfSight(pos1.data(), pos2.data(), results, count, ignoreFlags);
+    }
+
     /**
     get the hit position and return true if we hit something
     otherwise the result pos will be the dest pos
@@ -312,49 +336,125 @@ namespace VMAP
         }
     }
 
-    WorldModel* VMapManager2::acquireModelInstance(const std::string& basepath, const std::string& filename, uint32 flags/* Only used when creating the model */)
+    bool ManagedModel::tryIncRefCount()
     {
-        //! Critical section, thread safe access to iLoadedModelFiles
-        std::lock_guard<std::mutex> lock(LoadedModelFilesLock);
+        int refCount = iRefCount.load();
+        do
+        {
+            if (refCount <= 0)
+                return false;
+        } while (!iRefCount.compare_exchange_weak(refCount, refCount + 1));
+
+        return true;
+    }
+
+    ModelFileRegistry::~ModelFileRegistry()
+    {
+        for (Shard& shard : iShards)
+            for (std::pair<std::string const, std::unique_ptr<ManagedModel>>& model : shard.models)
+                delete model.second->getModel();
+    }
+
+    WorldModel* ModelFileRegistry::acquire(std::string const& basepath, std::string const& filename, uint32 flags)
+    {
+        Shard& shard = getShard(filename);
+        ManagedModel* model = nullptr;
+        std::promise<WorldModel*> loadPromise;
+        bool mustLoad = false;
 
-        ModelFileMap::iterator model = iLoadedModelFiles.find(filename);
-        if (model == iLoadedModelFiles.end())
         {
-            WorldModel* worldmodel = new WorldModel();
-            if (!worldmodel->readFile(basepath + filename + ".vmo"))
+            std::shared_lock<std::shared_mutex> lock(shard.lock);
+            auto itr = shard.models.find(filename);
+            if (itr != shard.models.end() && itr->second->tryIncRefCount())
+                model = itr->second.get();
+        }
+
+        if (!model)
+        {
+            std::unique_lock<std::shared_mutex> lock(shard.lock);
+            std::unique_ptr<ManagedModel>& entry = shard.models[filename];
+            if (entry)
             {
-                VMAP_ERROR_LOG("misc", "VMapManager2: could not load '%s%s.vmo'", basepath.c_str(), filename.c_str());
-                delete worldmodel;
-                return nullptr;
+                // either loaded by another thread in the meantime or released but not yet erased - in that case revive it
+                entry->incRefCount();
+            }
+            else
+            {
+                entry = std::make_unique<ManagedModel>();
+                entry->setModel(loadPromise.get_future().share());
+                mustLoad = true;
             }
-            VMAP_DEBUG_LOG("maps", "VMapManager2: loading file '%s%s'", basepath.c_str(), filename.c_str());
-
-            worldmodel->Flags = flags;
 
-            model = iLoadedModelFiles.insert(std::pair<std::string, ManagedModel>(filename, ManagedModel())).first;
-            model->second.setModel(worldmodel);
+            model = entry.get();
         }
-        model->second.incRefCount();
-        return model->second.getModel();
+
+        // read the file without holding the shard lock, other threads requesting it wait in getModel
+        if (mustLoad)
+            loadPromise.set_value(loadModel(basepath, filename, flags));
+
+        if (WorldModel* worldModel = model->getModel())
+            return worldModel;
+
+        // loading failed, drop our reference so the next request retries
+        release(filename);
+        return nullptr;
     }
 
-    void VMapManager2::releaseModelInstance(const std::string &filename)
+    bool ModelFileRegistry::release(std::string const& filename)
     {
-        //! Critical section, thread safe access to iLoadedModelFiles
-        std::lock_guard<std::mutex> lock(LoadedModelFilesLock);
+        Shard& shard = getShard(filename);
+        ManagedModel* model = nullptr;
 
-        ModelFileMap::iterator model = iLoadedModelFiles.find(filename);
-        if (model == iLoadedModelFiles.end())
         {
-            VMAP_ERROR_LOG("misc", "VMapManager2: trying to unload non-loaded file '%s'", filename.c_str());
-            return;
+            std::shared_lock<std::shared_mutex> lock(shard.lock);
+            auto itr = shard.models.find(filename);
+            if (itr == shard.models.end())
+                return false;
+
+            model = itr->second.get();
         }
-        if (model->second.decRefCount() == 0)
+
+        // the entry is only erased after its reference count reached zero, our reference keeps it alive
+        if (model->decRefCount() != 0)
+            return true;
+
+        std::unique_lock<std::shared_mutex> lock(shard.lock);
+        auto itr = shard.models.find(filename);
+        // another thread may have revived the entry before we got the lock
+        if (itr != shard.models.end() && itr->second->getRefCount() == 0)
         {
             VMAP_DEBUG_LOG("maps", "VMapManager2: unloading file '%s'", filename.c_str());
-            delete model->second.getModel();
-            iLoadedModelFiles.erase(model);
+            delete itr->second->getModel();
+            shard.models.erase(itr);
+        }
+
+        return true;
+    }
+
+    WorldModel* ModelFileRegistry::loadModel(std::string const& basepath, std::string const& filename, uint32 flags)
+    {
+        WorldModel* worldmodel = new WorldModel();
+        if (!worldmodel->readFile(basepath + filename + ".vmo"))
+        {
+            VMAP_ERROR_LOG("misc", "VMapManager2: could not load '%s%s.vmo'", basepath.c_str(), filename.c_str());
+            delete worldmodel;
+            return nullptr;
         }
+        VMAP_DEBUG_LOG("maps", "VMapManager2: loading file '%s%s'", basepath.c_str(), filename.c_str());
+
+        worldmodel->Flags = flags;
+        return worldmodel;
+    }
+
+    WorldModel* VMapManager2::acquireModelInstance(const std::string& basepath, const std::string& filename, uint32 flags/* Only used when creating the model */)
+    {
+        return iLoadedModelFiles.acquire(basepath, filename, flags);
+    }
+
+    void VMapManager2::releaseModelInstance(const std::string &filename)
+    {
+        if (!iLoadedModelFiles.release(filename))
+            VMAP_ERROR_LOG("misc", "VMapManager2: trying to unload non-loaded file '%s'", filename.c_str());
     }
 
     LoadResult VMapManager2::existsMap(char const* basePath, unsigned int mapId, int x, int y)
@@ -18,7 +18,12 @@
 #ifndef _VMAPMANAGER2_H
 #define _VMAPMANAGER2_H
 
-#include <mutex>
+#include <array>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <shared_mutex>
+#include <string>
 #include <unordered_map>
 #include <vector>
 #include "Define.h"
@@ -53,18 +58,51 @@ namespace VMAP
     class TC_COMMON_API ManagedModel
     {
         public:
-            ManagedModel() : iModel(nullptr), iRefCount(0) { }
-            void setModel(WorldModel* model) { iModel = model; }
-            WorldModel* getModel() { return iModel; }
+            ManagedModel() : iRefCount(1) { }
+            // blocks until the thread that created this entry finished loading the file
+            WorldModel* getModel() const { return iModel.get(); }
+            void setModel(std::shared_future<WorldModel*> model) { iModel = std::move(model); }
+            // fails if the last reference is already gone and the entry waits for removal, used under the shared shard lock
+            bool tryIncRefCount();
+            // also revives entries at zero, only used under the exclusive shard lock which release needs to erase them
             void incRefCount() { ++iRefCount; }
             int decRefCount() { return --iRefCount; }
+            int getRefCount() const { return iRefCount; }
         protected:
-            WorldModel* iModel;
-            int iRefCount;
+            std::shared_future<WorldModel*> iModel;
+            std::atomic<int> iRefCount;
     };
 
     typedef std::unordered_map<uint32, StaticMapTree*> InstanceTreeMap;
-    typedef std::unordered_map<std::string, ManagedModel> ModelFileMap;
+
+    /**
+    Reference counted registry of loaded model files.
+    Entries are spread over shards by file name, lookups of already loaded models only take a shared lock of one shard.
+    Model files are read outside of any lock, so different models are loaded in parallel and
+    concurrent requests for a model that is still being loaded wait only for that model.
+    */
+    class TC_COMMON_API ModelFileRegistry
+    {
+        public:
+            ~ModelFileRegistry();
+
+            WorldModel* acquire(std::string const& basepath, std::string const& filename, uint32 flags);
+            bool release(std::string const& filename);
+
+        private:
+            static constexpr std::size_t SHARD_COUNT = 16;
+
+            struct Shard
+            {
+                std::unordered_map<std::string, std::unique_ptr<ManagedModel>> models;
+                std::shared_mutex lock;
+            };
+
+            Shard& getShard(std::string const& filename) { return iShards[std::hash<std::string>()(filename) % SHARD_COUNT]; }
+            static WorldModel* loadModel(std::string const& basepath, std::string const& filename, uint32 flags);
+
+            std::array<Shard, SHARD_COUNT> iShards;
+    };
 
     enum DisableTypes
     {
@@ -78,11 +116,9 @@ namespace VMAP
     {
         protected:
             // Tree to check collision
-            ModelFileMap iLoadedModelFiles;
+            ModelFileRegistry iLoadedModelFiles;
             InstanceTreeMap iInstanceMapTrees;
             bool thread_safe_environment;
-            // Mutex for iLoadedModelFiles
-            std::mutex LoadedModelFilesLock;
 
             bool _loadMap(uint32 mapId, const std::string& basePath, uint32 tileX, uint32 tileY);
             /* void _unloadMap(uint32 pMapId, uint32 x, uint32 y); */
@@ -107,6 +143,7 @@ namespace VMAP
             void unloadMap(unsigned int mapId) override;
 
             bool isInLineOfSight(unsigned int mapId, float x1, float y1, float z1, float x2, float y2, float z2, ModelIgnoreFlags ignoreFlags) override ;
+            void isInLineOfSight(unsigned int mapId, float const* segments, bool* results, uint32 count, ModelIgnoreFlags ignoreFlags) override;
             /**
             fill the hit pos and return true, if an object was hit
             */
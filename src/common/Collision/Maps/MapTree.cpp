@@ -22,11 +22,14 @@
 #include "Log.h"
 #include "Errors.h"
 #include "Metric.h"
+#include <boost/container/small_vector.hpp>
 
+#include <algorithm>
 #include <string>
 #include <sstream>
 #include <iomanip>
 #include <limits>
+#include <vector>
 
 using G3D::Vector3;
 
@@ -171,6 +174,66 @@ namespace VMAP
 
         return true;
     }
+    //=========================================================
+    /**
+    Checks line of sight from every pos1[i] to pos2[i], rays are traversed in packets sharing the tree descent.
+    results[i] is set to true if pos2[i] is in line of sight of pos1[i]
+    */
+    void StaticMapTree::isInLineOfSight(Vector3 const* pos1, Vector3 const* pos2, bool* results, uint32 count, ModelIgnoreFlags ignoreFlag) const
+    {
+        struct RayEntry
+        {
+            uint32 index;
+            float maxDist;
+            float azimuth;
+            G3D::Ray ray;
+        };
+
+        boost::container::small_vector<RayEntry, LOS_BATCH_INLINE_SIZE> entries;
+        entries.reserve(count);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            float maxDist = (pos2[i] - pos1[i]).magnitude();
+            // same special cases as the single ray check
+            if (maxDist == std::numeric_limits<float>::max() || !std::isfinite(maxDist))
+            {
+                results[i] = false;
+                continue;
+            }
+
+            if (maxDist < 1e-10f)
+            {
+                results[i] = true;
+                continue;
+            }
+
+            Vector3 dir = (pos2[i] - pos1[i]) / maxDist;
+            entries.push_back({ i, maxDist, std::atan2(dir.y, dir.x), G3D::Ray::fromOriginAndDirection(pos1[i], dir) });
+        }
+
+        // rays pointing in similar directions descend the same tree nodes, group them into the same packets
+        if (entries.size() > BIH_RAY_PACKET_SIZE)
+            std::sort(entries.begin(), entries.end(), [](RayEntry const& left, RayEntry const& right) { return left.azimuth < right.azimuth; });
+
+        MapRayCallback intersectionCallBack(iTreeValues, ignoreFlag);
+        for (size_t i = 0; i < entries.size(); i += BIH_RAY_PACKET_SIZE)
+        {
+            uint32 packetSize = uint32(std::min<size_t>(BIH_RAY_PACKET_SIZE, entries.size() - i));
+            G3D::Ray rays[BIH_RAY_PACKET_SIZE];
+            float maxDist[BIH_RAY_PACKET_SIZE];
+            bool hits[BIH_RAY_PACKET_SIZE];
+            for (uint32 j = 0; j < packetSize; ++j)
+            {
+                rays[j] = entries[i + j].ray;
+                maxDist[j] = entries[i + j].maxDist;
+            }
+
+            iTree.intersectRayPacket(rays, packetSize, maxDist, intersectionCallBack, hits);
+            for (uint32 j = 0; j < packetSize; ++j)
+                results[entries[i + j].index] = !hits[j];
+        }
+    }
+
     //=========================================================
     /**
     When moving from pos1 to pos2 check if we hit an object. Return true and the position if we hit one
@@ -20,15 +20,65 @@
 #include "Config.h"
 #include "DeadlineTimer.h"
 #include "Log.h"
+#include "MetricLineEncoder.h"
 #include "Strand.h"
 #include "Util.h"
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/asio/ip/tcp.hpp>
 
+struct Metric::MetricSlot
+{
+    MetricSlot() : Count(0), Sum(0), Max(0)
+    {
+        for (std::atomic<uint64>& bucket : Buckets)
+            bucket.store(0, std::memory_order_relaxed);
+    }
+
+    // written by the owning thread, taken by SendBatch with exchange so no recorded value is lost
+    std::atomic<uint64> Count;
+    std::atomic<uint64> Sum;
+    std::atomic<uint64> Max;
+    std::array<std::atomic<uint64>, TIMER_BUCKETS> Buckets;
+};
+
+struct Metric::ThreadMetrics
+{
+    // slots are allocated in chunks on first use so threads that record a few metrics stay small
+    static constexpr MetricId SLOTS_PER_CHUNK = 64;
+
+    ThreadMetrics() : Next(nullptr)
+    {
+        for (std::atomic<MetricSlot*>& chunk : Chunks)
+            chunk.store(nullptr, std::memory_order_relaxed);
+    }
+
+    ~ThreadMetrics()
+    {
+        for (std::atomic<MetricSlot*>& chunk : Chunks)
+            delete[] chunk.load(std::memory_order_relaxed);
+    }
+
+    MetricSlot& GetSlot(MetricId id)
+    {
+        std::atomic<MetricSlot*>& chunk = Chunks[id / SLOTS_PER_CHUNK];
+        MetricSlot* slots = chunk.load(std::memory_order_relaxed);
+        if (!slots)
+        {
+            slots = new MetricSlot[SLOTS_PER_CHUNK];
+            chunk.store(slots, std::memory_order_release);
+        }
+
+        return slots[id % SLOTS_PER_CHUNK];
+    }
+
+    std::array<std::atomic<MetricSlot*>, MAX_REGISTERED_METRICS / SLOTS_PER_CHUNK> Chunks;
+    ThreadMetrics* Next;
+};
+
 void Metric::Initialize(std::string const& realmName, Trinity::Asio::IoContext& ioContext, std::function<void()> overallStatusLogger)
 {
     _dataStream = std::make_unique<boost::asio::ip::tcp::iostream>();
-    _realmName = FormatInfluxDBTagValue(realmName);
+    _realmName = realmName;
     _batchTimer = std::make_unique<Trinity::Asio::DeadlineTimer>(ioContext);
     _overallStatusTimer = std::make_unique<Trinity::Asio::DeadlineTimer>(ioContext);
     _overallStatusLogger = overallStatusLogger;
@@ -137,47 +187,185 @@ void Metric::LogEvent(std::string category, std::string title, std::string descr
     _queuedData.Enqueue(data);
 }
 
+MetricId Metric::Register(std::string category, MetricAggregation aggregation, MetricTagsVector tags)
+{
+    std::string encodedTags;
+    for (MetricTag const& tag : tags)
+    {
+        encodedTags += ',';
+        MetricLineEncoder::AppendEscapedKey(encodedTags, tag.first);
+        encodedTags += '=';
+        MetricLineEncoder::AppendEscapedKey(encodedTags, tag.second);
+    }
+
+    std::string key = category + encodedTags;
+
+    std::lock_guard<std::mutex> lock(_registeredMetricsLock);
+    auto itr = _registeredMetricIds.find(key);
+    if (itr != _registeredMetricIds.end())
+        return itr->second;
+
+    if (_registeredMetrics.size() >= MAX_REGISTERED_METRICS)
+    {
+        TC_LOG_ERROR("metric", "Metric::Register: Too many registered metrics, '%s' will not be recorded.", key.c_str());
+        return MAX_REGISTERED_METRICS;
+    }
+
+    MetricId id = MetricId(_registeredMetrics.size());
+    _registeredMetrics.push_back({ std::move(category), std::move(encodedTags), aggregation });
+    _registeredMetricIds.emplace(std::move(key), id);
+    return id;
+}
+
+Metric::ThreadMetrics* Metric::GetThreadMetrics()
+{
+    static thread_local ThreadMetrics* CurrentThreadMetrics = nullptr;
+    if (!CurrentThreadMetrics)
+    {
+        // never freed before shutdown, values recorded by a thread that already exited are still sent
+        ThreadMetrics* metrics = new ThreadMetrics();
+        metrics->Next = _threadMetrics.load(std::memory_order_relaxed);
+        while (!_threadMetrics.compare_exchange_weak(metrics->Next, metrics, std::memory_order_release, std::memory_order_relaxed))
+            ;
+
+        CurrentThreadMetrics = metrics;
+    }
+
+    return CurrentThreadMetrics;
+}
+
+void Metric::Record(MetricId id, MetricAggregation aggregation, uint64 value)
+{
+    if (!_enabled || id >= MAX_REGISTERED_METRICS)
+        return;
+
+    // the slot is only shared with SendBatch, so these never contend with other recording threads
+    MetricSlot& slot = GetThreadMetrics()->GetSlot(id);
+    slot.Count.fetch_add(1, std::memory_order_relaxed);
+    slot.Sum.fetch_add(value, std::memory_order_relaxed);
+    if (aggregation != METRIC_AGGREGATION_TIMER)
+        return;
+
+    slot.Buckets[GetTimerBucket(value)].fetch_add(1, std::memory_order_relaxed);
+    uint64 max = slot.Max.load(std::memory_order_relaxed);
+    while (value > max && !slot.Max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+        ;
+}
+
+uint32 Metric::GetTimerBucket(uint64 micros)
+{
+    uint32 bucket = 0;
+    while (micros && bucket < TIMER_BUCKETS - 1)
+    {
+        micros >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+uint64 Metric::GetTimerPercentile(std::array<uint64, TIMER_BUCKETS> const& buckets, uint64 count, uint64 max, float percentile)
+{
+    uint64 remaining = uint64(count * percentile / 100.0f);
+    for (uint32 i = 0; i < TIMER_BUCKETS - 1; ++i)
+    {
+        if (buckets[i] > remaining)
+            return std::min(uint64(1) << i, max);
+
+        remaining -= buckets[i];
+    }
+
+    return max;
+}
+
+void Metric::EncodeRegisteredMetrics(MetricLineEncoder& encoder, SystemTimePoint timestamp)
+{
+    std::lock_guard<std::mutex> lock(_registeredMetricsLock);
+    ThreadMetrics* threads = _threadMetrics.load(std::memory_order_acquire);
+    for (MetricId id = 0; id < _registeredMetrics.size(); ++id)
+    {
+        uint64 count = 0;
+        uint64 sum = 0;
+        uint64 max = 0;
+        std::array<uint64, TIMER_BUCKETS> buckets = { };
+        for (ThreadMetrics* thread = threads; thread; thread = thread->Next)
+        {
+            MetricSlot* slots = thread->Chunks[id / ThreadMetrics::SLOTS_PER_CHUNK].load(std::memory_order_acquire);
+            if (!slots)
+                continue;
+
+            // a value recorded while this runs may have its count sent now and its sum with the next batch
+            MetricSlot& slot = slots[id % ThreadMetrics::SLOTS_PER_CHUNK];
+            count += slot.Count.exchange(0, std::memory_order_relaxed);
+            sum += slot.Sum.exchange(0, std::memory_order_relaxed);
+            max = std::max(max, slot.Max.exchange(0, std::memory_order_relaxed));
+            for (uint32 i = 0; i < TIMER_BUCKETS; ++i)
+                buckets[i] += slot.Buckets[i].exchange(0, std::memory_order_relaxed);
+        }
+
+        if (!count)
+            continue;
+
+        RegisteredMetric const& metric = _registeredMetrics[id];
+        encoder.BeginLine(metric.Category);
+        if (!_realmName.empty())
+            encoder.AddTag("realm", _realmName);
+        encoder.AddEncodedTags(metric.EncodedTags);
+
+        switch (metric.Aggregation)
+        {
+            case METRIC_AGGREGATION_COUNTER:
+                encoder.AddField("value", sum);
+                encoder.AddField("count", count);
+                break;
+            case METRIC_AGGREGATION_TIMER:
+                // value keeps the meaning of TC_METRIC_TIMER, the slowest measurement in milliseconds
+                encoder.AddField("value", max / 1000);
+                encoder.AddField("count", count);
+                encoder.AddField("sum_us", sum);
+                encoder.AddField("p50_us", GetTimerPercentile(buckets, count, max, 50.0f));
+                encoder.AddField("p99_us", GetTimerPercentile(buckets, count, max, 99.0f));
+                break;
+        }
+
+        encoder.EndLine(timestamp);
+    }
+}
+
 void Metric::SendBatch()
 {
     using namespace std::chrono;
 
-    std::stringstream batchedData;
+    _batchBuffer.clear();
+    MetricLineEncoder encoder(_batchBuffer);
     MetricData* data;
-    bool firstLoop = true;
     while (_queuedData.Dequeue(data))
     {
-        if (!firstLoop)
-            batchedData << "\n";
-
-        batchedData << data->Category;
+        encoder.BeginLine(data->Category);
         if (!_realmName.empty())
-            batchedData << ",realm=" << _realmName;
+            encoder.AddTag("realm", _realmName);
 
         for (MetricTag const& tag : data->Tags)
-            batchedData << "," << tag.first << "=" << FormatInfluxDBTagValue(tag.second);
-
-        batchedData << " ";
+            encoder.AddTag(tag.first, tag.second);
 
         switch (data->Type)
         {
             case METRIC_DATA_VALUE:
-                batchedData << "value=" << data->ValueOrEventText;
+                encoder.AddEncodedField("value", data->ValueOrEventText);
                 break;
             case METRIC_DATA_EVENT:
-                batchedData << "title=\"" << data->Title << "\",text=\"" << data->ValueOrEventText << "\"";
+                encoder.AddStringField("title", data->Title);
+                encoder.AddStringField("text", data->ValueOrEventText);
                 break;
         }
 
-        batchedData << " ";
-
-        batchedData << std::to_string(duration_cast<nanoseconds>(data->Timestamp.time_since_epoch()).count());
-
-        firstLoop = false;
+        encoder.EndLine(data->Timestamp);
         delete data;
     }
 
+    EncodeRegisteredMetrics(encoder, system_clock::now());
+
     // Check if there's any data to send
-    if (batchedData.tellp() == std::streampos(0))
+    if (_batchBuffer.empty())
     {
         ScheduleSend();
         return;
@@ -192,8 +380,8 @@ void Metric::SendBatch()
     GetDataStream() << "Content-Type: application/octet-stream\r\n";
     GetDataStream() << "Content-Transfer-Encoding: binary\r\n";
 
-    GetDataStream() << "Content-Length: " << std::to_string(batchedData.tellp()) << "\r\n\r\n";
-    GetDataStream() << batchedData.rdbuf();
+    GetDataStream() << "Content-Length: " << _batchBuffer.size() << "\r\n\r\n";
+    GetDataStream().write(_batchBuffer.data(), _batchBuffer.size());
 
     std::string http_version;
     GetDataStream() >> http_version;
@@ -290,23 +478,24 @@ std::string Metric::FormatInfluxDBValue(float value)
     return FormatInfluxDBValue(double(value));
 }
 
-std::string Metric::FormatInfluxDBTagValue(std::string const& value)
-{
-    // ToDo: should handle '=' and ',' characters too
-    return boost::replace_all_copy(value, " ", "\\ ");
-}
-
 std::string Metric::FormatInfluxDBValue(std::chrono::nanoseconds value)
 {
     return FormatInfluxDBValue(std::chrono::duration_cast<Milliseconds>(value).count());
 }
 
-Metric::Metric()
+Metric::Metric() : _threadMetrics(nullptr)
 {
 }
 
 Metric::~Metric()
 {
+    ThreadMetrics* metrics = _threadMetrics.load(std::memory_order_acquire);
+    while (metrics)
+    {
+        ThreadMetrics* next = metrics->Next;
+        delete metrics;
+        metrics = next;
+    }
 }
 
 Metric* Metric::instance()
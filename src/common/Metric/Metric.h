@@ -23,12 +23,18 @@
 #include "MPSCQueue.h"
 #include "Optional.h"
 #include <boost/container/small_vector.hpp>
+#include <array>
+#include <atomic>
 #include <functional>
 #include <iosfwd>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
+
+class MetricLineEncoder;
 
 namespace Trinity
 {
@@ -45,8 +51,15 @@ enum MetricDataType
     METRIC_DATA_EVENT
 };
 
+enum MetricAggregation
+{
+    METRIC_AGGREGATION_COUNTER,     // sum and number of the recorded values
+    METRIC_AGGREGATION_TIMER        // count, sum, max and percentiles of the recorded microseconds
+};
+
 using MetricTag = std::pair<std::string, std::string>;
 using MetricTagsVector = boost::container::small_vector<MetricTag, 2>;
+using MetricId = uint32;
 
 struct MetricData
 {
@@ -68,7 +81,22 @@ struct MetricData
 
 class TC_COMMON_API Metric
 {
+public:
+    static constexpr MetricId MAX_REGISTERED_METRICS = 4096;
+    // log2 buckets, [0, 1), [1, 2), [2, 4) ... the last one is open
+    static constexpr uint32 TIMER_BUCKETS = 32;
+
 private:
+    struct RegisteredMetric
+    {
+        std::string Category;
+        std::string EncodedTags;
+        MetricAggregation Aggregation;
+    };
+
+    struct MetricSlot;
+    struct ThreadMetrics;
+
     std::iostream& GetDataStream() { return *_dataStream; }
     std::unique_ptr<std::iostream> _dataStream;
     MPSCQueue<MetricData, &MetricData::QueueLink> _queuedData;
@@ -84,6 +112,15 @@ private:
     std::function<void()> _overallStatusLogger;
     std::string _realmName;
     std::unordered_map<std::string, int64> _thresholds;
+    std::string _batchBuffer;
+
+    std::mutex _registeredMetricsLock;
+    std::vector<RegisteredMetric> _registeredMetrics;
+    std::unordered_map<std::string, MetricId> _registeredMetricIds;
+    std::atomic<ThreadMetrics*> _threadMetrics;
+
+    ThreadMetrics* GetThreadMetrics();
+    void EncodeRegisteredMetrics(MetricLineEncoder& encoder, SystemTimePoint timestamp);
 
     bool Connect();
     void SendBatch();
@@ -99,10 +136,6 @@ private:
     static std::string FormatInfluxDBValue(float value);
     static std::string FormatInfluxDBValue(std::chrono::nanoseconds value);
 
-    static std::string FormatInfluxDBTagValue(std::string const& value);
-
-    // ToDo: should format TagKey and FieldKey too in the same way as TagValue
-
 public:
     Metric();
     ~Metric();
@@ -131,12 +164,59 @@ public:
 
     void LogEvent(std::string category, std::string title, std::string description);
 
+    // Registered metrics are recorded into counters owned by the recording thread and only
+    // summed up when the batch is sent, registering the same category and tags again returns the same id
+    MetricId Register(std::string category, MetricAggregation aggregation, MetricTagsVector tags = {});
+    void Record(MetricId id, MetricAggregation aggregation, uint64 value);
+
+    static uint32 GetTimerBucket(uint64 micros);
+    // upper bound of the bucket that contains the percentile, never more than max
+    static uint64 GetTimerPercentile(std::array<uint64, TIMER_BUCKETS> const& buckets, uint64 count, uint64 max, float percentile);
+
     void Unload();
     bool IsEnabled() const { return _enabled; }
 };
 
 #define sMetric Metric::instance()
 
+class MetricHandle
+{
+public:
+    MetricHandle(std::string category, MetricAggregation aggregation, MetricTagsVector tags = {}) :
+        _id(sMetric->Register(std::move(category), aggregation, std::move(tags))), _aggregation(aggregation)
+    {
+    }
+
+    void Record(uint64 value) const { sMetric->Record(_id, _aggregation, value); }
+
+private:
+    MetricId _id;
+    MetricAggregation _aggregation;
+};
+
+class MetricTimer
+{
+public:
+    MetricTimer(MetricHandle const& handle) : _handle(handle), _startTime()
+    {
+        if (sMetric->IsEnabled())
+            _startTime = std::chrono::steady_clock::now();
+    }
+
+    ~MetricTimer()
+    {
+        if (_startTime != TimePoint())
+            _handle.Record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _startTime).count());
+    }
+
+    MetricTimer(MetricTimer const&) = delete;
+    MetricTimer& operator=(MetricTimer const&) = delete;
+
+private:
+    MetricHandle const& _handle;
+    TimePoint _startTime;
+};
+
 template<typename LoggerType>
 class MetricStopWatch
 {
@@ -176,6 +256,8 @@ Optional<MetricStopWatch<LoggerType>> MakeMetricStopWatch(LoggerType&& loggerFun
 #define TC_METRIC_EVENT(category, title, description) ((void)0)
 #define TC_METRIC_VALUE(category, value, ...) ((void)0)
 #define TC_METRIC_TIMER(category, ...) ((void)0)
+#define TC_METRIC_COUNTER(category, value, ...) ((void)0)
+#define TC_METRIC_AGGREGATED_TIMER(category, ...) ((void)0)
 #define TC_METRIC_DETAILED_EVENT(category, title, description) ((void)0)
 #define TC_METRIC_DETAILED_TIMER(category, ...) ((void)0)
 #define TC_METRIC_DETAILED_NO_THRESHOLD_TIMER(category, ...) ((void)0)
@@ -191,6 +273,12 @@ Optional<MetricStopWatch<LoggerType>> MakeMetricStopWatch(LoggerType&& loggerFun
             if (sMetric->IsEnabled())                                  \
                 sMetric->LogValue(category, value, ##__VA_ARGS__);     \
         } while (0)
+#define TC_METRIC_COUNTER(category, value, ...)                                                                  \
+        do {                                                                                                     \
+            static MetricHandle const __tc_metric_handle(category, METRIC_AGGREGATION_COUNTER, { __VA_ARGS__ });  \
+            if (sMetric->IsEnabled())                                                                            \
+                __tc_metric_handle.Record(value);                                                                \
+        } while (0)
 #  else
 #define TC_METRIC_EVENT(category, title, description)                  \
         __pragma(warning(push))                                        \
@@ -208,12 +296,25 @@ Optional<MetricStopWatch<LoggerType>> MakeMetricStopWatch(LoggerType&& loggerFun
                 sMetric->LogValue(category, value, ##__VA_ARGS__);     \
         } while (0)                                                    \
         __pragma(warning(pop))
+#define TC_METRIC_COUNTER(category, value, ...)                                                                  \
+        __pragma(warning(push))                                                                                  \
+        __pragma(warning(disable:4127))                                                                          \
+        do {                                                                                                     \
+            static MetricHandle const __tc_metric_handle(category, METRIC_AGGREGATION_COUNTER, { __VA_ARGS__ });  \
+            if (sMetric->IsEnabled())                                                                            \
+                __tc_metric_handle.Record(value);                                                                \
+        } while (0)                                                                                              \
+        __pragma(warning(pop))
 #  endif
 #define TC_METRIC_TIMER(category, ...)                                                                           \
         auto TC_METRIC_UNIQUE_NAME(__tc_metric_stop_watch) = MakeMetricStopWatch([&](TimePoint start)            \
         {                                                                                                        \
             sMetric->LogValue(category, std::chrono::steady_clock::now() - start, ##__VA_ARGS__);                \
         });
+// category and tags are registered on the first call and must not change afterwards
+#define TC_METRIC_AGGREGATED_TIMER(category, ...)                                                                \
+        static MetricHandle const TC_METRIC_UNIQUE_NAME(__tc_metric_handle)(category, METRIC_AGGREGATION_TIMER, { __VA_ARGS__ }); \
+        MetricTimer TC_METRIC_UNIQUE_NAME(__tc_metric_timer)(TC_METRIC_UNIQUE_NAME(__tc_metric_handle));
 #  if defined WITH_DETAILED_METRICS
 #define TC_METRIC_DETAILED_TIMER(category, ...)                                                                  \
         auto TC_METRIC_UNIQUE_NAME(__tc_metric_stop_watch) = MakeMetricStopWatch([&](TimePoint start)            \
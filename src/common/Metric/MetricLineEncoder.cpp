@@ -0,0 +1,134 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MetricLineEncoder.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <iterator>
+
+void MetricLineEncoder::BeginLine(std::string_view measurement)
+{
+    if (!_buffer.empty())
+        _buffer += '\n';
+
+    AppendEscapedMeasurement(_buffer, measurement);
+    _firstField = true;
+}
+
+void MetricLineEncoder::AddTag(std::string_view key, std::string_view value)
+{
+    _buffer += ',';
+    AppendEscapedKey(_buffer, key);
+    _buffer += '=';
+    AppendEscapedKey(_buffer, value);
+}
+
+void MetricLineEncoder::AddField(std::string_view key, int64 value)
+{
+    BeginField(key);
+    AppendInteger(value < 0 ? uint64(0) - uint64(value) : uint64(value), value < 0);
+    _buffer += 'i';
+}
+
+void MetricLineEncoder::AddField(std::string_view key, uint64 value)
+{
+    BeginField(key);
+    AppendInteger(value, false);
+    _buffer += 'i';
+}
+
+void MetricLineEncoder::AddField(std::string_view key, double value)
+{
+    BeginField(key);
+
+    // same format as std::to_string, without the temporary string
+    char buffer[384];
+    int length = std::snprintf(buffer, sizeof(buffer), "%f", value);
+    if (length > 0)
+        _buffer.append(buffer, std::min<std::size_t>(length, sizeof(buffer) - 1));
+}
+
+void MetricLineEncoder::AddField(std::string_view key, bool value)
+{
+    BeginField(key);
+    _buffer += value ? 't' : 'f';
+}
+
+void MetricLineEncoder::AddStringField(std::string_view key, std::string_view value)
+{
+    BeginField(key);
+    _buffer += '"';
+    for (char c : value)
+    {
+        if (c == '"' || c == '\\')
+            _buffer += '\\';
+        _buffer += c;
+    }
+    _buffer += '"';
+}
+
+void MetricLineEncoder::AddEncodedField(std::string_view key, std::string_view encodedValue)
+{
+    BeginField(key);
+    _buffer.append(encodedValue);
+}
+
+void MetricLineEncoder::EndLine(SystemTimePoint timestamp)
+{
+    _buffer += ' ';
+    AppendInteger(uint64(std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch()).count()), false);
+}
+
+void MetricLineEncoder::AppendEscapedMeasurement(std::string& buffer, std::string_view measurement)
+{
+    for (char c : measurement)
+    {
+        if (c == ',' || c == ' ')
+            buffer += '\\';
+        buffer += c;
+    }
+}
+
+void MetricLineEncoder::AppendEscapedKey(std::string& buffer, std::string_view key)
+{
+    for (char c : key)
+    {
+        if (c == ',' || c == '=' || c == ' ')
+            buffer += '\\';
+        buffer += c;
+    }
+}
+
+void MetricLineEncoder::BeginField(std::string_view key)
+{
+    _buffer += _firstField ? ' ' : ',';
+    _firstField = false;
+    AppendEscapedKey(_buffer, key);
+    _buffer += '=';
+}
+
+void MetricLineEncoder::AppendInteger(uint64 value, bool negative)
+{
+    char buffer[24];
+    char* begin = buffer;
+    if (negative)
+        *begin++ = '-';
+
+    std::to_chars_result result = std::to_chars(begin, std::end(buffer), value);
+    _buffer.append(buffer, result.ptr);
+}
@@ -0,0 +1,63 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef METRIC_LINE_ENCODER_H__
+#define METRIC_LINE_ENCODER_H__
+
+#include "Define.h"
+#include "Duration.h"
+#include <string>
+#include <string_view>
+
+/**
+    Appends InfluxDB line protocol to a caller owned buffer:
+        measurement,tag=value,tag2=value field=1i,field2="text" timestamp
+    The buffer is only appended to, so once it reached the size of a batch encoding never allocates.
+*/
+class TC_COMMON_API MetricLineEncoder
+{
+public:
+    explicit MetricLineEncoder(std::string& buffer) : _buffer(buffer), _firstField(true) { }
+
+    void BeginLine(std::string_view measurement);
+    void AddTag(std::string_view key, std::string_view value);
+    // appends tags that were already encoded as ,key=value with AppendEscapedKey
+    void AddEncodedTags(std::string_view encodedTags) { _buffer.append(encodedTags); }
+
+    void AddField(std::string_view key, int64 value);
+    void AddField(std::string_view key, uint64 value);
+    void AddField(std::string_view key, double value);
+    void AddField(std::string_view key, bool value);
+    void AddStringField(std::string_view key, std::string_view value);
+    // appends a value that was already formatted for the line protocol
+    void AddEncodedField(std::string_view key, std::string_view encodedValue);
+
+    void EndLine(SystemTimePoint timestamp);
+
+    static void AppendEscapedMeasurement(std::string& buffer, std::string_view measurement);
+    // tag keys, tag values and field keys share the same escaping rules
+    static void AppendEscapedKey(std::string& buffer, std::string_view key);
+
+private:
+    void BeginField(std::string_view key);
+    void AppendInteger(uint64 value, bool negative);
+
+    std::string& _buffer;
+    bool _firstField;
+};
+
+#endif // METRIC_LINE_ENCODER_H__
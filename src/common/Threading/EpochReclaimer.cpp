@@ -0,0 +1,137 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EpochReclaimer.h"
+#include <algorithm>
+
+namespace
+{
+    // releases the record of an exiting thread so it can be reused by the next one
+    struct ThreadRecordHolder
+    {
+        Trinity::EpochReclaimer::ThreadRecord* Record = nullptr;
+
+        ~ThreadRecordHolder()
+        {
+            if (Record)
+                Record->InUse.store(false, std::memory_order_release);
+        }
+    };
+
+    thread_local ThreadRecordHolder CurrentThreadRecord;
+}
+
+namespace Trinity
+{
+EpochReclaimer::EpochReclaimer() : _globalEpoch(1), _threadRecords(nullptr)
+{
+}
+
+EpochReclaimer::~EpochReclaimer()
+{
+    for (RetiredObject const& retired : _retired)
+        retired.Deleter(retired.Object);
+
+    // thread records are intentionally leaked, threads that are still running may release theirs after this point
+}
+
+EpochReclaimer* EpochReclaimer::instance()
+{
+    static EpochReclaimer instance;
+    return &instance;
+}
+
+EpochReclaimer::ThreadRecord* EpochReclaimer::GetThreadRecord()
+{
+    if (!CurrentThreadRecord.Record)
+        CurrentThreadRecord.Record = instance()->AcquireThreadRecord();
+
+    return CurrentThreadRecord.Record;
+}
+
+EpochReclaimer::ThreadRecord* EpochReclaimer::AcquireThreadRecord()
+{
+    for (ThreadRecord* record = _threadRecords.load(std::memory_order_acquire); record; record = record->Next)
+    {
+        bool inUse = false;
+        if (!record->InUse.load(std::memory_order_relaxed) && record->InUse.compare_exchange_strong(inUse, true, std::memory_order_acquire))
+            return record;
+    }
+
+    ThreadRecord* record = new ThreadRecord();
+    record->Epoch.store(0, std::memory_order_relaxed);
+    record->InUse.store(true, std::memory_order_relaxed);
+    record->Depth = 0;
+    record->Next = _threadRecords.load(std::memory_order_relaxed);
+    while (!_threadRecords.compare_exchange_weak(record->Next, record, std::memory_order_release, std::memory_order_relaxed))
+        ;
+
+    return record;
+}
+
+void EpochReclaimer::Retire(void* object, void(*deleter)(void*))
+{
+    {
+        std::lock_guard<std::mutex> lock(_retiredLock);
+        _retired.push_back({ _globalEpoch.load(std::memory_order_seq_cst), object, deleter });
+    }
+
+    Collect();
+}
+
+bool EpochReclaimer::TryAdvanceEpoch()
+{
+    uint64 epoch = _globalEpoch.load(std::memory_order_seq_cst);
+    for (ThreadRecord* record = _threadRecords.load(std::memory_order_acquire); record; record = record->Next)
+    {
+        uint64 threadEpoch = record->Epoch.load(std::memory_order_seq_cst);
+        if (threadEpoch && threadEpoch != epoch)
+            return false;
+    }
+
+    return _globalEpoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst);
+}
+
+std::size_t EpochReclaimer::Collect()
+{
+    std::vector<RetiredObject> reclaimable;
+    std::size_t waiting;
+    {
+        std::lock_guard<std::mutex> lock(_retiredLock);
+        if (_retired.empty())
+            return 0;
+
+        TryAdvanceEpoch();
+
+        // readers that entered before an object was retired may hold it until the epoch advanced twice
+        uint64 epoch = _globalEpoch.load(std::memory_order_seq_cst);
+        auto itr = std::partition(_retired.begin(), _retired.end(), [epoch](RetiredObject const& retired)
+        {
+            return retired.Epoch + 2 > epoch;
+        });
+
+        reclaimable.assign(itr, _retired.end());
+        _retired.erase(itr, _retired.end());
+        waiting = _retired.size();
+    }
+
+    for (RetiredObject const& retired : reclaimable)
+        retired.Deleter(retired.Object);
+
+    return waiting;
+}
+}
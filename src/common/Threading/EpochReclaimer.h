@@ -0,0 +1,112 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EpochReclaimer_h__
+#define EpochReclaimer_h__
+
+#include "Define.h"
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace Trinity
+{
+// Epoch based memory reclamation.
+// Readers enter a critical section with EpochGuard and may dereference any object that was reachable when they entered.
+// Writers unlink objects first and then Retire them, the object is deleted once every reader that could still see it has left.
+class TC_COMMON_API EpochReclaimer
+{
+public:
+    struct alignas(64) ThreadRecord
+    {
+        std::atomic<uint64> Epoch;  // 0 while outside of a critical section
+        std::atomic<bool> InUse;
+        uint32 Depth;
+        ThreadRecord* Next;
+    };
+
+    static EpochReclaimer* instance();
+
+    void Enter()
+    {
+        ThreadRecord* record = GetThreadRecord();
+        if (record->Depth++)
+            return;
+
+        // seq_cst store, loads of protected pointers must not be reordered before it
+        record->Epoch.store(_globalEpoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+    }
+
+    void Leave()
+    {
+        ThreadRecord* record = GetThreadRecord();
+        if (!--record->Depth)
+            record->Epoch.store(0, std::memory_order_release);
+    }
+
+    template<class T>
+    void Retire(T const* object)
+    {
+        Retire(const_cast<T*>(object), [](void* ptr) { delete static_cast<T*>(ptr); });
+    }
+
+    void Retire(void* object, void(*deleter)(void*));
+
+    // deletes all retired objects no reader can reference anymore, returns the number of objects still waiting
+    std::size_t Collect();
+
+    uint64 GetEpoch() const { return _globalEpoch.load(std::memory_order_relaxed); }
+
+private:
+    EpochReclaimer();
+    ~EpochReclaimer();
+
+    struct RetiredObject
+    {
+        uint64 Epoch;
+        void* Object;
+        void(*Deleter)(void*);
+    };
+
+    static ThreadRecord* GetThreadRecord();
+    ThreadRecord* AcquireThreadRecord();
+    bool TryAdvanceEpoch();
+
+    std::atomic<uint64> _globalEpoch;
+    std::atomic<ThreadRecord*> _threadRecords;
+
+    std::mutex _retiredLock;
+    std::vector<RetiredObject> _retired;
+
+    EpochReclaimer(EpochReclaimer const&) = delete;
+    EpochReclaimer& operator=(EpochReclaimer const&) = delete;
+};
+
+class EpochGuard
+{
+public:
+    EpochGuard() { EpochReclaimer::instance()->Enter(); }
+    ~EpochGuard() { EpochReclaimer::instance()->Leave(); }
+
+    EpochGuard(EpochGuard const&) = delete;
+    EpochGuard& operator=(EpochGuard const&) = delete;
+};
+}
+
+#define sEpochReclaimer Trinity::EpochReclaimer::instance()
+
+#endif // EpochReclaimer_h__
@@ -0,0 +1,107 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ShardedRegistry_h__
+#define ShardedRegistry_h__
+
+#include "EpochReclaimer.h"
+#include <array>
+#include <unordered_map>
+
+namespace Trinity
+{
+// Concurrent map for data that is looked up far more often than it changes, like the online players.
+// Each shard publishes an immutable table that readers search without taking any lock,
+// writers lock a single shard, publish a modified copy of its table and retire the old one.
+template<class Key, class Value, class Hash = std::hash<Key>, std::size_t ShardCount = 64>
+class ShardedRegistry
+{
+public:
+    typedef std::unordered_map<Key, Value, Hash> TableType;
+
+    ShardedRegistry()
+    {
+        for (Shard& shard : _shards)
+            shard.Table.store(nullptr, std::memory_order_relaxed);
+    }
+
+    ~ShardedRegistry()
+    {
+        for (Shard& shard : _shards)
+            delete shard.Table.load(std::memory_order_relaxed);
+    }
+
+    // returns a default constructed Value if the key is not registered
+    Value Find(Key const& key) const
+    {
+        EpochGuard guard;
+        TableType const* table = GetShard(key).Table.load(std::memory_order_seq_cst);
+        if (!table)
+            return Value();
+
+        auto itr = table->find(key);
+        return itr != table->end() ? itr->second : Value();
+    }
+
+    void Insert(Key const& key, Value const& value)
+    {
+        Shard& shard = GetShard(key);
+        std::lock_guard<std::mutex> lock(shard.WriteLock);
+        TableType const* table = shard.Table.load(std::memory_order_relaxed);
+        TableType* newTable = table ? new TableType(*table) : new TableType();
+        (*newTable)[key] = value;
+        Publish(shard, table, newTable);
+    }
+
+    void Remove(Key const& key)
+    {
+        Shard& shard = GetShard(key);
+        std::lock_guard<std::mutex> lock(shard.WriteLock);
+        TableType const* table = shard.Table.load(std::memory_order_relaxed);
+        if (!table || !table->count(key))
+            return;
+
+        TableType* newTable = new TableType(*table);
+        newTable->erase(key);
+        Publish(shard, table, newTable);
+    }
+
+private:
+    struct alignas(64) Shard
+    {
+        std::atomic<TableType const*> Table;
+        std::mutex WriteLock;
+    };
+
+    Shard& GetShard(Key const& key) { return _shards[Hash()(key) % ShardCount]; }
+    Shard const& GetShard(Key const& key) const { return _shards[Hash()(key) % ShardCount]; }
+
+    static void Publish(Shard& shard, TableType const* oldTable, TableType const* newTable)
+    {
+        shard.Table.store(newTable, std::memory_order_seq_cst);
+        if (oldTable)
+            sEpochReclaimer->Retire(oldTable);
+    }
+
+    std::array<Shard, ShardCount> _shards;
+
+    ShardedRegistry(ShardedRegistry const&) = delete;
+    ShardedRegistry& operator=(ShardedRegistry const&) = delete;
+};
+}
+
+#endif // ShardedRegistry_h__
@@ -18,10 +18,19 @@
 #include "EventMap.h"
 #include "Random.h"
 
+namespace
+{
+    uint64 DelayExpiry(uint64 expiry, Milliseconds delay)
+    {
+        int64 delayed = int64(expiry) + delay.count();
+        return delayed > 0 ? uint64(delayed) : 0;
+    }
+}
+
 void EventMap::Reset()
 {
-    _eventMap.clear();
-    _time = TimePoint::min();
+    _eventMap.Reset();
+    _time = 0ms;
     _phase = 0;
 }
 
@@ -41,7 +50,7 @@ void EventMap::ScheduleEvent(uint32 eventId, Milliseconds time, uint32 group /*=
     if (phase && phase <= 8)
         eventId |= (1 << (phase + 23));
 
-    _eventMap.insert(EventStore::value_type(_time + time, eventId));
+    _eventMap.Schedule(GetExpiry(time), eventId);
 }
 
 void EventMap::ScheduleEvent(uint32 eventId, Milliseconds minTime, Milliseconds maxTime, uint32 group /*= 0*/, uint32 phase /*= 0*/)
@@ -62,7 +71,7 @@ void EventMap::RescheduleEvent(uint32 eventId, Milliseconds minTime, Millisecond
 
 void EventMap::Repeat(Milliseconds time)
 {
-    _eventMap.insert(EventStore::value_type(_time + time, _lastEvent));
+    _eventMap.Schedule(GetExpiry(time), _lastEvent);
 }
 
 void EventMap::Repeat(Milliseconds minTime, Milliseconds maxTime)
@@ -72,21 +81,16 @@ void EventMap::Repeat(Milliseconds minTime, Milliseconds maxTime)
 
 uint32 EventMap::ExecuteEvent()
 {
-    while (!Empty())
+    _eventMap.Advance(GetExpiry(0ms));
+
+    uint32 eventData;
+    while (_eventMap.PopDue(eventData))
     {
-        EventStore::iterator itr = _eventMap.begin();
-
-        if (itr->first > _time)
-            return 0;
-        else if (_phase && (itr->second & 0xFF000000) && !((itr->second >> 24) & _phase))
-            _eventMap.erase(itr);
-        else
-        {
-            uint32 eventId = (itr->second & 0x0000FFFF);
-            _lastEvent = itr->second; // include phase/group
-            _eventMap.erase(itr);
-            return eventId;
-        }
+        if (_phase && (eventData & 0xFF000000) && !((eventData >> 24) & _phase))
+            continue;
+
+        _lastEvent = eventData; // include phase/group
+        return (eventData & 0x0000FFFF);
     }
 
     return 0;
@@ -97,13 +101,11 @@ void EventMap::DelayEvents(Milliseconds delay)
     if (Empty())
         return;
 
-    EventStore delayed = std::move(_eventMap);
-    for (EventStore::iterator itr = delayed.begin(); itr != delayed.end();)
+    _eventMap.ModifyIf([delay](uint32 /*eventData*/, uint64& expiry) -> bool
     {
-        EventStore::node_type node = delayed.extract(itr++);
-        node.key() = node.key() + delay;
-        _eventMap.insert(_eventMap.end(), std::move(node));
-    }
+        expiry = DelayExpiry(expiry, delay);
+        return true;
+    });
 }
 
 void EventMap::DelayEvents(Milliseconds delay, uint32 group)
@@ -111,20 +113,14 @@ void EventMap::DelayEvents(Milliseconds delay, uint32 group)
     if (!group || group > 8 || Empty())
         return;
 
-    EventStore delayed;
-
-    for (EventStore::iterator itr = _eventMap.begin(); itr != _eventMap.end();)
+    _eventMap.ModifyIf([delay, group](uint32 eventData, uint64& expiry) -> bool
     {
-        if (itr->second & (1 << (group + 15)))
-        {
-            delayed.insert(EventStore::value_type(itr->first + delay, itr->second));
-            _eventMap.erase(itr++);
-        }
-        else
-            ++itr;
-    }
+        if (!(eventData & (1 << (group + 15))))
+            return false;
 
-    _eventMap.insert(delayed.begin(), delayed.end());
+        expiry = DelayExpiry(expiry, delay);
+        return true;
+    });
 }
 
 void EventMap::CancelEvent(uint32 eventId)
@@ -132,13 +128,10 @@ void EventMap::CancelEvent(uint32 eventId)
     if (Empty())
         return;
 
-    for (EventStore::iterator itr = _eventMap.begin(); itr != _eventMap.end();)
+    _eventMap.RemoveIf([eventId](uint32 eventData, uint64 /*expiry*/)
     {
-        if (eventId == (itr->second & 0x0000FFFF))
-            _eventMap.erase(itr++);
-        else
-            ++itr;
-    }
+        return eventId == (eventData & 0x0000FFFF);
+    });
 }
 
 void EventMap::CancelEventGroup(uint32 group)
@@ -146,20 +139,26 @@ void EventMap::CancelEventGroup(uint32 group)
     if (!group || group > 8 || Empty())
         return;
 
-    for (EventStore::iterator itr = _eventMap.begin(); itr != _eventMap.end();)
+    _eventMap.RemoveIf([group](uint32 eventData, uint64 /*expiry*/)
     {
-        if (itr->second & (1 << (group + 15)))
-            _eventMap.erase(itr++);
-        else
-            ++itr;
-    }
+        return (eventData & (1 << (group + 15))) != 0;
+    });
 }
 
 Milliseconds EventMap::GetTimeUntilEvent(uint32 eventId) const
 {
-    for (std::pair<TimePoint const, uint32> const& itr : _eventMap)
-        if (eventId == (itr.second & 0x0000FFFF))
-            return std::chrono::duration_cast<Milliseconds>(itr.first - _time);
+    EventStore::NodeId event = _eventMap.FindFirst([eventId](uint32 eventData)
+    {
+        return eventId == (eventData & 0x0000FFFF);
+    });
 
-    return Milliseconds::max();
+    if (event == EventStore::INVALID_NODE)
+        return Milliseconds::max();
+
+    return Milliseconds(int64(_eventMap.GetExpiry(event)) - int64(GetExpiry(0ms)));
+}
+
+uint64 EventMap::GetExpiry(Milliseconds time) const
+{
+    return DelayExpiry(uint64(_time.count()), time);
 }
@@ -20,13 +20,13 @@
 
 #include "Define.h"
 #include "Duration.h"
-#include <map>
+#include "TimerWheel.h"
 
 class TC_COMMON_API EventMap
 {
     /**
     * Internal storage type.
-    * Key: Time as TimePoint when the event should occur.
+    * Expiry: Value of the internal timer in milliseconds when the event should occur.
     * Value: The event data as uint32.
     *
     * Structure of event data:
@@ -35,10 +35,10 @@ class TC_COMMON_API EventMap
     * - Bit 24 - 31: Phase
     * - Pattern: 0xPPGGEEEE
     */
-    typedef std::multimap<TimePoint, uint32> EventStore;
+    typedef TimerWheel<uint32> EventStore;
 
 public:
-    EventMap() : _time(TimePoint::min()), _phase(0), _lastEvent(0) { }
+    EventMap() : _time(0), _phase(0), _lastEvent(0) { }
 
     /**
     * @name Reset
@@ -81,7 +81,7 @@ public:
     */
     bool Empty() const
     {
-        return _eventMap.empty();
+        return _eventMap.IsEmpty();
     }
 
     /**
@@ -226,6 +226,14 @@ public:
     Milliseconds GetTimeUntilEvent(uint32 eventId) const;
 
 private:
+    /**
+    * @name GetExpiry
+    * @brief Converts a time relative to the internal timer to an expiry of the event storage.
+    * @param time Time relative to the internal timer.
+    * @return Milliseconds of the internal timer, not lower than 0.
+    */
+    uint64 GetExpiry(Milliseconds time) const;
+
     /**
     * @name _time
     * @brief Internal timer.
@@ -236,7 +244,7 @@ private:
     * has reached their time value. Its value is changed in the
     * Update method.
     */
-    TimePoint _time;
+    Milliseconds _time;
 
     /**
     * @name _phase
@@ -41,15 +41,12 @@ void EventProcessor::Update(uint32 p_time)
 {
     // update time
     m_time += p_time;
+    m_events.Advance(m_time);
 
     // main event loop
-    std::multimap<uint64, BasicEvent*>::iterator i;
-    while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+    BasicEvent* event;
+    while (m_events.PopDue(event))
     {
-        // get and remove event from queue
-        BasicEvent* event = i->second;
-        m_events.erase(i);
-
         if (event->IsRunning())
         {
             if (event->Execute(m_time, p_time))
@@ -81,33 +78,29 @@ void EventProcessor::Update(uint32 p_time)
 
 void EventProcessor::KillAllEvents(bool force)
 {
-    for (auto itr = m_events.begin(); itr != m_events.end();)
+    m_events.Visit([this, force](TimerWheel<BasicEvent*>::NodeId id)
     {
+        BasicEvent* event = m_events.GetValue(id);
+
         // Abort events which weren't aborted already
-        if (!itr->second->IsAborted())
+        if (!event->IsAborted())
         {
-            itr->second->SetAborted();
-            itr->second->Abort(m_time);
+            event->SetAborted();
+            event->Abort(m_time);
         }
 
         // Skip non-deletable events when we are
         // not forcing the event cancellation.
-        if (!force && !itr->second->IsDeletable())
-        {
-            ++itr;
-            continue;
-        }
-
-        delete itr->second;
+        if (!force && !event->IsDeletable())
+            return;
 
-        if (force)
-            ++itr; // Clear the whole container when forcing
-        else
-            itr = m_events.erase(itr);
-    }
+        m_events.Remove(id);
+        delete event;
+    });
 
+    // Clear the whole container when forcing
     if (force)
-        m_events.clear();
+        m_events.Clear();
 }
 
 void EventProcessor::AddEvent(BasicEvent* event, Milliseconds e_time, bool set_addtime)
@@ -115,19 +108,14 @@ void EventProcessor::AddEvent(BasicEvent* event, Milliseconds e_time, bool set_a
     if (set_addtime)
         event->m_addTime = m_time;
     event->m_execTime = e_time.count();
-    m_events.insert(std::pair<uint64, BasicEvent*>(e_time.count(), event));
+    event->m_timerNode = m_events.Schedule(e_time.count(), event);
 }
 
 void EventProcessor::ModifyEventTime(BasicEvent* event, Milliseconds newTime)
 {
-    for (auto itr = m_events.begin(); itr != m_events.end(); ++itr)
-    {
-        if (itr->second != event)
-            continue;
+    if (!m_events.IsScheduled(event->m_timerNode, event))
+        return;
 
-        event->m_execTime = newTime.count();
-        m_events.erase(itr);
-        m_events.insert(std::pair<uint64, BasicEvent*>(newTime.count(), event));
-        break;
-    }
+    event->m_execTime = newTime.count();
+    m_events.Reschedule(event->m_timerNode, newTime.count());
 }
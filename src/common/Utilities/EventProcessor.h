@@ -22,7 +22,7 @@
 #include "Define.h"
 #include "Duration.h"
 #include "Random.h"
-#include <map>
+#include "TimerWheel.h"
 #include <type_traits>
 
 class EventProcessor;
@@ -42,7 +42,7 @@ class TC_COMMON_API BasicEvent
 
     public:
         BasicEvent()
-          : m_abortState(AbortState::STATE_RUNNING), m_addTime(0), m_execTime(0) { }
+          : m_abortState(AbortState::STATE_RUNNING), m_addTime(0), m_execTime(0), m_timerNode(TimerWheel<BasicEvent*>::INVALID_NODE) { }
 
         virtual ~BasicEvent() { }                           // override destructor to perform some actions on event removal
 
@@ -69,6 +69,8 @@ class TC_COMMON_API BasicEvent
         // these can be used for time offset control
         uint64 m_addTime;                                   // time when the event was added to queue, filled by event handler
         uint64 m_execTime;                                  // planned time of next execution, filled by event handler
+
+        TimerWheel<BasicEvent*>::NodeId m_timerNode;        // timer of the event in the queue of its event handler
 };
 
 template<typename T>
@@ -114,7 +116,7 @@ class TC_COMMON_API EventProcessor
 
     protected:
         uint64 m_time;
-        std::multimap<uint64, BasicEvent*> m_events;
+        TimerWheel<BasicEvent*> m_events;
 };
 
 #endif
@@ -21,6 +21,7 @@
 #include "Duration.h"
 #include "Optional.h"
 #include "Random.h"
+#include "TimerWheel.h"
 #include <algorithm>
 #include <chrono>
 #include <functional>
@@ -28,7 +29,6 @@
 #include <queue>
 #include <memory>
 #include <utility>
-#include <set>
 
 class TaskContext;
 
@@ -122,26 +122,23 @@ class TC_COMMON_API TaskScheduler
     typedef std::shared_ptr<Task> TaskContainer;
 
     /// Container which provides Task order, insert and reschedule operations.
-    struct Compare
-    {
-        bool operator() (TaskContainer const& left, TaskContainer const& right) const
-        {
-            return (*left.get()) < (*right.get());
-        };
-    };
-
+    /// Tasks are kept in a timer wheel with millisecond ticks counted from the creation of the scheduler.
     class TC_COMMON_API TaskQueue
     {
-        std::multiset<TaskContainer, Compare> container;
+        TimerWheel<TaskContainer> container;
+        timepoint_t origin;
+
+        uint64 GetTick(timepoint_t const& time) const;
 
     public:
+        explicit TaskQueue(timepoint_t const& origin_) : origin(origin_) { }
+
         // Pushes the task in the container
         void Push(TaskContainer&& task);
 
-        /// Pops the task out of the container
-        TaskContainer Pop();
-
-        TaskContainer const& First() const;
+        /// Pops the next task which is due at the given time,
+        /// returns an empty container if there is none.
+        TaskContainer PopDue(timepoint_t const& now);
 
         void Clear();
 
@@ -180,11 +177,11 @@ class TC_COMMON_API TaskScheduler
 
 public:
     TaskScheduler()
-        : self_reference(this, [](TaskScheduler const*) { }), _now(clock_t::now()), _predicate(EmptyValidator) { }
+        : self_reference(this, [](TaskScheduler const*) { }), _now(clock_t::now()), _task_holder(_now), _predicate(EmptyValidator) { }
 
     template<typename P>
     TaskScheduler(P&& predicate)
-        : self_reference(this, [](TaskScheduler const*) { }), _now(clock_t::now()), _predicate(std::forward<P>(predicate)) { }
+        : self_reference(this, [](TaskScheduler const*) { }), _now(clock_t::now()), _task_holder(_now), _predicate(std::forward<P>(predicate)) { }
 
     TaskScheduler(TaskScheduler const&) = delete;
     TaskScheduler(TaskScheduler&&) = delete;
@@ -376,7 +373,7 @@ private:
     TaskScheduler& ScheduleAt(timepoint_t const& end,
         std::chrono::duration<_Rep, _Period> const& time, task_handler_t const& task)
     {
-        return InsertTask(TaskContainer(new Task(end + time, time, task)));
+        return InsertTask(std::make_shared<Task>(end + time, time, task));
     }
 
     /// Schedule an event with a fixed rate.
@@ -387,7 +384,7 @@ private:
         group_t const group, task_handler_t const& task)
     {
         static repeated_t const DEFAULT_REPEATED = 0;
-        return InsertTask(TaskContainer(new Task(end + time, time, group, DEFAULT_REPEATED, task)));
+        return InsertTask(std::make_shared<Task>(end + time, time, group, DEFAULT_REPEATED, task));
     }
 
     /// Dispatch remaining tasks
@@ -0,0 +1,584 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITYCORE_TIMER_WHEEL_H
+#define TRINITYCORE_TIMER_WHEEL_H
+
+#include "Define.h"
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace Trinity
+{
+    inline uint32 CountTrailingZeros(uint64 value)
+    {
+#if defined(__GNUC__)
+        return uint32(__builtin_ctzll(value));
+#elif defined(_MSC_VER) && defined(_WIN64)
+        unsigned long index;
+        _BitScanForward64(&index, value);
+        return uint32(index);
+#else
+        uint32 count = 0;
+        while (!(value & 1))
+        {
+            value >>= 1;
+            ++count;
+        }
+        return count;
+#endif
+    }
+
+    inline uint32 PopCount(uint64 value)
+    {
+#if defined(__GNUC__)
+        return uint32(__builtin_popcountll(value));
+#else
+        uint32 count = 0;
+        for (; value; value &= value - 1)
+            ++count;
+        return count;
+#endif
+    }
+}
+
+/**
+    Timer queue for the event containers, time is measured in ticks (milliseconds for all users).
+
+    Most owners (a unit, a script) hold a handful of timers, these are kept in a list sorted by expiry.
+    Scheduling walks the list from its end, where new timers usually belong, and advancing only moves the clock.
+    Once more than SMALL_QUEUE_SIZE timers are scheduled the timers that are not yet due move into a hierarchical
+    timer wheel, which is allocated on demand. It moves back to the sorted list once at most half of that remain.
+
+    Level 0 of the wheel has one slot per tick, every further level has slots spanning a whole turn of the level below.
+    A timer is stored at the lowest level whose current turn contains its expiry and is moved down
+    when the current time reaches its slot. Timers beyond the top level wait in an overflow list
+    which is redistributed every time the top level completes a turn.
+
+    Schedule, Reschedule and Remove are O(1) while the wheel is used. Nodes are pooled, once the pool has grown
+    to the peak number of timers scheduling does not allocate.
+    Expired timers are handed out by PopDue ordered by expiry, timers with the same expiry in the order
+    they were (re)scheduled.
+*/
+template<class T>
+class TimerWheel
+{
+public:
+    typedef uint32 NodeId;
+    static constexpr NodeId INVALID_NODE = std::numeric_limits<NodeId>::max();
+
+    // number of timers above which the wheel is used
+    static constexpr uint32 SMALL_QUEUE_SIZE = 32;
+
+    TimerWheel() : _now(0), _sequence(0), _queueHead(INVALID_NODE), _queueTail(INVALID_NODE), _freeNodes(INVALID_NODE), _size(0) { }
+
+    TimerWheel(TimerWheel const& right) : _now(right._now), _sequence(right._sequence), _queueHead(right._queueHead), _queueTail(right._queueTail),
+        _freeNodes(right._freeNodes), _size(right._size), _nodes(right._nodes), _levels(right._levels ? new Levels(*right._levels) : nullptr) { }
+
+    TimerWheel(TimerWheel&& right) = default;
+
+    TimerWheel& operator=(TimerWheel const& right)
+    {
+        if (this != &right)
+            *this = TimerWheel(right);
+        return *this;
+    }
+
+    TimerWheel& operator=(TimerWheel&& right) = default;
+
+    uint64 GetNow() const { return _now; }
+    bool IsEmpty() const { return _size == 0; }
+    std::size_t GetSize() const { return _size; }
+
+    NodeId Schedule(uint64 expiry, T value)
+    {
+        NodeId id = _freeNodes;
+        if (id != INVALID_NODE)
+            _freeNodes = _nodes[id].Next;
+        else
+        {
+            id = NodeId(_nodes.size());
+            _nodes.emplace_back();
+        }
+
+        Node& node = _nodes[id];
+        node.Expiry = expiry;
+        node.Sequence = ++_sequence;
+        node.Value = std::move(value);
+        ++_size;
+        Link(id, _now);
+
+        if (!_levels && _size > SMALL_QUEUE_SIZE)
+            UseWheel();
+
+        return id;
+    }
+
+    void Reschedule(NodeId id, uint64 expiry)
+    {
+        Unlink(id);
+        _nodes[id].Expiry = expiry;
+        _nodes[id].Sequence = ++_sequence;
+        Link(id, _now);
+    }
+
+    T Remove(NodeId id)
+    {
+        Unlink(id);
+        return Release(id);
+    }
+
+    // true if the node is scheduled and holds the given value, for owners that keep node ids of values that might have expired
+    bool IsScheduled(NodeId id, T const& value) const
+    {
+        return id < _nodes.size() && _nodes[id].List != FREE_LIST && _nodes[id].Value == value;
+    }
+
+    uint64 GetExpiry(NodeId id) const { return _nodes[id].Expiry; }
+
+    // moves the current time forward, everything that expires until then is handed out by PopDue
+    void Advance(uint64 now)
+    {
+        // the sorted list needs no processing, neither does the wheel until the next slot with timers,
+        // this is the common case of advancing by one world tick
+        if (!_levels || now < _levels->NextProcessTime)
+            _now = std::max(_now, now);
+        else
+            AdvanceWheel(now);
+    }
+
+    // removes the next expired timer, timers scheduled at or before the current time are expired immediately
+    bool PopDue(T& value)
+    {
+        if (_queueHead == INVALID_NODE || _nodes[_queueHead].Expiry > _now)
+            return false;
+
+        NodeId id = _queueHead;
+        Unlink(id);
+        value = Release(id);
+        return true;
+    }
+
+    // removes the first expired timer matching predicate(T const& value), for owners whose values are due
+    // at a finer resolution than ticks, the predicate must not modify the wheel
+    template<class Predicate>
+    bool PopDue(T& value, Predicate&& predicate)
+    {
+        for (NodeId id = _queueHead; id != INVALID_NODE && _nodes[id].Expiry <= _now; id = _nodes[id].Next)
+        {
+            if (!predicate(_nodes[id].Value))
+                continue;
+
+            Unlink(id);
+            value = Release(id);
+            return true;
+        }
+
+        return false;
+    }
+
+    // removes every timer matching predicate(T const& value, uint64 expiry), the predicate must not modify the wheel
+    template<class Predicate>
+    std::size_t RemoveIf(Predicate&& predicate)
+    {
+        std::size_t removed = 0;
+        for (NodeId id = 0; id < _nodes.size(); ++id)
+        {
+            Node const& node = _nodes[id];
+            if (node.List == FREE_LIST || !predicate(node.Value, node.Expiry))
+                continue;
+
+            Remove(id);
+            ++removed;
+        }
+        return removed;
+    }
+
+    // lets modifier(T& value, uint64& expiry) change matching timers, returning true reschedules the timer at its new expiry
+    // timers are rescheduled in their previous order, the modifier must not modify the wheel
+    template<class Modifier>
+    void ModifyIf(Modifier&& modifier)
+    {
+        std::vector<std::pair<NodeId, uint64>> modified;
+        for (NodeId id = 0; id < _nodes.size(); ++id)
+        {
+            if (_nodes[id].List == FREE_LIST)
+                continue;
+
+            uint64 expiry = _nodes[id].Expiry;
+            if (modifier(_nodes[id].Value, expiry))
+                modified.emplace_back(id, expiry);
+        }
+
+        std::sort(modified.begin(), modified.end(), [this](std::pair<NodeId, uint64> const& left, std::pair<NodeId, uint64> const& right)
+        {
+            return IsBefore(left.first, right.first);
+        });
+
+        for (std::pair<NodeId, uint64> const& itr : modified)
+            Reschedule(itr.first, itr.second);
+    }
+
+    // calls visitor(NodeId) for every timer in order of expiry, the visitor may modify the wheel
+    // timers scheduled while visiting are not visited, timers removed while visiting are skipped
+    template<class Visitor>
+    void Visit(Visitor&& visitor)
+    {
+        std::vector<std::pair<NodeId, uint64>> order;
+        order.reserve(_size);
+        for (NodeId id = 0; id < _nodes.size(); ++id)
+            if (_nodes[id].List != FREE_LIST)
+                order.emplace_back(id, _nodes[id].Sequence);
+
+        std::sort(order.begin(), order.end(), [this](std::pair<NodeId, uint64> const& left, std::pair<NodeId, uint64> const& right)
+        {
+            return IsBefore(left.first, right.first);
+        });
+
+        for (std::pair<NodeId, uint64> const& itr : order)
+            if (_nodes[itr.first].List != FREE_LIST && _nodes[itr.first].Sequence == itr.second)
+                visitor(itr.first);
+    }
+
+    // returns the earliest timer matching predicate(T const& value), INVALID_NODE if there is none
+    template<class Predicate>
+    NodeId FindFirst(Predicate&& predicate) const
+    {
+        NodeId first = INVALID_NODE;
+        for (NodeId id = 0; id < _nodes.size(); ++id)
+            if (_nodes[id].List != FREE_LIST && (first == INVALID_NODE || IsBefore(id, first)) && predicate(_nodes[id].Value))
+                first = id;
+        return first;
+    }
+
+    T& GetValue(NodeId id) { return _nodes[id].Value; }
+
+    // true while the timers are kept in the wheel instead of the sorted list
+    bool IsUsingWheel() const { return _levels != nullptr; }
+
+    // removes all timers but keeps the node pool and the current time
+    void Clear()
+    {
+        for (Node& node : _nodes)
+            node.Value = T();
+
+        _freeNodes = INVALID_NODE;
+        for (NodeId id = NodeId(_nodes.size()); id > 0; --id)
+        {
+            _nodes[id - 1].List = FREE_LIST;
+            _nodes[id - 1].Next = _freeNodes;
+            _freeNodes = id - 1;
+        }
+
+        _levels.reset();
+        _queueHead = INVALID_NODE;
+        _queueTail = INVALID_NODE;
+        _size = 0;
+    }
+
+    void Reset()
+    {
+        Clear();
+        _now = 0;
+    }
+
+private:
+    enum : uint32
+    {
+        LEVEL_BITS      = 6,
+        LEVEL_COUNT     = 4,                                // 2^24 ticks, about 4.6 hours
+        SLOT_COUNT      = 1 << LEVEL_BITS,
+        SLOT_MASK       = SLOT_COUNT - 1,
+        WHEEL_BITS      = LEVEL_BITS * LEVEL_COUNT,
+
+        OVERFLOW_LIST   = LEVEL_COUNT * SLOT_COUNT,
+        QUEUE_LIST,
+        FREE_LIST
+    };
+
+    struct Node
+    {
+        Node() : Expiry(0), Sequence(0), Prev(INVALID_NODE), Next(INVALID_NODE), List(FREE_LIST), Value() { }
+
+        uint64 Expiry;
+        uint64 Sequence;
+        NodeId Prev;
+        NodeId Next;
+        uint32 List;
+        T Value;
+    };
+
+    // the wheel, only allocated while more than a handful of timers are scheduled
+    struct Levels
+    {
+        Levels() : NextProcessTime(std::numeric_limits<uint64>::max()), OverflowHead(INVALID_NODE), SlotMasks() { }
+
+        uint64 NextProcessTime;                             // lower bound of the next GetNextProcessTime, removing timers does not raise it
+        NodeId OverflowHead;
+        uint64 SlotMasks[LEVEL_COUNT];                      // occupied slots per level
+        std::vector<NodeId> SlotHeads;
+    };
+
+    bool IsBefore(NodeId left, NodeId right) const
+    {
+        Node const& l = _nodes[left];
+        Node const& r = _nodes[right];
+        return l.Expiry < r.Expiry || (l.Expiry == r.Expiry && l.Sequence < r.Sequence);
+    }
+
+    T Release(NodeId id)
+    {
+        Node& node = _nodes[id];
+        T value = std::move(node.Value);
+        node.Value = T();
+        node.List = FREE_LIST;
+        node.Next = _freeNodes;
+        _freeNodes = id;
+        --_size;
+        return value;
+    }
+
+    // processes every slot of the wheel that is due until now
+    void AdvanceWheel(uint64 now)
+    {
+        while (_now < now)
+        {
+            _now = GetNextProcessTime(now);
+
+            if (_levels->OverflowHead != INVALID_NODE && !(_now & ((uint64(1) << WHEEL_BITS) - 1)))
+                Cascade(OVERFLOW_LIST, now);
+
+            for (uint32 level = LEVEL_COUNT; level-- > 0;)
+            {
+                if (_now & ((uint64(1) << (level * LEVEL_BITS)) - 1))
+                    continue;
+
+                uint32 slot = uint32(_now >> (level * LEVEL_BITS)) & SLOT_MASK;
+                if (_levels->SlotMasks[level] & (uint64(1) << slot))
+                    Cascade(level * SLOT_COUNT + slot, now);
+            }
+        }
+
+        _levels->NextProcessTime = GetNextProcessTime(std::numeric_limits<uint64>::max());
+
+        if (_size <= SMALL_QUEUE_SIZE / 2)
+            UseSortedList();
+    }
+
+    // moves the timers that are not yet due from the sorted list into the wheel
+    void UseWheel()
+    {
+        _levels.reset(new Levels());
+        while (_queueTail != INVALID_NODE && _nodes[_queueTail].Expiry > _now)
+        {
+            NodeId id = _queueTail;
+            Unlink(id);
+            Link(id, _now);
+        }
+    }
+
+    // moves all timers of the wheel back into the sorted list
+    void UseSortedList()
+    {
+        std::vector<NodeId> pending;
+        for (NodeId id = 0; id < _nodes.size(); ++id)
+            if (_nodes[id].List < QUEUE_LIST)
+                pending.push_back(id);
+
+        std::sort(pending.begin(), pending.end(), [this](NodeId left, NodeId right) { return IsBefore(left, right); });
+
+        _levels.reset();
+        // every pending timer expires after the ones in the list, each of them is appended
+        for (NodeId id : pending)
+            LinkSorted(id);
+    }
+
+    // nodes expiring until dueTime and all nodes while the wheel is not used are kept in the sorted list,
+    // so it does not matter that cascading slots can expire nodes out of order while advancing
+    void Link(NodeId id, uint64 dueTime)
+    {
+        Node& node = _nodes[id];
+        if (!_levels || node.Expiry <= dueTime)
+        {
+            LinkSorted(id);
+            return;
+        }
+
+        uint64 diff = node.Expiry ^ _now;
+        for (uint32 level = 0; level < LEVEL_COUNT; ++level)
+        {
+            if (diff >> ((level + 1) * LEVEL_BITS))
+                continue;
+
+            uint32 slot = uint32(node.Expiry >> (level * LEVEL_BITS)) & SLOT_MASK;
+            _levels->NextProcessTime = std::min(_levels->NextProcessTime, (node.Expiry >> (level * LEVEL_BITS)) << (level * LEVEL_BITS));
+            PushFront(level * SLOT_COUNT + slot, id);
+            return;
+        }
+
+        _levels->NextProcessTime = std::min(_levels->NextProcessTime, ((_now >> WHEEL_BITS) + 1) << WHEEL_BITS);
+        PushFront(OVERFLOW_LIST, id);
+    }
+
+    // slot heads are stored ordered by level and slot, only for slots set in SlotMasks
+    uint32 GetSlotHeadIndex(uint32 list) const
+    {
+        uint32 level = list / SLOT_COUNT;
+        uint32 index = Trinity::PopCount(_levels->SlotMasks[level] & ((uint64(1) << (list & SLOT_MASK)) - 1));
+        for (uint32 i = 0; i < level; ++i)
+            index += Trinity::PopCount(_levels->SlotMasks[i]);
+        return index;
+    }
+
+    void PushFront(uint32 list, NodeId id)
+    {
+        Node& node = _nodes[id];
+        node.List = list;
+        node.Prev = INVALID_NODE;
+
+        NodeId* head = &_levels->OverflowHead;
+        if (list != OVERFLOW_LIST)
+        {
+            uint64 const slotBit = uint64(1) << (list & SLOT_MASK);
+            uint32 const index = GetSlotHeadIndex(list);
+            if (!(_levels->SlotMasks[list / SLOT_COUNT] & slotBit))
+            {
+                _levels->SlotMasks[list / SLOT_COUNT] |= slotBit;
+                _levels->SlotHeads.insert(_levels->SlotHeads.begin() + index, INVALID_NODE);
+            }
+            head = &_levels->SlotHeads[index];
+        }
+
+        node.Next = *head;
+        if (node.Next != INVALID_NODE)
+            _nodes[node.Next].Prev = id;
+        *head = id;
+    }
+
+    // detaches the whole list, returns its first node
+    NodeId TakeList(uint32 list)
+    {
+        NodeId head = _levels->OverflowHead;
+        if (list == OVERFLOW_LIST)
+            _levels->OverflowHead = INVALID_NODE;
+        else
+        {
+            uint32 const index = GetSlotHeadIndex(list);
+            head = _levels->SlotHeads[index];
+            _levels->SlotHeads.erase(_levels->SlotHeads.begin() + index);
+            _levels->SlotMasks[list / SLOT_COUNT] &= ~(uint64(1) << (list & SLOT_MASK));
+        }
+        return head;
+    }
+
+    // new nodes usually belong at the end of the sorted list
+    void LinkSorted(NodeId id)
+    {
+        NodeId prev = _queueTail;
+        while (prev != INVALID_NODE && IsBefore(id, prev))
+            prev = _nodes[prev].Prev;
+
+        Node& node = _nodes[id];
+        node.List = QUEUE_LIST;
+        node.Prev = prev;
+        node.Next = prev != INVALID_NODE ? _nodes[prev].Next : _queueHead;
+
+        if (node.Next != INVALID_NODE)
+            _nodes[node.Next].Prev = id;
+        else
+            _queueTail = id;
+
+        if (prev != INVALID_NODE)
+            _nodes[prev].Next = id;
+        else
+            _queueHead = id;
+    }
+
+    void Unlink(NodeId id)
+    {
+        Node& node = _nodes[id];
+        if (node.List == QUEUE_LIST)
+        {
+            (node.Prev != INVALID_NODE ? _nodes[node.Prev].Next : _queueHead) = node.Next;
+            (node.Next != INVALID_NODE ? _nodes[node.Next].Prev : _queueTail) = node.Prev;
+            return;
+        }
+
+        if (node.Next != INVALID_NODE)
+            _nodes[node.Next].Prev = node.Prev;
+
+        if (node.Prev != INVALID_NODE)
+            _nodes[node.Prev].Next = node.Next;
+        else if (node.List == OVERFLOW_LIST)
+            _levels->OverflowHead = node.Next;
+        else if (node.Next != INVALID_NODE)
+            _levels->SlotHeads[GetSlotHeadIndex(node.List)] = node.Next;
+        else
+            TakeList(node.List);
+    }
+
+    // relinks every node of the list relative to the current time
+    void Cascade(uint32 list, uint64 dueTime)
+    {
+        NodeId id = TakeList(list);
+        while (id != INVALID_NODE)
+        {
+            NodeId next = _nodes[id].Next;
+            Link(id, dueTime);
+            id = next;
+        }
+    }
+
+    // earliest time after _now at which a slot must be processed, capped at now
+    uint64 GetNextProcessTime(uint64 now) const
+    {
+        for (uint32 level = 0; level < LEVEL_COUNT; ++level)
+        {
+            uint32 shift = level * LEVEL_BITS;
+            uint32 current = uint32(_now >> shift) & SLOT_MASK;
+            uint64 pending = current == SLOT_MASK ? 0 : _levels->SlotMasks[level] & (~uint64(0) << (current + 1));
+            if (!pending)
+                continue;
+
+            uint64 turnStart = (_now >> (shift + LEVEL_BITS)) << (shift + LEVEL_BITS);
+            return std::min(turnStart | (uint64(Trinity::CountTrailingZeros(pending)) << shift), now);
+        }
+
+        if (_levels->OverflowHead != INVALID_NODE)
+            return std::min(((_now >> WHEEL_BITS) + 1) << WHEEL_BITS, now);
+
+        return now;
+    }
+
+    uint64 _now;
+    uint64 _sequence;
+    NodeId _queueHead;                                      // sorted list of all timers, or of the expired ones while the wheel is used
+    NodeId _queueTail;
+    NodeId _freeNodes;
+    uint32 _size;
+    std::vector<Node> _nodes;
+    std::unique_ptr<Levels> _levels;
+};
+
+#endif // TRINITYCORE_TIMER_WHEEL_H
@@ -60,6 +60,7 @@ SmartScript::SmartScript()
     mEventSortingRequired = false;
     mNestedEventsCounter = 0;
     mAllEventFlags = 0;
+    mEventIndexOffsets.fill(0);
 }
 
 SmartScript::~SmartScript()
@@ -235,17 +236,13 @@ void SmartScript::ProcessEventsFor(SMART_EVENT e, Unit* unit, uint32 var0, uint3
     {
         TC_LOG_WARN("scripts.ai", "SmartScript::ProcessEventsFor: reached the limit of max allowed nested ProcessEventsFor() calls with event %u, skipping!\n%s", e, GetBaseObject()->GetDebugInfo().c_str());
     }
-    else
+    else if (e != SMART_EVENT_LINK && e < SMART_EVENT_END) // links are only processed by the event they are linked from
     {
-        for (SmartScriptHolder& event : mEvents)
+        for (uint32 i = mEventIndexOffsets[e]; i < mEventIndexOffsets[e + 1]; ++i)
         {
-            SMART_EVENT eventType = SMART_EVENT(event.GetEventType());
-            if (eventType == SMART_EVENT_LINK)//special handling
-                continue;
-
-            if (eventType == e)
-                if (sConditionMgr->IsObjectMeetingSmartEventConditions(event.entryOrGuid, event.event_id, event.source_type, unit, GetBaseObject()))
-                    ProcessEvent(event, unit, var0, var1, bvar, spell, gob);
+            SmartScriptHolder& event = mEvents[mEventIndexes[i]];
+            if (IsMeetingConditions(event, unit))
+                ProcessEvent(event, unit, var0, var1, bvar, spell, gob);
         }
     }
 
@@ -273,8 +270,27 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
         TC_LOG_DEBUG("scripts.ai", "SmartScript::ProcessAction: Invoker: %s %s", tempInvoker->GetName().c_str(), tempInvoker->GetGUID().ToString().c_str());
 
     ObjectVector targets;
-    GetTargets(targets, e, Coalesce<WorldObject>(unit, gob));
+    if (e.compiled.TargetSelector)
+        e.compiled.TargetSelector(*this, e, targets, Coalesce<WorldObject>(unit, gob));
+    else if (e.compiled.UsesTargets)
+        GetTargets(targets, e, Coalesce<WorldObject>(unit, gob));
+
+    bool processLinks = e.compiled.Handler ? e.compiled.Handler(*this, e, targets, unit) : InterpretAction(e, targets, unit);
+    if (!processLinks)
+        return;
+
+    if (e.link && e.link != e.event_id)
+    {
+        SmartScriptHolder& linked = SmartAIMgr::FindLinkedEvent(mEvents, e.link);
+        if (linked)
+            ProcessEvent(linked, unit, var0, var1, bvar, spell, gob);
+        else
+            TC_LOG_DEBUG("sql.sql", "SmartScript::ProcessAction: Entry %d SourceType %u, Event %u, Link Event %u not found or invalid, skipped.", e.entryOrGuid, e.GetScriptType(), e.event_id, e.link);
+    }
+}
 
+bool SmartScript::InterpretAction(SmartScriptHolder& e, ObjectVector& targets, Unit* unit)
+{
     switch (e.GetActionType())
     {
         case SMART_ACTION_TALK:
@@ -616,7 +632,7 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
             {
                 RetryLater(e, true);
                 // Don't execute linked events
-                return;
+                return false;
             }
             break;
         }
@@ -756,26 +772,9 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
             break;
         }
         case SMART_ACTION_SET_EVENT_PHASE:
-        {
-            if (!GetBaseObject())
-                break;
-
-            SetPhase(e.action.setEventPhase.phase);
-            TC_LOG_DEBUG("scripts.ai", "SmartScript::ProcessAction:: SMART_ACTION_SET_EVENT_PHASE: Creature %s set event phase %u",
-                GetBaseObject()->GetGUID().ToString().c_str(), e.action.setEventPhase.phase);
-            break;
-        }
+            return ProcessSetEventPhaseAction(e, targets, unit);
         case SMART_ACTION_INC_EVENT_PHASE:
-        {
-            if (!GetBaseObject())
-                break;
-
-            IncPhase(e.action.incEventPhase.inc);
-            DecPhase(e.action.incEventPhase.dec);
-            TC_LOG_DEBUG("scripts.ai", "SmartScript::ProcessAction:: SMART_ACTION_INC_EVENT_PHASE: Creature %s inc event phase by %u, "
-                "decrease by %u", GetBaseObject()->GetGUID().ToString().c_str(), e.action.incEventPhase.inc, e.action.incEventPhase.dec);
-            break;
-        }
+            return ProcessIncEventPhaseAction(e, targets, unit);
         case SMART_ACTION_EVADE:
         {
             if (!me)
@@ -2333,20 +2332,234 @@ void SmartScript::ProcessAction(SmartScriptHolder& e, Unit* unit, uint32 var0, u
             break;
     }
 
-    if (e.link && e.link != e.event_id)
+    return true;
+}
+
+bool SmartScript::ProcessCastAction(SmartScriptHolder& e, ObjectVector& targets, Unit* /*unit*/)
+{
+    if (targets.empty() || !e.compiled.Spell)
+        return true;
+
+    if (e.action.cast.targetsLimit > 0 && targets.size() > e.action.cast.targetsLimit)
+        Trinity::Containers::RandomResize(targets, e.action.cast.targetsLimit);
+
+    bool failedSpellCast = false, successfulSpellCast = false;
+
+    for (WorldObject* target : targets)
     {
-        SmartScriptHolder& linked = SmartAIMgr::FindLinkedEvent(mEvents, e.link);
-        if (linked)
-            ProcessEvent(linked, unit, var0, var1, bvar, spell, gob);
+        // may be nullptr
+        if (go)
+            go->CastSpell(target->ToUnit(), e.compiled.Spell);
+
+        if (!IsUnit(target))
+            continue;
+
+        if (!(e.action.cast.castFlags & SMARTCAST_AURA_NOT_PRESENT) || !target->ToUnit()->HasAura(e.action.cast.spell))
+        {
+            TriggerCastFlags triggerFlag = TriggerCastFlags(e.compiled.TriggerFlags);
+
+            if (me)
+            {
+                if (e.action.cast.castFlags & SMARTCAST_INTERRUPT_PREVIOUS)
+                    me->InterruptNonMeleeSpells(false);
+
+                SpellCastResult result = me->CastSpell(target->ToUnit(), e.compiled.Spell, triggerFlag);
+                bool spellCastFailed = (result != SPELL_CAST_OK && result != SPELL_FAILED_SPELL_IN_PROGRESS);
+
+                if (e.action.cast.castFlags & SMARTCAST_COMBAT_MOVE)
+                {
+                    // If cast flag SMARTCAST_COMBAT_MOVE is set combat movement will not be allowed unless target is outside spell range, out of mana, or LOS.
+                    ENSURE_AI(SmartAI, me->AI())->SetCombatMove(spellCastFailed, true);
+                }
+
+                if (spellCastFailed)
+                    failedSpellCast = true;
+                else
+                    successfulSpellCast = true;
+            }
+            else if (go)
+                go->CastSpell(target->ToUnit(), e.compiled.Spell, triggerFlag);
+
+            TC_LOG_DEBUG("scripts.ai", "SmartScript::ProcessAction:: SMART_ACTION_CAST:: %s casts spell %u on target %s with castflags %u",
+                me ? me->GetGUID().ToString().c_str() : go->GetGUID().ToString().c_str(), e.action.cast.spell, target->GetGUID().ToString().c_str(), e.action.cast.castFlags);
+        }
         else
-            TC_LOG_DEBUG("sql.sql", "SmartScript::ProcessAction: Entry %d SourceType %u, Event %u, Link Event %u not found or invalid, skipped.", e.entryOrGuid, e.GetScriptType(), e.event_id, e.link);
+            TC_LOG_DEBUG("scripts.ai", "Spell %u not cast because it has flag SMARTCAST_AURA_NOT_PRESENT and the target (%s) already has the aura", e.action.cast.spell, target->GetGUID().ToString().c_str());
+    }
+
+    // If there is at least 1 failed cast and no successful casts at all, retry again on next loop
+    if (failedSpellCast && !successfulSpellCast)
+    {
+        RetryLater(e, true);
+        // Don't execute linked events
+        return false;
+    }
+
+    return true;
+}
+
+bool SmartScript::ProcessSelfCastAction(SmartScriptHolder& e, ObjectVector& targets, Unit* /*unit*/)
+{
+    if (targets.empty() || !e.compiled.Spell)
+        return true;
+
+    if (e.action.cast.targetsLimit)
+        Trinity::Containers::RandomResize(targets, e.action.cast.targetsLimit);
+
+    TriggerCastFlags triggerFlags = TriggerCastFlags(e.compiled.TriggerFlags);
+
+    for (WorldObject* target : targets)
+    {
+        Unit* uTarget = target->ToUnit();
+        if (!uTarget)
+            continue;
+
+        if (!(e.action.cast.castFlags & SMARTCAST_AURA_NOT_PRESENT) || !uTarget->HasAura(e.action.cast.spell))
+        {
+            if (e.action.cast.castFlags & SMARTCAST_INTERRUPT_PREVIOUS)
+                uTarget->InterruptNonMeleeSpells(false);
+
+            uTarget->CastSpell(uTarget, e.compiled.Spell, triggerFlags);
+        }
+    }
+
+    return true;
+}
+
+bool SmartScript::ProcessInvokerCastAction(SmartScriptHolder& e, ObjectVector& targets, Unit* unit)
+{
+    Unit* tempLastInvoker = GetLastInvoker(unit);
+    if (!tempLastInvoker)
+        return true;
+
+    if (targets.empty() || !e.compiled.Spell)
+        return true;
+
+    if (e.action.cast.targetsLimit)
+        Trinity::Containers::RandomResize(targets, e.action.cast.targetsLimit);
+
+    for (WorldObject* target : targets)
+    {
+        if (!IsUnit(target))
+            continue;
+
+        if (!(e.action.cast.castFlags & SMARTCAST_AURA_NOT_PRESENT) || !target->ToUnit()->HasAura(e.action.cast.spell))
+        {
+            if (e.action.cast.castFlags & SMARTCAST_INTERRUPT_PREVIOUS)
+                tempLastInvoker->InterruptNonMeleeSpells(false);
+
+            TriggerCastFlags triggerFlag = TriggerCastFlags(e.compiled.TriggerFlags);
+            tempLastInvoker->CastSpell(target->ToUnit(), e.compiled.Spell, triggerFlag);
+            TC_LOG_DEBUG("scripts.ai", "SmartScript::ProcessAction:: SMART_ACTION_INVOKER_CAST: Invoker %s casts spell %u on target %s with castflags %u",
+                tempLastInvoker->GetGUID().ToString().c_str(), e.action.cast.spell, target->GetGUID().ToString().c_str(), e.action.cast.castFlags);
+        }
+        else
+            TC_LOG_DEBUG("scripts.ai", "Spell %u not cast because it has flag SMARTCAST_AURA_NOT_PRESENT and the target (%s) already has the aura", e.action.cast.spell, target->GetGUID().ToString().c_str());
+    }
+
+    return true;
+}
+
+bool SmartScript::ProcessSetEventPhaseAction(SmartScriptHolder& e, ObjectVector& /*targets*/, Unit* /*unit*/)
+{
+    if (!GetBaseObject())
+        return true;
+
+    SetPhase(e.action.setEventPhase.phase);
+    TC_LOG_DEBUG("scripts.ai", "SmartScript::ProcessAction:: SMART_ACTION_SET_EVENT_PHASE: Creature %s set event phase %u",
+        GetBaseObject()->GetGUID().ToString().c_str(), e.action.setEventPhase.phase);
+    return true;
+}
+
+bool SmartScript::ProcessIncEventPhaseAction(SmartScriptHolder& e, ObjectVector& /*targets*/, Unit* /*unit*/)
+{
+    if (!GetBaseObject())
+        return true;
+
+    IncPhase(e.action.incEventPhase.inc);
+    DecPhase(e.action.incEventPhase.dec);
+    TC_LOG_DEBUG("scripts.ai", "SmartScript::ProcessAction:: SMART_ACTION_INC_EVENT_PHASE: Creature %s inc event phase by %u, "
+        "decrease by %u", GetBaseObject()->GetGUID().ToString().c_str(), e.action.incEventPhase.inc, e.action.incEventPhase.dec);
+    return true;
+}
+
+void SmartScript::CompileAction(SmartScriptHolder& e)
+{
+    SmartCompiledAction& compiled = e.compiled;
+    compiled = SmartCompiledAction();
+
+    switch (e.GetActionType())
+    {
+        case SMART_ACTION_CAST:
+            compiled.Handler = &CallCompiledAction<&SmartScript::ProcessCastAction>;
+            break;
+        case SMART_ACTION_SELF_CAST:
+            compiled.Handler = &CallCompiledAction<&SmartScript::ProcessSelfCastAction>;
+            break;
+        case SMART_ACTION_INVOKER_CAST:
+            compiled.Handler = &CallCompiledAction<&SmartScript::ProcessInvokerCastAction>;
+            break;
+        case SMART_ACTION_SET_EVENT_PHASE:
+            compiled.Handler = &CallCompiledAction<&SmartScript::ProcessSetEventPhaseAction>;
+            compiled.UsesTargets = false;
+            break;
+        case SMART_ACTION_INC_EVENT_PHASE:
+            compiled.Handler = &CallCompiledAction<&SmartScript::ProcessIncEventPhaseAction>;
+            compiled.UsesTargets = false;
+            break;
+        default:
+            break;
+    }
+
+    switch (e.GetActionType())
+    {
+        case SMART_ACTION_CAST:
+        case SMART_ACTION_SELF_CAST:
+        case SMART_ACTION_INVOKER_CAST:
+            compiled.Spell = sSpellMgr->GetSpellInfo(e.action.cast.spell);
+            if (!compiled.Spell)
+            {
+                // the compiled handlers cast the resolved spell, anything else is left to the interpreter which casts by id
+                TC_LOG_ERROR("sql.sql", "SmartScript::CompileAction: Entry %d SourceType %u Event %u Action %u uses non-existent spell %u, it is not compiled.",
+                    e.entryOrGuid, e.GetScriptType(), e.event_id, e.GetActionType(), e.action.cast.spell);
+                compiled.Handler = nullptr;
+            }
+
+            if (e.action.cast.castFlags & SMARTCAST_TRIGGERED)
+                compiled.TriggerFlags = e.action.cast.triggerFlags ? e.action.cast.triggerFlags : uint32(TRIGGERED_FULL_MASK);
+            break;
+        default:
+            break;
+    }
+
+    if (!compiled.UsesTargets)
+        return;
+
+    // the most common target types, these neither search the grid nor look up the last invoker unless they need it
+    switch (e.GetTargetType())
+    {
+        case SMART_TARGET_SELF:
+            compiled.TargetSelector = &CallCompiledTargetSelector<&SmartScript::GetSelfTargets>;
+            break;
+        case SMART_TARGET_VICTIM:
+            compiled.TargetSelector = &CallCompiledTargetSelector<&SmartScript::GetVictimTargets>;
+            break;
+        case SMART_TARGET_ACTION_INVOKER:
+            compiled.TargetSelector = &CallCompiledTargetSelector<&SmartScript::GetActionInvokerTargets>;
+            break;
+        case SMART_TARGET_NONE:
+        case SMART_TARGET_POSITION:
+            compiled.UsesTargets = false;
+            break;
+        default:
+            break;
     }
 }
 
 void SmartScript::ProcessTimedAction(SmartScriptHolder& e, uint32 const& min, uint32 const& max, Unit* unit, uint32 var0, uint32 var1, bool bvar, SpellInfo const* spell, GameObject* gob)
 {
     // We may want to execute action rarely and because of this if condition is not fulfilled the action will be rechecked in a long time
-    if (sConditionMgr->IsObjectMeetingSmartEventConditions(e.entryOrGuid, e.event_id, e.source_type, unit, GetBaseObject()))
+    if (IsMeetingConditions(e, unit))
     {
         RecalcTimer(e, min, max);
         ProcessAction(e, unit, var0, var1, bvar, spell, gob);
@@ -2384,9 +2597,91 @@ SmartScriptHolder SmartScript::CreateSmartEvent(SMART_EVENT e, uint32 event_flag
 
     script.source_type = SMART_SCRIPT_TYPE_CREATURE;
     InitTimer(script);
+    CompileAction(script);
     return script;
 }
 
+SmartActionBenchmark SmartScript::BenchmarkActions(SmartAIEventList const& events, Unit* invoker, uint32 iterations)
+{
+    using namespace std::chrono;
+
+    SmartActionBenchmark benchmark;
+    benchmark.Actions = uint32(events.size());
+
+    SmartAIEventList interpreted = events;
+    for (SmartScriptHolder& e : interpreted)
+        e.compiled = SmartCompiledAction();
+
+    ObjectVector targets;
+    steady_clock::time_point start = steady_clock::now();
+    for (uint32 i = 0; i < iterations; ++i)
+    {
+        for (SmartScriptHolder const& e : interpreted)
+        {
+            targets.clear();
+            GetTargets(targets, e, invoker);
+        }
+    }
+    benchmark.InterpretedTargetTime = steady_clock::now() - start;
+
+    start = steady_clock::now();
+    for (uint32 i = 0; i < iterations; ++i)
+    {
+        for (SmartScriptHolder const& e : events)
+        {
+            targets.clear();
+            if (e.compiled.TargetSelector)
+                e.compiled.TargetSelector(*this, e, targets, invoker);
+            else if (e.compiled.UsesTargets)
+                GetTargets(targets, e, invoker);
+        }
+    }
+    benchmark.CompiledTargetTime = steady_clock::now() - start;
+
+    // only actions with a handler are dispatched differently, they get no targets so nothing happens to the world
+    SmartAIEventList compiledDispatch;
+    SmartAIEventList interpretedDispatch;
+    for (SmartScriptHolder const& e : events)
+    {
+        if (!e.compiled.Handler)
+            continue;
+
+        compiledDispatch.push_back(e);
+        interpretedDispatch.push_back(e);
+        interpretedDispatch.back().compiled = SmartCompiledAction();
+    }
+
+    benchmark.CompiledActions = uint32(compiledDispatch.size());
+
+    // phase actions change the phase of this script
+    uint32 phase = mEventPhase;
+
+    start = steady_clock::now();
+    for (uint32 i = 0; i < iterations; ++i)
+    {
+        for (SmartScriptHolder& e : interpretedDispatch)
+        {
+            targets.clear();
+            InterpretAction(e, targets, invoker);
+        }
+    }
+    benchmark.InterpretedDispatchTime = steady_clock::now() - start;
+
+    start = steady_clock::now();
+    for (uint32 i = 0; i < iterations; ++i)
+    {
+        for (SmartScriptHolder& e : compiledDispatch)
+        {
+            targets.clear();
+            e.compiled.Handler(*this, e, targets, invoker);
+        }
+    }
+    benchmark.CompiledDispatchTime = steady_clock::now() - start;
+
+    SetPhase(phase);
+    return benchmark;
+}
+
 void SmartScript::GetTargets(ObjectVector& targets, SmartScriptHolder const& e, WorldObject* invoker /*= nullptr*/) const
 {
     WorldObject* scriptTrigger = nullptr;
@@ -2399,13 +2694,10 @@ void SmartScript::GetTargets(ObjectVector& targets, SmartScriptHolder const& e,
     switch (e.GetTargetType())
     {
         case SMART_TARGET_SELF:
-            if (baseObject)
-                targets.push_back(baseObject);
+            GetSelfTargets(targets, e, invoker);
             break;
         case SMART_TARGET_VICTIM:
-            if (me)
-                if (Unit* victim = me->GetVictim())
-                    targets.push_back(victim);
+            GetVictimTargets(targets, e, invoker);
             break;
         case SMART_TARGET_HOSTILE_SECOND_AGGRO:
             if (me)
@@ -2463,8 +2755,7 @@ void SmartScript::GetTargets(ObjectVector& targets, SmartScriptHolder const& e,
             }
             break;
         case SMART_TARGET_ACTION_INVOKER:
-            if (scriptTrigger)
-                targets.push_back(scriptTrigger);
+            GetActionInvokerTargets(targets, e, invoker);
             break;
         case SMART_TARGET_ACTION_INVOKER_VEHICLE:
             if (scriptTrigger && scriptTrigger->ToUnit() && scriptTrigger->ToUnit()->GetVehicle() && scriptTrigger->ToUnit()->GetVehicle()->GetBase())
@@ -2748,6 +3039,27 @@ void SmartScript::GetTargets(ObjectVector& targets, SmartScriptHolder const& e,
     }
 }
 
+void SmartScript::GetSelfTargets(ObjectVector& targets, SmartScriptHolder const& /*e*/, WorldObject* /*invoker*/) const
+{
+    if (WorldObject* baseObject = GetBaseObjectOrPlayerTrigger())
+        targets.push_back(baseObject);
+}
+
+void SmartScript::GetVictimTargets(ObjectVector& targets, SmartScriptHolder const& /*e*/, WorldObject* /*invoker*/) const
+{
+    if (me)
+        if (Unit* victim = me->GetVictim())
+            targets.push_back(victim);
+}
+
+void SmartScript::GetActionInvokerTargets(ObjectVector& targets, SmartScriptHolder const& /*e*/, WorldObject* invoker) const
+{
+    if (invoker)
+        targets.push_back(invoker);
+    else if (Unit* tempLastInvoker = GetLastInvoker())
+        targets.push_back(tempLastInvoker);
+}
+
 void SmartScript::GetWorldObjectsInDist(ObjectVector& targets, float dist) const
 {
     WorldObject* obj = GetBaseObjectOrPlayerTrigger();
@@ -3443,9 +3755,13 @@ void SmartScript::InstallEvents()
     if (!mInstallEvents.empty())
     {
         for (SmartScriptHolder& installevent : mInstallEvents)
+        {
+            ResolveConditions(installevent);
             mEvents.push_back(installevent);//must be before UpdateTimers
+        }
 
         mInstallEvents.clear();
+        BuildEventIndex();
     }
 }
 
@@ -3541,6 +3857,7 @@ void SmartScript::OnUpdate(uint32 const diff)
     if (mEventSortingRequired)
     {
         SortEvents(mEvents);
+        BuildEventIndex();
         mEventSortingRequired = false;
     }
 
@@ -3603,6 +3920,43 @@ void SmartScript::SortEvents(SmartAIEventList& events)
     std::sort(events.begin(), events.end());
 }
 
+void SmartScript::BuildEventIndex()
+{
+    mEventIndexOffsets.fill(0);
+    for (SmartScriptHolder const& event : mEvents)
+        if (event.GetEventType() < SMART_EVENT_END)
+            ++mEventIndexOffsets[event.GetEventType() + 1];
+
+    for (uint32 i = 1; i < mEventIndexOffsets.size(); ++i)
+        mEventIndexOffsets[i] += mEventIndexOffsets[i - 1];
+
+    // stable counting sort, events of the same type keep their order in mEvents
+    std::array<uint32, SMART_EVENT_END> next;
+    std::copy_n(mEventIndexOffsets.begin(), next.size(), next.begin());
+    mEventIndexes.resize(mEventIndexOffsets.back());
+    for (uint32 i = 0; i < mEvents.size(); ++i)
+        if (mEvents[i].GetEventType() < SMART_EVENT_END)
+            mEventIndexes[next[mEvents[i].GetEventType()]++] = i;
+}
+
+bool SmartScript::IsMeetingConditions(SmartScriptHolder& e, Unit* unit)
+{
+    if (e.conditionsLoadCount != sConditionMgr->GetLoadCount())
+        ResolveConditions(e);
+
+    if (!e.conditions)
+        return true;
+
+    ConditionSourceInfo sourceInfo(unit, GetBaseObject());
+    return sConditionMgr->IsObjectMeetToConditions(sourceInfo, *e.conditions);
+}
+
+void SmartScript::ResolveConditions(SmartScriptHolder& e)
+{
+    e.conditions = sConditionMgr->GetConditionsForSmartEvent(e.entryOrGuid, e.event_id, e.source_type);
+    e.conditionsLoadCount = sConditionMgr->GetLoadCount();
+}
+
 void SmartScript::RaisePriority(SmartScriptHolder& e)
 {
     e.timer = 1;
@@ -3651,8 +4005,11 @@ void SmartScript::FillScript(SmartAIEventList e, WorldObject* obj, AreaTriggerEn
                 continue;
         }
         mAllEventFlags |= scriptholder.event.event_flags;
+        ResolveConditions(scriptholder);
         mEvents.push_back(scriptholder);//NOTE: 'world(0)' events still get processed in ANY instance mode
     }
+
+    BuildEventIndex();
 }
 
 void SmartScript::GetScript()
@@ -3824,6 +4181,7 @@ void SmartScript::SetTimedActionList(SmartScriptHolder& e, uint32 entry, Unit* i
             i->event.type = SMART_EVENT_UPDATE;
 
         InitTimer((*i));
+        ResolveConditions(*i);
     }
 }
 
@@ -20,6 +20,8 @@
 
 #include "Define.h"
 #include "SmartScriptMgr.h"
+#include <array>
+#include <chrono>
 
 class Creature;
 class GameObject;
@@ -29,6 +31,17 @@ class Unit;
 class WorldObject;
 struct AreaTriggerEntry;
 
+// time spent by SmartScript::BenchmarkActions on a list of actions, once through the interpreter and once compiled
+struct SmartActionBenchmark
+{
+    uint32 Actions = 0;
+    uint32 CompiledActions = 0;
+    std::chrono::nanoseconds InterpretedTargetTime = std::chrono::nanoseconds::zero();
+    std::chrono::nanoseconds CompiledTargetTime = std::chrono::nanoseconds::zero();
+    std::chrono::nanoseconds InterpretedDispatchTime = std::chrono::nanoseconds::zero();
+    std::chrono::nanoseconds CompiledDispatchTime = std::chrono::nanoseconds::zero();
+};
+
 class TC_GAME_API SmartScript
 {
     public:
@@ -49,6 +62,10 @@ class TC_GAME_API SmartScript
         void ProcessTimedAction(SmartScriptHolder& e, uint32 const& min, uint32 const& max, Unit* unit = nullptr, uint32 var0 = 0, uint32 var1 = 0, bool bvar = false, SpellInfo const* spell = nullptr, GameObject* gob = nullptr);
         void GetTargets(ObjectVector& targets, SmartScriptHolder const& e, WorldObject* invoker = nullptr) const;
         void GetWorldObjectsInDist(ObjectVector& objects, float dist) const;
+        // binds the action to a handler if it has one, every SmartScriptHolder must pass through here before it is processed
+        static void CompileAction(SmartScriptHolder& e);
+        // selects the targets of every action with this script as owner and dispatches the compiled ones without targets, nothing is cast
+        SmartActionBenchmark BenchmarkActions(SmartAIEventList const& events, Unit* invoker, uint32 iterations);
         static SmartScriptHolder CreateSmartEvent(SMART_EVENT e, uint32 event_flags, uint32 event_param1, uint32 event_param2, uint32 event_param3, uint32 event_param4, uint32 event_param5, SMART_ACTION action, uint32 action_param1, uint32 action_param2, uint32 action_param3, uint32 action_param4, uint32 action_param5, uint32 action_param6, SMARTAI_TARGETS t, uint32 target_param1, uint32 target_param2, uint32 target_param3, uint32 target_param4, uint32 phaseMask);
         void SetPathId(uint32 id) { mPathId = id; }
         uint32 GetPathId() const { return mPathId; }
@@ -101,11 +118,40 @@ class TC_GAME_API SmartScript
         void SetPhase(uint32 p);
         bool IsInPhase(uint32 p) const;
 
+        bool InterpretAction(SmartScriptHolder& e, ObjectVector& targets, Unit* unit);
+        bool ProcessCastAction(SmartScriptHolder& e, ObjectVector& targets, Unit* unit);
+        bool ProcessSelfCastAction(SmartScriptHolder& e, ObjectVector& targets, Unit* unit);
+        bool ProcessInvokerCastAction(SmartScriptHolder& e, ObjectVector& targets, Unit* unit);
+        bool ProcessSetEventPhaseAction(SmartScriptHolder& e, ObjectVector& targets, Unit* unit);
+        bool ProcessIncEventPhaseAction(SmartScriptHolder& e, ObjectVector& targets, Unit* unit);
+
+        template<bool(SmartScript::*Handler)(SmartScriptHolder&, ObjectVector&, Unit*)>
+        static bool CallCompiledAction(SmartScript& script, SmartScriptHolder& e, ObjectVector& targets, Unit* invoker)
+        {
+            return (script.*Handler)(e, targets, invoker);
+        }
+
+        void GetSelfTargets(ObjectVector& targets, SmartScriptHolder const& e, WorldObject* invoker) const;
+        void GetVictimTargets(ObjectVector& targets, SmartScriptHolder const& e, WorldObject* invoker) const;
+        void GetActionInvokerTargets(ObjectVector& targets, SmartScriptHolder const& e, WorldObject* invoker) const;
+
+        template<void(SmartScript::*Selector)(ObjectVector&, SmartScriptHolder const&, WorldObject*) const>
+        static void CallCompiledTargetSelector(SmartScript const& script, SmartScriptHolder const& e, ObjectVector& targets, WorldObject* invoker)
+        {
+            (script.*Selector)(targets, e, invoker);
+        }
+
         void SortEvents(SmartAIEventList& events);
+        void BuildEventIndex();
+        bool IsMeetingConditions(SmartScriptHolder& e, Unit* unit);
+        static void ResolveConditions(SmartScriptHolder& e);
         void RaisePriority(SmartScriptHolder& e);
         void RetryLater(SmartScriptHolder& e, bool ignoreChanceRoll = false);
 
         SmartAIEventList mEvents;
+        // positions in mEvents grouped by event type in event order, events of type T are [mEventIndexOffsets[T], mEventIndexOffsets[T + 1])
+        std::vector<uint32> mEventIndexes;
+        std::array<uint32, SMART_EVENT_END + 1> mEventIndexOffsets;
         SmartAIEventList mInstallEvents;
         SmartAIEventList mTimedActionList;
         ObjectGuid mTimedActionListInvoker;
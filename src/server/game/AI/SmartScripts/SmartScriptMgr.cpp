@@ -25,6 +25,7 @@
 #include "MovementDefines.h"
 #include "ObjectAccessor.h"
 #include "ObjectMgr.h"
+#include "SmartScript.h"
 #include "SpellInfo.h"
 #include "SpellMgr.h"
 #include "Timer.h"
@@ -138,6 +139,8 @@ void SmartAIMgr::LoadSmartAIFromDB()
     }
 
     uint32 count = 0;
+    uint32 actionCount = 0;
+    uint32 compiledCount = 0;
 
     do
     {
@@ -346,6 +349,11 @@ void SmartAIMgr::LoadSmartAIFromDB()
                 break;
         }
 
+        SmartScript::CompileAction(temp);
+        ++actionCount;
+        if (temp.compiled.Handler)
+            ++compiledCount;
+
         // creature entry / guid not found in storage, create empty event list for it and increase counters
         if (mEventMap[source_type].find(temp.entryOrGuid) == mEventMap[source_type].end())
         {
@@ -386,7 +394,7 @@ void SmartAIMgr::LoadSmartAIFromDB()
         }
     }
 
-    TC_LOG_INFO("server.loading", ">> Loaded %u SmartAI scripts in %u ms", count, GetMSTimeDiffToNow(oldMSTime));
+    TC_LOG_INFO("server.loading", ">> Loaded %u SmartAI scripts (%u of %u actions bound to compiled handlers) in %u ms", count, compiledCount, actionCount, GetMSTimeDiffToNow(oldMSTime));
 
     UnLoadHelperStores();
 }
@@ -404,6 +412,16 @@ SmartAIEventList SmartAIMgr::GetScript(int32 entry, SmartScriptType type)
     }
 }
 
+SmartAIEventList SmartAIMgr::GetAllScripts() const
+{
+    SmartAIEventList events;
+    for (SmartAIEventMap const& eventMap : mEventMap)
+        for (auto const& [entryOrGuid, entryEvents] : eventMap)
+            events.insert(events.end(), entryEvents.begin(), entryEvents.end());
+
+    return events;
+}
+
 SmartScriptHolder& SmartAIMgr::FindLinkedSourceEvent(SmartAIEventList& list, uint32 eventId)
 {
     SmartAIEventList::iterator itr = std::find_if(list.begin(), list.end(),
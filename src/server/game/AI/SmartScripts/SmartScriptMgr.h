@@ -26,8 +26,14 @@
 #include <map>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
+class SmartScript;
+class SpellInfo;
+class Unit;
 class WorldObject;
+struct Condition;
+struct SmartScriptHolder;
 enum SpellEffIndex : uint8;
 typedef uint32 SAIBool;
 
@@ -1549,12 +1555,32 @@ enum SmartCastFlags
     SMARTCAST_COMBAT_MOVE            = 0x40                      // Prevents combat movement if cast successful. Allows movement on range, OOM, LOS
 };
 
+typedef std::vector<WorldObject*> ObjectVector;
+
+// returns false if the events linked to the action must not be processed
+typedef bool(*SmartActionHandler)(SmartScript& script, SmartScriptHolder& e, ObjectVector& targets, Unit* invoker);
+
+// fills targets like SmartScript::GetTargets for a single target type
+typedef void(*SmartTargetSelector)(SmartScript const& script, SmartScriptHolder const& e, ObjectVector& targets, WorldObject* invoker);
+
+// action of a SmartScriptHolder bound at load time by SmartScript::CompileAction
+struct SmartCompiledAction
+{
+    SmartCompiledAction() : Handler(nullptr), TargetSelector(nullptr), Spell(nullptr), TriggerFlags(0), UsesTargets(true) { }
+
+    SmartActionHandler Handler;                             // nullptr if the action is interpreted by SmartScript::ProcessAction
+    SmartTargetSelector TargetSelector;                     // nullptr if the targets are searched by SmartScript::GetTargets
+    SpellInfo const* Spell;                                 // spell of cast actions, nullptr if it does not exist
+    uint32 TriggerFlags;                                    // TriggerCastFlags of cast actions
+    bool UsesTargets;                                       // false if the action ignores its targets, they are not searched then
+};
+
 // one line in DB is one event
 struct SmartScriptHolder
 {
     SmartScriptHolder() : entryOrGuid(0), source_type(SMART_SCRIPT_TYPE_CREATURE)
         , event_id(0), link(0), event(), action(), target(), timer(0), priority(DEFAULT_PRIORITY), active(false), runOnce(false)
-        , enableTimed(false) { }
+        , enableTimed(false), conditions(nullptr), conditionsLoadCount(0) { }
 
     int32 entryOrGuid;
     SmartScriptType source_type;
@@ -1576,6 +1602,13 @@ struct SmartScriptHolder
     bool runOnce;
     bool enableTimed;
 
+    // conditions of this event resolved by SmartScript, nullptr if there are none
+    // the list belongs to ConditionMgr and is resolved again when its load count changes
+    std::vector<Condition*> const* conditions;
+    uint32 conditionsLoadCount;
+
+    SmartCompiledAction compiled;
+
     operator bool() const { return entryOrGuid != 0; }
     // Default comparision operator using priority field as first ordering field
     bool operator<(SmartScriptHolder const& other) const
@@ -1586,8 +1619,6 @@ struct SmartScriptHolder
     static constexpr uint32 DEFAULT_PRIORITY = std::numeric_limits<uint32>::max();
 };
 
-typedef std::vector<WorldObject*> ObjectVector;
-
 class ObjectGuidVector
 {
     public:
@@ -1653,6 +1684,8 @@ class TC_GAME_API SmartAIMgr
         void LoadSmartAIFromDB();
 
         SmartAIEventList GetScript(int32 entry, SmartScriptType type);
+        // copy of every loaded event of every source type
+        SmartAIEventList GetAllScripts() const;
 
         static SmartScriptHolder& FindLinkedSourceEvent(SmartAIEventList& list, uint32 eventId);
 
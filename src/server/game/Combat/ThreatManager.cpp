@@ -450,7 +450,7 @@ void ThreatManager::MatchUnitThreatToHighestThreat(Unit* target)
 
 void ThreatManager::TauntUpdate()
 {
-    std::list<AuraEffect*> const& tauntEffects = _owner->GetAuraEffectsByType(SPELL_AURA_MOD_TAUNT);
+    Unit::AuraEffectList const& tauntEffects = _owner->GetAuraEffectsByType(SPELL_AURA_MOD_TAUNT);
 
     uint32 state = ThreatReference::TAUNT_STATE_TAUNT;
     std::unordered_map<ObjectGuid, ThreatReference::TauntState> tauntStates;
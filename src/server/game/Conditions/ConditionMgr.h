@@ -275,6 +275,9 @@ class TC_GAME_API ConditionMgr
         ConditionContainer const* GetConditionsForSpellClickEvent(uint32 creatureId, uint32 spellId) const;
         bool IsObjectMeetingVehicleSpellConditions(uint32 creatureId, uint32 spellId, Player* player, Unit* vehicle) const;
         bool IsObjectMeetingSmartEventConditions(int32 entryOrGuid, uint32 eventId, uint32 sourceType, Unit* unit, WorldObject* baseObject) const;
+        ConditionContainer const* GetConditionsForSmartEvent(int32 entryOrGuid, uint32 eventId, uint32 sourceType) const;
+        // incremented by every (re)load, condition lists returned by the getters above are only valid until the next one
+        uint32 GetLoadCount() const { return _loadCount; }
         bool IsObjectMeetingVendorItemConditions(uint32 creatureId, uint32 itemId, Player* player, Creature* vendor) const;
 
         bool IsSpellUsedInSpellClickConditions(uint32 spellId) const;
@@ -310,6 +313,8 @@ class TC_GAME_API ConditionMgr
         SmartEventConditionContainer    SmartEventConditionStore;
 
         std::unordered_set<uint32> SpellsUsedInSpellClickConditions;
+
+        uint32 _loadCount;
 };
 
 #define sConditionMgr ConditionMgr::instance()
@@ -34,7 +34,7 @@
 namespace lfg
 {
 
-LFGPlayerScript::LFGPlayerScript() : PlayerScript("LFGPlayerScript") { }
+LFGPlayerScript::LFGPlayerScript() : PlayerScript("LFGPlayerScript", ScriptHooksOf<LFGPlayerScript>()) { }
 
 void LFGPlayerScript::OnLogout(Player* player)
 {
@@ -2743,9 +2743,8 @@ void GameObject::UpdateModelPosition()
 
     if (GetMap()->ContainsGameObjectModel(*m_model))
     {
-        GetMap()->RemoveGameObjectModel(*m_model);
         m_model->UpdatePosition();
-        GetMap()->InsertGameObjectModel(*m_model);
+        GetMap()->RelocateGameObjectModel(*m_model);
     }
 }
 
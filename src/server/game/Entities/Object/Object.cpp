@@ -1226,22 +1226,30 @@ bool WorldObject::IsWithinLOS(float ox, float oy, float oz, LineOfSightChecks ch
 {
     if (IsInWorld())
     {
-        oz += GetCollisionHeight();
-        float x, y, z;
-        if (GetTypeId() == TYPEID_PLAYER)
-        {
-            GetPosition(x, y, z);
-            z += GetCollisionHeight();
-        }
-        else
-            GetHitSpherePointFor({ ox, oy, oz }, x, y, z);
-
-        return GetMap()->isInLineOfSight(x, y, z, ox, oy, oz, GetPhaseMask(), checks, ignoreFlags);
+        float segment[6];
+        GetLineOfSightSegment(ox, oy, oz, segment);
+        return GetMap()->isInLineOfSight(segment[0], segment[1], segment[2], segment[3], segment[4], segment[5], GetPhaseMask(), checks, ignoreFlags);
     }
 
     return true;
 }
 
+void WorldObject::GetLineOfSightSegment(float x, float y, float z, float* segment) const
+{
+    z += GetCollisionHeight();
+    if (GetTypeId() == TYPEID_PLAYER)
+    {
+        GetPosition(segment[0], segment[1], segment[2]);
+        segment[2] += GetCollisionHeight();
+    }
+    else
+        GetHitSpherePointFor({ x, y, z }, segment[0], segment[1], segment[2]);
+
+    segment[3] = x;
+    segment[4] = y;
+    segment[5] = z;
+}
+
 bool WorldObject::IsWithinLOSInMap(WorldObject const* obj, LineOfSightChecks checks, VMAP::ModelIgnoreFlags ignoreFlags) const
 {
     if (!IsInMap(obj))
@@ -2821,13 +2829,20 @@ SpellCastResult WorldObject::CastSpell(CastSpellTargetArg const& targets, uint32
         return SPELL_FAILED_SPELL_UNAVAILABLE;
     }
 
+    return CastSpell(targets, info, args);
+}
+
+SpellCastResult WorldObject::CastSpell(CastSpellTargetArg const& targets, SpellInfo const* spellInfo, CastSpellExtraArgs const& args /*= { }*/)
+{
+    ASSERT(spellInfo);
+
     if (!targets.Targets)
     {
-        TC_LOG_ERROR("entities.unit", "CastSpell: Invalid target passed to spell cast %u by %s", spellId, GetGUID().ToString().c_str());
+        TC_LOG_ERROR("entities.unit", "CastSpell: Invalid target passed to spell cast %u by %s", spellInfo->Id, GetGUID().ToString().c_str());
         return SPELL_FAILED_BAD_TARGETS;
     }
 
-    Spell* spell = new Spell(this, info, args.TriggerFlags, args.OriginalCaster);
+    Spell* spell = new Spell(this, spellInfo, args.TriggerFlags, args.OriginalCaster);
     for (auto const& pair : args.SpellValueOverrides)
         spell->SetSpellValue(pair.first, pair.second);
 
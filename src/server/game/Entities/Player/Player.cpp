@@ -7349,6 +7349,7 @@ void Player::_ApplyItemBonuses(ItemTemplate const* proto, uint8 slot, bool apply
     if (only_level_scale && (!ssd || !ssv))
         return;
 
+    StatUpdateBatch statUpdateBatch(this);
     for (uint8 i = 0; i < MAX_ITEM_PROTO_STATS; ++i)
     {
         uint32 statType = 0;
@@ -21152,8 +21153,15 @@ void Player::ApplySpellMod(uint32 spellId, SpellModOp op, T& basevalue, Spell* s
     if (m_spellModTakingSpell)
         spell = m_spellModTakingSpell;
 
+    SpellModifierCache::Entry const& resolvedMods = m_spellModCache.Get(spellInfo, op, m_spellMods[op]);
+    totalflat += resolvedMods.Flat;
+    totalmul += resolvedMods.Pct;
+    if (spell)
+        for (SpellModifier* mod : resolvedMods.Applied)
+            Player::ApplyModToSpell(mod, spell);
+
     SpellModifier* chargedMod = nullptr;
-    for (SpellModifier* mod : m_spellMods[op])
+    for (SpellModifier* mod : resolvedMods.Dynamic)
     {
         if (!IsAffectedBySpellmod(spellInfo, mod, spell))
             continue;
@@ -21213,6 +21221,8 @@ void Player::AddSpellMod(SpellModifier* mod, bool apply)
         m_spellMods[mod->op].insert(mod);
     else
         m_spellMods[mod->op].erase(mod);
+
+    m_spellModCache.Invalidate();
 }
 
 void Player::ApplyModToSpell(SpellModifier* mod, Spell* spell)
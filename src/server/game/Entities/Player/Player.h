@@ -30,6 +30,7 @@
 #include "PetDefines.h"
 #include "PlayerTaxi.h"
 #include "QuestDef.h"
+#include "SpellModifierCache.h"
 #include <memory>
 #include <queue>
 #include <unordered_set>
@@ -153,7 +154,6 @@ struct SpellModifier
 
 typedef std::unordered_map<uint32, PlayerTalent*> PlayerTalentMap;
 typedef std::unordered_map<uint32, PlayerSpell> PlayerSpellMap;
-typedef std::unordered_set<SpellModifier*> SpellModContainer;
 
 typedef std::unordered_map<uint32 /*instanceId*/, time_t/*releaseTime*/> InstanceTimeMap;
 
@@ -1484,6 +1484,7 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
 
         void AddSpellMod(SpellModifier* mod, bool apply);
         static bool IsAffectedBySpellmod(SpellInfo const* spellInfo, SpellModifier* mod, Spell* spell = nullptr);
+        void InvalidateSpellModCache() { m_spellModCache.Invalidate(); }
         template <class T>
         void ApplySpellMod(uint32 spellId, SpellModOp op, T& basevalue, Spell* spell = nullptr) const;
         static void ApplyModToSpell(SpellModifier* mod, Spell* spell);
@@ -2358,6 +2359,7 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
         int32 m_spellPenetrationItemMod;
 
         SpellModContainer m_spellMods[MAX_SPELLMOD];
+        mutable SpellModifierCache m_spellModCache;
 
         EnchantDurationList m_enchantDuration;
         ItemDurationList m_itemDuration;
@@ -2457,6 +2459,12 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
         Item* _StoreItem(uint16 pos, Item* pItem, uint32 count, bool clone, bool update);
         Item* _LoadItem(CharacterDatabaseTransaction trans, uint32 zoneId, uint32 timeDiff, Field* fields);
 
+        // stat recalculation split in the stat value and everything derived from it, see PlayerStatDependency
+        void UpdateStatValue(Stats stat);
+        uint32 GetStatDependencies(Stats stat, uint32& ratingMask) const;
+        void UpdateStatDependencies(uint32 dependencies, uint32 ratingMask);
+        void UpdateDirtyUnitMods(std::bitset<UNIT_MOD_END> const& dirtyUnitMods) override;
+
         CinematicMgr* _cinematicMgr;
 
         GuidSet m_refundableItems;
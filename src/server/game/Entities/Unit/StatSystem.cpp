@@ -96,11 +96,37 @@ void Unit::UpdateDamagePhysical(WeaponAttackType attType)
 ########                         ########
 #######################################*/
 
+// derived player values that are recalculated when a stat changes
+enum PlayerStatDependency : uint32
+{
+    STAT_DEPENDENCY_SHIELD_BLOCK        = 0x001,
+    STAT_DEPENDENCY_ARMOR               = 0x002,
+    STAT_DEPENDENCY_CRIT                = 0x004,
+    STAT_DEPENDENCY_DODGE               = 0x008,
+    STAT_DEPENDENCY_MAX_HEALTH          = 0x010,
+    STAT_DEPENDENCY_MAX_MANA            = 0x020,
+    STAT_DEPENDENCY_SPELL_CRIT          = 0x040,
+    STAT_DEPENDENCY_ATTACK_POWER        = 0x080,
+    STAT_DEPENDENCY_RANGED_ATTACK_POWER = 0x100,
+    STAT_DEPENDENCY_SPELL_POWER         = 0x200,
+    STAT_DEPENDENCY_MANA_REGEN          = 0x400
+};
+
 bool Player::UpdateStats(Stats stat)
 {
     if (stat > STAT_SPIRIT)
         return false;
 
+    UpdateStatValue(stat);
+
+    uint32 ratingMask = 0;
+    uint32 dependencies = GetStatDependencies(stat, ratingMask);
+    UpdateStatDependencies(dependencies, ratingMask);
+    return true;
+}
+
+void Player::UpdateStatValue(Stats stat)
+{
     // value = ((base_value * base_pct) + total_value) * total_pct
     float value  = GetTotalStatValue(stat);
 
@@ -112,67 +138,131 @@ bool Player::UpdateStats(Stats stat)
         if (pet)
             pet->UpdateStats(stat);
     }
+}
 
+uint32 Player::GetStatDependencies(Stats stat, uint32& ratingMask) const
+{
+    uint32 dependencies = STAT_DEPENDENCY_SPELL_POWER | STAT_DEPENDENCY_MANA_REGEN;
     switch (stat)
     {
         case STAT_STRENGTH:
-            UpdateShieldBlockValue();
+            dependencies |= STAT_DEPENDENCY_SHIELD_BLOCK | STAT_DEPENDENCY_ATTACK_POWER;
+            if (HasAuraTypeWithMiscvalue(SPELL_AURA_MOD_RANGED_ATTACK_POWER_OF_STAT_PERCENT, stat))
+                dependencies |= STAT_DEPENDENCY_RANGED_ATTACK_POWER;
             break;
         case STAT_AGILITY:
-            UpdateArmor();
-            UpdateAllCritPercentages();
-            UpdateDodgePercentage();
+            dependencies |= STAT_DEPENDENCY_ARMOR | STAT_DEPENDENCY_CRIT | STAT_DEPENDENCY_DODGE | STAT_DEPENDENCY_ATTACK_POWER | STAT_DEPENDENCY_RANGED_ATTACK_POWER;
             break;
         case STAT_STAMINA:
-            UpdateMaxHealth();
+            dependencies |= STAT_DEPENDENCY_MAX_HEALTH;
             break;
         case STAT_INTELLECT:
-            UpdateMaxPower(POWER_MANA);
-            UpdateAllSpellCritChances();
-            UpdateArmor();                                  //SPELL_AURA_MOD_RESISTANCE_OF_INTELLECT_PERCENT, only armor currently
-            break;
-        case STAT_SPIRIT:
+            dependencies |= STAT_DEPENDENCY_MAX_MANA | STAT_DEPENDENCY_SPELL_CRIT | STAT_DEPENDENCY_ARMOR; //SPELL_AURA_MOD_RESISTANCE_OF_INTELLECT_PERCENT, only armor currently
             break;
         default:
             break;
     }
 
-    if (stat == STAT_STRENGTH)
-    {
-        UpdateAttackPowerAndDamage(false);
-        if (HasAuraTypeWithMiscvalue(SPELL_AURA_MOD_RANGED_ATTACK_POWER_OF_STAT_PERCENT, stat))
-            UpdateAttackPowerAndDamage(true);
-    }
-    else if (stat == STAT_AGILITY)
-    {
-        UpdateAttackPowerAndDamage(false);
-        UpdateAttackPowerAndDamage(true);
-    }
-    else
+    if (stat != STAT_STRENGTH && stat != STAT_AGILITY)
     {
         // Need update (exist AP from stat auras)
         if (HasAuraTypeWithMiscvalue(SPELL_AURA_MOD_ATTACK_POWER_OF_STAT_PERCENT, stat))
-            UpdateAttackPowerAndDamage(false);
+            dependencies |= STAT_DEPENDENCY_ATTACK_POWER;
         if (HasAuraTypeWithMiscvalue(SPELL_AURA_MOD_RANGED_ATTACK_POWER_OF_STAT_PERCENT, stat))
-            UpdateAttackPowerAndDamage(true);
+            dependencies |= STAT_DEPENDENCY_RANGED_ATTACK_POWER;
     }
 
-    UpdateSpellDamageAndHealingBonus();
-    UpdateManaRegen();
-
     // Update ratings in exist SPELL_AURA_MOD_RATING_FROM_STAT and only depends from stat
-    uint32 mask = 0;
     AuraEffectList const& modRatingFromStat = GetAuraEffectsByType(SPELL_AURA_MOD_RATING_FROM_STAT);
     for (AuraEffectList::const_iterator i = modRatingFromStat.begin(); i != modRatingFromStat.end(); ++i)
         if (Stats((*i)->GetMiscValueB()) == stat)
-            mask |= (*i)->GetMiscValue();
-    if (mask)
+            ratingMask |= (*i)->GetMiscValue();
+
+    return dependencies;
+}
+
+void Player::UpdateStatDependencies(uint32 dependencies, uint32 ratingMask)
+{
+    if (dependencies & STAT_DEPENDENCY_SHIELD_BLOCK)
+        UpdateShieldBlockValue();
+    if (dependencies & STAT_DEPENDENCY_ARMOR)
+        UpdateArmor();
+    if (dependencies & STAT_DEPENDENCY_CRIT)
+        UpdateAllCritPercentages();
+    if (dependencies & STAT_DEPENDENCY_DODGE)
+        UpdateDodgePercentage();
+    if (dependencies & STAT_DEPENDENCY_MAX_HEALTH)
+        UpdateMaxHealth();
+    if (dependencies & STAT_DEPENDENCY_MAX_MANA)
+        UpdateMaxPower(POWER_MANA);
+    if (dependencies & STAT_DEPENDENCY_SPELL_CRIT)
+        UpdateAllSpellCritChances();
+    if (dependencies & STAT_DEPENDENCY_ATTACK_POWER)
+        UpdateAttackPowerAndDamage(false);
+    if (dependencies & STAT_DEPENDENCY_RANGED_ATTACK_POWER)
+        UpdateAttackPowerAndDamage(true);
+    if (dependencies & STAT_DEPENDENCY_SPELL_POWER)
+        UpdateSpellDamageAndHealingBonus();
+    if (dependencies & STAT_DEPENDENCY_MANA_REGEN)
+        UpdateManaRegen();
+
+    for (uint32 rating = 0; rating < MAX_COMBAT_RATING; ++rating)
+        if (ratingMask & (1 << rating))
+            ApplyRatingMod(CombatRating(rating), 0, true);
+}
+
+void Player::UpdateDirtyUnitMods(std::bitset<UNIT_MOD_END> const& dirtyUnitMods)
+{
+    // all stats first, every value derived from them is then calculated once from the final stats
+    uint32 dependencies = 0;
+    uint32 ratingMask = 0;
+    for (uint8 i = STAT_STRENGTH; i < MAX_STATS; ++i)
     {
-        for (uint32 rating = 0; rating < MAX_COMBAT_RATING; ++rating)
-            if (mask & (1 << rating))
-                ApplyRatingMod(CombatRating(rating), 0, true);
+        if (!dirtyUnitMods[UNIT_MOD_STAT_START + i])
+            continue;
+
+        UpdateStatValue(Stats(i));
+        dependencies |= GetStatDependencies(Stats(i), ratingMask);
+    }
+
+    UpdateStatDependencies(dependencies, ratingMask);
+
+    for (uint8 i = UNIT_MOD_STAT_END; i < UNIT_MOD_END; ++i)
+    {
+        if (!dirtyUnitMods[i])
+            continue;
+
+        // already recalculated as dependency of a stat
+        switch (i)
+        {
+            case UNIT_MOD_HEALTH:
+                if (dependencies & STAT_DEPENDENCY_MAX_HEALTH)
+                    continue;
+                break;
+            case UNIT_MOD_MANA:
+                if (dependencies & STAT_DEPENDENCY_MAX_MANA)
+                    continue;
+                break;
+            case UNIT_MOD_ARMOR:
+                if (dependencies & STAT_DEPENDENCY_ARMOR)
+                    continue;
+                break;
+            case UNIT_MOD_ATTACK_POWER:
+            case UNIT_MOD_DAMAGE_MAINHAND:
+                if (dependencies & STAT_DEPENDENCY_ATTACK_POWER)
+                    continue;
+                break;
+            case UNIT_MOD_ATTACK_POWER_RANGED:
+            case UNIT_MOD_DAMAGE_RANGED:
+                if (dependencies & STAT_DEPENDENCY_RANGED_ATTACK_POWER)
+                    continue;
+                break;
+            default:
+                break;
+        }
+
+        UpdateUnitMod(UnitMods(i));
     }
-    return true;
 }
 
 void Player::ApplySpellPowerBonus(int32 amount, bool apply)
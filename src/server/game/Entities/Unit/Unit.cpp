@@ -80,6 +80,50 @@
 #include "WorldSession.h"
 #include <cmath>
 
+namespace
+{
+    /**
+        Scratch list of proc aura candidates, borrowed from a per thread pool and returned with its capacity kept,
+        so proc events do not allocate. Procs can trigger spells which proc again, every nested event gets its own list.
+    */
+    class ProcAuraCandidateBuffer
+    {
+    public:
+        ProcAuraCandidateBuffer()
+        {
+            if (!_pool.empty())
+            {
+                _buffer = std::move(_pool.back());
+                _pool.pop_back();
+            }
+        }
+
+        ~ProcAuraCandidateBuffer()
+        {
+            // don't keep memory of units with huge aura lists around
+            if (_pool.size() >= MaxPooledBuffers || _buffer.capacity() > MaxPooledCapacity)
+                return;
+
+            _buffer.clear();
+            _pool.push_back(std::move(_buffer));
+        }
+
+        ProcAuraCandidateBuffer(ProcAuraCandidateBuffer const&) = delete;
+        ProcAuraCandidateBuffer& operator=(ProcAuraCandidateBuffer const&) = delete;
+
+        std::vector<AuraApplication*>& operator*() { return _buffer; }
+
+    private:
+        static constexpr std::size_t MaxPooledBuffers = 8;
+        static constexpr std::size_t MaxPooledCapacity = 256;
+
+        std::vector<AuraApplication*> _buffer;
+        static thread_local std::vector<std::vector<AuraApplication*>> _pool;
+    };
+
+    thread_local std::vector<std::vector<AuraApplication*>> ProcAuraCandidateBuffer::_pool;
+}
+
 float baseMoveSpeed[MAX_MOVE_TYPE] =
 {
     2.5f,                  // MOVE_WALK
@@ -327,6 +371,11 @@ Unit::Unit(bool isWorldObject) :
     for (uint8 i = 0; i < CURRENT_MAX_SPELL; ++i)
         m_currentSpells[i] = nullptr;
 
+    m_procAuraIndexFlags = 0;
+    m_procAuraIndexGeneration = sSpellMgr->GetSpellProcGeneration();
+
+    std::fill(std::begin(m_auraModifierVersions), std::end(m_auraModifierVersions), 0);
+
     for (uint8 i = 0; i < MAX_SUMMON_SLOT; ++i)
         m_SummonSlot[i].Clear();
 
@@ -337,6 +386,7 @@ Unit::Unit(bool isWorldObject) :
 
     m_interruptMask = 0;
     m_canModifyStats = false;
+    m_statUpdateBatchDepth = 0;
 
     for (uint8 i = 0; i < UNIT_MOD_END; ++i)
     {
@@ -1796,7 +1846,7 @@ void Unit::HandleEmoteCommand(Emote emoteId)
     // We're going to call functions which can modify content of the list during iteration over it's elements
     // Let's copy the list so we can prevent iterator invalidation
     AuraEffectList vSchoolAbsorbCopy(damageInfo.GetVictim()->GetAuraEffectsByType(SPELL_AURA_SCHOOL_ABSORB));
-    vSchoolAbsorbCopy.sort(Trinity::AbsorbAuraOrderPred());
+    std::stable_sort(vSchoolAbsorbCopy.begin(), vSchoolAbsorbCopy.end(), Trinity::AbsorbAuraOrderPred());
 
     // absorb without mana cost
     for (AuraEffectList::iterator itr = vSchoolAbsorbCopy.begin(); (itr != vSchoolAbsorbCopy.end()) && (damageInfo.GetDamage() > 0); ++itr)
@@ -2051,7 +2101,7 @@ void Unit::HandleEmoteCommand(Emote emoteId)
             {
                 uint32 removedAuras = healInfo.GetTarget()->m_removedAurasCount;
                 auraEff->GetBase()->Remove(AURA_REMOVE_BY_ENEMY_SPELL);
-                if (removedAuras + 1 < healInfo.GetTarget()->m_removedAurasCount)
+                if (removedAuras != healInfo.GetTarget()->m_removedAurasCount)
                     i = vHealAbsorb.begin();
             }
         }
@@ -3328,6 +3378,7 @@ AuraApplication* Unit::_CreateAuraApplication(Aura* aura, uint8 effMask)
 
     AuraApplication * aurApp = new AuraApplication(this, caster, aura, effMask);
     m_appliedAuras.insert(AuraApplicationMap::value_type(aurId, aurApp));
+    _AddToProcAuraIndex(aurApp);
 
     if (aurSpellInfo->AuraInterruptFlags)
     {
@@ -3423,6 +3474,7 @@ void Unit::_UnapplyAura(AuraApplicationMap::iterator& i, AuraRemoveMode removeMo
 
     // Remove all pointers from lists here to prevent possible pointer invalidation on spellcast/auraapply/auraremove
     m_appliedAuras.erase(i);
+    _RemoveFromProcAuraIndex(aurApp);
 
     if (aura->GetSpellInfo()->AuraInterruptFlags)
     {
@@ -3549,10 +3601,13 @@ void Unit::_RemoveNoStackAurasDueToAura(Aura* aura)
 
 void Unit::_RegisterAuraEffect(AuraEffect* aurEff, bool apply)
 {
+    AuraEffectList& auraEffects = m_modAuras[aurEff->GetAuraType()];
     if (apply)
-        m_modAuras[aurEff->GetAuraType()].push_back(aurEff);
+        auraEffects.push_back(aurEff);
     else
-        m_modAuras[aurEff->GetAuraType()].remove(aurEff);
+        auraEffects.erase(std::remove(auraEffects.begin(), auraEffects.end(), aurEff), auraEffects.end());
+
+    InvalidateAuraModifierCache(aurEff->GetAuraType());
 }
 
 // All aura base removes should go through this function!
@@ -3771,7 +3826,7 @@ void Unit::RemoveAurasByType(AuraType auraType, std::function<bool(AuraApplicati
         {
             uint32 removedAuras = m_removedAurasCount;
             RemoveAura(aurApp, removeMode);
-            if (m_removedAurasCount > removedAuras + 1)
+            if (m_removedAurasCount != removedAuras)
                 iter = m_modAuras[auraType].begin();
         }
     }
@@ -3950,7 +4005,7 @@ void Unit::RemoveAurasByType(AuraType auraType, ObjectGuid casterGUID, Aura* exc
         {
             uint32 removedAuras = m_removedAurasCount;
             RemoveAura(aurApp);
-            if (m_removedAurasCount > removedAuras + 1)
+            if (m_removedAurasCount != removedAuras)
                 iter = m_modAuras[auraType].begin();
         }
     }
@@ -4775,103 +4830,171 @@ int32 Unit::GetMaxNegativeAuraModifier(AuraType auraType, std::function<bool(Aur
     return modifier;
 }
 
+template<typename T, typename Calculator>
+T Unit::GetCachedAuraModifier(AuraType auraType, AuraModifierAggregate aggregate, AuraModifierFilter filter, uint32 miscValue, Calculator calculator) const
+{
+    // nothing to sum up
+    if (m_modAuras[auraType].empty())
+        return calculator();
+
+    uint64 key = uint64(auraType) << 40 | uint64(aggregate) << 36 | uint64(filter) << 32 | miscValue;
+    auto itr = m_auraModifierCache.find(key);
+    if (itr != m_auraModifierCache.end() && itr->second.Version == m_auraModifierVersions[auraType])
+    {
+        if constexpr (std::is_same<T, float>::value)
+            return itr->second.Multiplier;
+        else
+            return itr->second.Modifier;
+    }
+
+    T value = calculator();
+    AuraModifierCacheEntry& entry = m_auraModifierCache[key];
+    entry.Version = m_auraModifierVersions[auraType];
+    if constexpr (std::is_same<T, float>::value)
+        entry.Multiplier = value;
+    else
+        entry.Modifier = value;
+    return value;
+}
+
 int32 Unit::GetTotalAuraModifier(AuraType auraType) const
 {
-    return GetTotalAuraModifier(auraType, [](AuraEffect const* /*aurEff*/) { return true; });
+    return GetCachedAuraModifier<int32>(auraType, AURA_MODIFIER_TOTAL, AURA_MODIFIER_FILTER_NONE, 0, [&]()
+    {
+        return GetTotalAuraModifier(auraType, [](AuraEffect const* /*aurEff*/) { return true; });
+    });
 }
 
 float Unit::GetTotalAuraMultiplier(AuraType auraType) const
 {
-    return GetTotalAuraMultiplier(auraType, [](AuraEffect const* /*aurEff*/) { return true; });
+    return GetCachedAuraModifier<float>(auraType, AURA_MODIFIER_TOTAL_MULTIPLIER, AURA_MODIFIER_FILTER_NONE, 0, [&]()
+    {
+        return GetTotalAuraMultiplier(auraType, [](AuraEffect const* /*aurEff*/) { return true; });
+    });
 }
 
 int32 Unit::GetMaxPositiveAuraModifier(AuraType auraType) const
 {
-    return GetMaxPositiveAuraModifier(auraType, [](AuraEffect const* /*aurEff*/) { return true; });
+    return GetCachedAuraModifier<int32>(auraType, AURA_MODIFIER_MAX_POSITIVE, AURA_MODIFIER_FILTER_NONE, 0, [&]()
+    {
+        return GetMaxPositiveAuraModifier(auraType, [](AuraEffect const* /*aurEff*/) { return true; });
+    });
 }
 
 int32 Unit::GetMaxNegativeAuraModifier(AuraType auraType) const
 {
-    return GetMaxNegativeAuraModifier(auraType, [](AuraEffect const* /*aurEff*/) { return true; });
+    return GetCachedAuraModifier<int32>(auraType, AURA_MODIFIER_MAX_NEGATIVE, AURA_MODIFIER_FILTER_NONE, 0, [&]()
+    {
+        return GetMaxNegativeAuraModifier(auraType, [](AuraEffect const* /*aurEff*/) { return true; });
+    });
 }
 
 int32 Unit::GetTotalAuraModifierByMiscMask(AuraType auraType, uint32 miscMask) const
 {
-    return GetTotalAuraModifier(auraType, [miscMask](AuraEffect const* aurEff) -> bool
+    return GetCachedAuraModifier<int32>(auraType, AURA_MODIFIER_TOTAL, AURA_MODIFIER_FILTER_MISC_MASK, miscMask, [&]()
     {
-        if ((aurEff->GetMiscValue() & miscMask) != 0)
-            return true;
-        return false;
+        return GetTotalAuraModifier(auraType, [miscMask](AuraEffect const* aurEff) -> bool
+        {
+            if ((aurEff->GetMiscValue() & miscMask) != 0)
+                return true;
+            return false;
+        });
     });
 }
 
 float Unit::GetTotalAuraMultiplierByMiscMask(AuraType auraType, uint32 miscMask) const
 {
-    return GetTotalAuraMultiplier(auraType, [miscMask](AuraEffect const* aurEff) -> bool
+    return GetCachedAuraModifier<float>(auraType, AURA_MODIFIER_TOTAL_MULTIPLIER, AURA_MODIFIER_FILTER_MISC_MASK, miscMask, [&]()
     {
-        if ((aurEff->GetMiscValue() & miscMask) != 0)
-            return true;
-        return false;
+        return GetTotalAuraMultiplier(auraType, [miscMask](AuraEffect const* aurEff) -> bool
+        {
+            if ((aurEff->GetMiscValue() & miscMask) != 0)
+                return true;
+            return false;
+        });
     });
 }
 
 int32 Unit::GetMaxPositiveAuraModifierByMiscMask(AuraType auraType, uint32 miscMask, AuraEffect const* except /*= nullptr*/) const
 {
-    return GetMaxPositiveAuraModifier(auraType, [miscMask, except](AuraEffect const* aurEff) -> bool
+    auto calculator = [&]()
     {
-        if (except != aurEff && (aurEff->GetMiscValue() & miscMask) != 0)
-            return true;
-        return false;
-    });
+        return GetMaxPositiveAuraModifier(auraType, [miscMask, except](AuraEffect const* aurEff) -> bool
+        {
+            if (except != aurEff && (aurEff->GetMiscValue() & miscMask) != 0)
+                return true;
+            return false;
+        });
+    };
+
+    if (except)
+        return calculator();
+
+    return GetCachedAuraModifier<int32>(auraType, AURA_MODIFIER_MAX_POSITIVE, AURA_MODIFIER_FILTER_MISC_MASK, miscMask, calculator);
 }
 
 int32 Unit::GetMaxNegativeAuraModifierByMiscMask(AuraType auraType, uint32 miscMask) const
 {
-    return GetMaxNegativeAuraModifier(auraType, [miscMask](AuraEffect const* aurEff) -> bool
+    return GetCachedAuraModifier<int32>(auraType, AURA_MODIFIER_MAX_NEGATIVE, AURA_MODIFIER_FILTER_MISC_MASK, miscMask, [&]()
     {
-        if ((aurEff->GetMiscValue() & miscMask) != 0)
-            return true;
-        return false;
+        return GetMaxNegativeAuraModifier(auraType, [miscMask](AuraEffect const* aurEff) -> bool
+        {
+            if ((aurEff->GetMiscValue() & miscMask) != 0)
+                return true;
+            return false;
+        });
     });
 }
 
 int32 Unit::GetTotalAuraModifierByMiscValue(AuraType auraType, int32 miscValue) const
 {
-    return GetTotalAuraModifier(auraType, [miscValue](AuraEffect const* aurEff) -> bool
+    return GetCachedAuraModifier<int32>(auraType, AURA_MODIFIER_TOTAL, AURA_MODIFIER_FILTER_MISC_VALUE, uint32(miscValue), [&]()
     {
-        if (aurEff->GetMiscValue() == miscValue)
-            return true;
-        return false;
+        return GetTotalAuraModifier(auraType, [miscValue](AuraEffect const* aurEff) -> bool
+        {
+            if (aurEff->GetMiscValue() == miscValue)
+                return true;
+            return false;
+        });
     });
 }
 
 float Unit::GetTotalAuraMultiplierByMiscValue(AuraType auraType, int32 miscValue) const
 {
-    return GetTotalAuraMultiplier(auraType, [miscValue](AuraEffect const* aurEff) -> bool
+    return GetCachedAuraModifier<float>(auraType, AURA_MODIFIER_TOTAL_MULTIPLIER, AURA_MODIFIER_FILTER_MISC_VALUE, uint32(miscValue), [&]()
     {
-        if (aurEff->GetMiscValue() == miscValue)
-            return true;
-        return false;
+        return GetTotalAuraMultiplier(auraType, [miscValue](AuraEffect const* aurEff) -> bool
+        {
+            if (aurEff->GetMiscValue() == miscValue)
+                return true;
+            return false;
+        });
     });
 }
 
 int32 Unit::GetMaxPositiveAuraModifierByMiscValue(AuraType auraType, int32 miscValue) const
 {
-    return GetMaxPositiveAuraModifier(auraType, [miscValue](AuraEffect const* aurEff) -> bool
+    return GetCachedAuraModifier<int32>(auraType, AURA_MODIFIER_MAX_POSITIVE, AURA_MODIFIER_FILTER_MISC_VALUE, uint32(miscValue), [&]()
     {
-        if (aurEff->GetMiscValue() == miscValue)
-            return true;
-        return false;
+        return GetMaxPositiveAuraModifier(auraType, [miscValue](AuraEffect const* aurEff) -> bool
+        {
+            if (aurEff->GetMiscValue() == miscValue)
+                return true;
+            return false;
+        });
     });
 }
 
 int32 Unit::GetMaxNegativeAuraModifierByMiscValue(AuraType auraType, int32 miscValue) const
 {
-    return GetMaxNegativeAuraModifier(auraType, [miscValue](AuraEffect const* aurEff) -> bool
+    return GetCachedAuraModifier<int32>(auraType, AURA_MODIFIER_MAX_NEGATIVE, AURA_MODIFIER_FILTER_MISC_VALUE, uint32(miscValue), [&]()
     {
-        if (aurEff->GetMiscValue() == miscValue)
-            return true;
-        return false;
+        return GetMaxNegativeAuraModifier(auraType, [miscValue](AuraEffect const* aurEff) -> bool
+        {
+            if (aurEff->GetMiscValue() == miscValue)
+                return true;
+            return false;
+        });
     });
 }
 
@@ -5238,6 +5361,10 @@ void Unit::SendSpellNonMeleeDamageLog(Unit* target, uint32 spellID, uint32 damag
 
 void Unit::SendPeriodicAuraLog(SpellPeriodicAuraLogInfo* pInfo)
 {
+    // sent together with the other ticks of this map at the end of the batch slot
+    if (IsInWorld() && GetMap()->GetPeriodicAuraLogBatch().Add(this, pInfo))
+        return;
+
     AuraEffect const* aura = pInfo->auraEff;
 
     WorldPacket data(SMSG_PERIODICAURALOG, 30);
@@ -5245,11 +5372,21 @@ void Unit::SendPeriodicAuraLog(SpellPeriodicAuraLogInfo* pInfo)
     data << aura->GetCasterGUID().WriteAsPacked();
     data << uint32(aura->GetId());                          // spellId
     data << uint32(1);                                      // count
-    data << uint32(aura->GetAuraType());                    // auraId
+    if (!BuildPeriodicAuraLogEntry(data, pInfo))
+        return;
+
+    SendMessageToSet(&data, true);
+}
+
+bool Unit::BuildPeriodicAuraLogEntry(ByteBuffer& data, SpellPeriodicAuraLogInfo const* pInfo)
+{
+    AuraEffect const* aura = pInfo->auraEff;
+
     switch (aura->GetAuraType())
     {
         case SPELL_AURA_PERIODIC_DAMAGE:
         case SPELL_AURA_PERIODIC_DAMAGE_PERCENT:
+            data << uint32(aura->GetAuraType());            // auraId
             data << uint32(pInfo->damage);                  // damage
             data << uint32(pInfo->overDamage);              // overkill?
             data << uint32(aura->GetSpellInfo()->GetSchoolMask());
@@ -5259,6 +5396,7 @@ void Unit::SendPeriodicAuraLog(SpellPeriodicAuraLogInfo* pInfo)
             break;
         case SPELL_AURA_PERIODIC_HEAL:
         case SPELL_AURA_OBS_MOD_HEALTH:
+            data << uint32(aura->GetAuraType());            // auraId
             data << uint32(pInfo->damage);                  // damage
             data << uint32(pInfo->overDamage);              // overheal
             data << uint32(pInfo->absorb);                  // absorb
@@ -5266,20 +5404,22 @@ void Unit::SendPeriodicAuraLog(SpellPeriodicAuraLogInfo* pInfo)
             break;
         case SPELL_AURA_OBS_MOD_POWER:
         case SPELL_AURA_PERIODIC_ENERGIZE:
+            data << uint32(aura->GetAuraType());            // auraId
             data << uint32(aura->GetMiscValue());           // power type
             data << uint32(pInfo->damage);                  // damage
             break;
         case SPELL_AURA_PERIODIC_MANA_LEECH:
+            data << uint32(aura->GetAuraType());            // auraId
             data << uint32(aura->GetMiscValue());           // power type
             data << uint32(pInfo->damage);                  // amount
             data << float(pInfo->multiplier);               // gain multiplier
             break;
         default:
             TC_LOG_ERROR("entities.unit", "Unit::SendPeriodicAuraLog: unknown aura %u", uint32(aura->GetAuraType()));
-            return;
+            return false;
     }
 
-    SendMessageToSet(&data, true);
+    return true;
 }
 
 void Unit::SendSpellDamageResist(Unit* target, uint32 spellId)
@@ -9078,6 +9218,12 @@ void Unit::UpdateUnitMod(UnitMods unitMod)
     if (!CanModifyStats())
         return;
 
+    if (m_statUpdateBatchDepth)
+    {
+        m_dirtyUnitMods.set(unitMod);
+        return;
+    }
+
     switch (unitMod)
     {
         case UNIT_MOD_STAT_STRENGTH:
@@ -9116,6 +9262,24 @@ void Unit::UpdateUnitMod(UnitMods unitMod)
     }
 }
 
+void Unit::EndStatUpdateBatch()
+{
+    ASSERT(m_statUpdateBatchDepth);
+    if (--m_statUpdateBatchDepth || m_dirtyUnitMods.none())
+        return;
+
+    std::bitset<UNIT_MOD_END> dirtyUnitMods = m_dirtyUnitMods;
+    m_dirtyUnitMods.reset();
+    UpdateDirtyUnitMods(dirtyUnitMods);
+}
+
+void Unit::UpdateDirtyUnitMods(std::bitset<UNIT_MOD_END> const& dirtyUnitMods)
+{
+    for (uint8 i = 0; i < UNIT_MOD_END; ++i)
+        if (dirtyUnitMods[i])
+            UpdateUnitMod(UnitMods(i));
+}
+
 void Unit::UpdateDamageDoneMods(WeaponAttackType attackType, int32 /*skipEnchantSlot = -1*/)
 {
     UnitMods unitMod;
@@ -10120,6 +10284,91 @@ void Unit::ProcSkillsAndReactives(bool isVictim, Unit* procTarget, uint32 typeMa
     }
 }
 
+void Unit::_AddToProcAuraIndex(AuraApplication* aurApp)
+{
+    uint32 spellId = aurApp->GetBase()->GetId();
+    SpellProcEntry const* procEntry = sSpellMgr->GetSpellProcEntry(spellId);
+    // only auras with spell proc entry can trigger proc
+    if (!procEntry)
+        return;
+
+    // m_appliedAuras is a multimap, applications of the same spell are ordered by insertion
+    auto itr = std::upper_bound(m_procAuraIndex.begin(), m_procAuraIndex.end(), spellId, [](uint32 id, ProcAuraIndexEntry const& entry)
+    {
+        return id < entry.SpellId;
+    });
+    m_procAuraIndex.insert(itr, { spellId, procEntry->ProcFlags, aurApp });
+    m_procAuraIndexFlags |= procEntry->ProcFlags;
+}
+
+void Unit::_RemoveFromProcAuraIndex(AuraApplication* aurApp)
+{
+    auto itr = std::find_if(m_procAuraIndex.begin(), m_procAuraIndex.end(), [aurApp](ProcAuraIndexEntry const& entry)
+    {
+        return entry.AurApp == aurApp;
+    });
+
+    if (itr == m_procAuraIndex.end())
+        return;
+
+    m_procAuraIndex.erase(itr);
+
+    m_procAuraIndexFlags = 0;
+    for (ProcAuraIndexEntry const& entry : m_procAuraIndex)
+        m_procAuraIndexFlags |= entry.ProcFlags;
+}
+
+void Unit::_RebuildProcAuraIndex()
+{
+    m_procAuraIndex.clear();
+    m_procAuraIndexFlags = 0;
+    for (AuraApplicationMap::value_type const& pair : m_appliedAuras)
+    {
+        if (SpellProcEntry const* procEntry = sSpellMgr->GetSpellProcEntry(pair.first))
+        {
+            m_procAuraIndex.push_back({ pair.first, procEntry->ProcFlags, pair.second });
+            m_procAuraIndexFlags |= procEntry->ProcFlags;
+        }
+    }
+
+    m_procAuraIndexGeneration = sSpellMgr->GetSpellProcGeneration();
+}
+
+void Unit::GetProcAuraCandidates(uint32 typeMask, std::vector<AuraApplication*>& candidates)
+{
+    // spell_proc was reloaded
+    if (m_procAuraIndexGeneration != sSpellMgr->GetSpellProcGeneration())
+        _RebuildProcAuraIndex();
+
+    bool const verify = sWorld->getBoolConfig(CONFIG_PROC_AURA_INDEX_VERIFY);
+
+    // most units have no aura at all reacting to the event
+    if (!(m_procAuraIndexFlags & typeMask) && !verify)
+        return;
+
+    for (ProcAuraIndexEntry const& entry : m_procAuraIndex)
+        if (entry.ProcFlags & typeMask)
+            candidates.push_back(entry.AurApp);
+
+    if (!verify)
+        return;
+
+    // compare against a scan of all applied auras
+    std::vector<AuraApplication*> expected;
+    for (AuraApplicationMap::value_type const& pair : m_appliedAuras)
+        if (SpellProcEntry const* procEntry = sSpellMgr->GetSpellProcEntry(pair.first))
+            if (procEntry->ProcFlags & typeMask)
+                expected.push_back(pair.second);
+
+    if (candidates != expected)
+    {
+        TC_LOG_ERROR("spells", "Unit::GetProcAuraCandidates: proc aura index of %s is out of sync for proc flags 0x%X (%u indexed, %u expected), rebuilding it",
+            GetGUID().ToString().c_str(), typeMask, uint32(candidates.size()), uint32(expected.size()));
+        candidates = std::move(expected);
+        _RebuildProcAuraIndex();
+    }
+}
+
 void Unit::GetProcAurasTriggeredOnEvent(AuraApplicationProcContainer& aurasTriggeringProc, AuraApplicationList* procAuras, ProcEventInfo& eventInfo)
 {
     TimePoint now = GameTime::Now();
@@ -10140,12 +10389,22 @@ void Unit::GetProcAurasTriggeredOnEvent(AuraApplicationProcContainer& aurasTrigg
     // or generate one on our own
     else
     {
-        for (AuraApplicationMap::iterator itr = GetAppliedAuras().begin(); itr != GetAppliedAuras().end(); ++itr)
+        // auras whose proc flags don't match the event can never proc, skip them
+        // the candidates are copied because proc checks may apply or remove auras
+        ProcAuraCandidateBuffer candidateBuffer;
+        std::vector<AuraApplication*>& candidates = *candidateBuffer;
+        GetProcAuraCandidates(eventInfo.GetTypeMask(), candidates);
+
+        for (AuraApplication* aurApp : candidates)
         {
-            if (uint8 procEffectMask = itr->second->GetBase()->GetProcEffectMask(itr->second, eventInfo, now))
+            // removed by a previous candidate's proc check
+            if (aurApp->GetRemoveMode())
+                continue;
+
+            if (uint8 procEffectMask = aurApp->GetBase()->GetProcEffectMask(aurApp, eventInfo, now))
             {
-                itr->second->GetBase()->PrepareProcToTrigger(itr->second, eventInfo, now);
-                aurasTriggeringProc.emplace_back(procEffectMask, itr->second);
+                aurApp->GetBase()->PrepareProcToTrigger(aurApp, eventInfo, now);
+                aurasTriggeringProc.emplace_back(procEffectMask, aurApp);
             }
         }
     }
@@ -10165,11 +10424,15 @@ void Unit::TriggerAurasProcOnEvent(Unit* actionTarget, uint32 typeMaskActor, uin
         {
             if (modOwner != this && spell)
             {
+                ProcAuraCandidateBuffer candidateBuffer;
+                std::vector<AuraApplication*>& candidates = *candidateBuffer;
+                modOwner->GetProcAuraCandidates(typeMaskActor, candidates);
+
                 AuraApplicationList modAuras;
-                for (auto itr = modOwner->GetAppliedAuras().begin(); itr != modOwner->GetAppliedAuras().end(); ++itr)
+                for (AuraApplication* aurApp : candidates)
                 {
-                    if (spell->m_appliedMods.count(itr->second->GetBase()) != 0)
-                        modAuras.push_back(itr->second);
+                    if (spell->m_appliedMods.count(aurApp->GetBase()) != 0)
+                        modAuras.push_back(aurApp);
                 }
                 modOwner->GetProcAurasTriggeredOnEvent(myAurasTriggeringProc, &modAuras, myProcEventInfo);
             }
@@ -13621,7 +13884,7 @@ bool Unit::IsHighestExclusiveAuraEffect(SpellInfo const* spellInfo, AuraType aur
                         bool hasMoreThanOneEffect = base->HasMoreThanOneEffectForType(auraType);
                         uint32 removedAuras = m_removedAurasCount;
                         RemoveAura(aurApp);
-                        if (hasMoreThanOneEffect || m_removedAurasCount > removedAuras + 1)
+                        if (hasMoreThanOneEffect || m_removedAurasCount != removedAuras)
                             itr = auras.begin();
                     }
                 }
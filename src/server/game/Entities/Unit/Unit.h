@@ -25,10 +25,12 @@
 #include "Timer.h"
 #include "UnitDefines.h"
 #include "Util.h"
+#include <bitset>
 #include <map>
 #include <memory>
 #include <stack>
 #include <queue>
+#include <vector>
 
 #define VISUAL_WAYPOINT 1 // Creature Entry ID used for waypoints show, visible only for GMs
 #define WORLD_TRIGGER 12999
@@ -785,7 +787,7 @@ class TC_GAME_API Unit : public WorldObject
         typedef std::multimap<AuraStateType,  AuraApplication*> AuraStateAurasMap;
         typedef std::pair<AuraStateAurasMap::const_iterator, AuraStateAurasMap::const_iterator> AuraStateAurasMapBounds;
 
-        typedef std::list<AuraEffect*> AuraEffectList;
+        typedef std::vector<AuraEffect*> AuraEffectList;
         typedef std::list<Aura*> AuraList;
         typedef std::list<AuraApplication*> AuraApplicationList;
         typedef std::array<DiminishingReturn, DIMINISHING_MAX> Diminishing;
@@ -1026,6 +1028,8 @@ class TC_GAME_API Unit : public WorldObject
                                 DamageInfo* damageInfo, HealInfo* healInfo);
 
         void GetProcAurasTriggeredOnEvent(AuraApplicationProcContainer& aurasTriggeringProc, AuraApplicationList* procAuras, ProcEventInfo& eventInfo);
+        // applied auras with a spell_proc entry matching typeMask, in m_appliedAuras order
+        void GetProcAuraCandidates(uint32 typeMask, std::vector<AuraApplication*>& candidates);
         void TriggerAurasProcOnEvent(Unit* actionTarget, uint32 typeMaskActor, uint32 typeMaskActionTarget,
                                      uint32 spellTypeMask, uint32 spellPhaseMask, uint32 hitMask, Spell* spell,
                                      DamageInfo* damageInfo, HealInfo* healInfo);
@@ -1192,6 +1196,7 @@ class TC_GAME_API Unit : public WorldObject
         void SendSpellNonMeleeDamageLog(SpellNonMeleeDamage const* log);
         void SendSpellNonMeleeDamageLog(Unit* target, uint32 spellID, uint32 damage, SpellSchoolMask damageSchoolMask, uint32 absorbedDamage, uint32 resist, bool isPeriodic, uint32 blocked, bool criticalHit = false, bool split = false);
         void SendPeriodicAuraLog(SpellPeriodicAuraLogInfo* pInfo);
+        static bool BuildPeriodicAuraLogEntry(ByteBuffer& data, SpellPeriodicAuraLogInfo const* pInfo);
         void SendSpellDamageResist(Unit* target, uint32 spellId);
         void SendSpellDamageImmune(Unit* target, uint32 spellId);
 
@@ -1441,6 +1446,9 @@ class TC_GAME_API Unit : public WorldObject
         int32 GetMaxPositiveAuraModifierByAffectMask(AuraType auraType, SpellInfo const* affectedSpell) const;
         int32 GetMaxNegativeAuraModifierByAffectMask(AuraType auraType, SpellInfo const* affectedSpell) const;
 
+        // must be called whenever an aura effect of this type is registered, unregistered or changes its amount
+        void InvalidateAuraModifierCache(AuraType auraType) { ++m_auraModifierVersions[auraType]; }
+
         void UpdateResistanceBuffModsMod(SpellSchools school);
         void InitStatBuffMods();
         void UpdateStatBuffMod(Stats stat);
@@ -1529,6 +1537,9 @@ class TC_GAME_API Unit : public WorldObject
         Powers GetPowerTypeByAuraGroup(UnitMods unitMod) const;
         bool CanModifyStats() const { return m_canModifyStats; }
         void SetCanModifyStats(bool modifyStats) { m_canModifyStats = modifyStats; }
+        // between these calls UpdateUnitMod only marks the UnitMods dirty, the last End recalculates every dirty one once
+        void BeginStatUpdateBatch() { ++m_statUpdateBatchDepth; }
+        void EndStatUpdateBatch();
         virtual bool UpdateStats(Stats stat) = 0;
         virtual bool UpdateAllStats() = 0;
         virtual void UpdateResistances(uint32 school) = 0;
@@ -1865,7 +1876,52 @@ class TC_GAME_API Unit : public WorldObject
         AuraMap::iterator m_auraUpdateIterator;
         uint32 m_removedAurasCount;
 
+        struct ProcAuraIndexEntry
+        {
+            uint32 SpellId;
+            uint32 ProcFlags;
+            AuraApplication* AurApp;
+        };
+
+        // applied auras which can proc, kept in the same order as m_appliedAuras
+        std::vector<ProcAuraIndexEntry> m_procAuraIndex;
+        uint32 m_procAuraIndexFlags;                       // ProcFlags of all indexed auras combined
+        uint32 m_procAuraIndexGeneration;                  // SpellMgr::GetSpellProcGeneration() the index was built for
+        void _AddToProcAuraIndex(AuraApplication* aurApp);
+        void _RemoveFromProcAuraIndex(AuraApplication* aurApp);
+        void _RebuildProcAuraIndex();
+
         AuraEffectList m_modAuras[TOTAL_AURAS];
+
+        enum AuraModifierAggregate : uint8
+        {
+            AURA_MODIFIER_TOTAL,
+            AURA_MODIFIER_TOTAL_MULTIPLIER,
+            AURA_MODIFIER_MAX_POSITIVE,
+            AURA_MODIFIER_MAX_NEGATIVE
+        };
+
+        enum AuraModifierFilter : uint8
+        {
+            AURA_MODIFIER_FILTER_NONE,
+            AURA_MODIFIER_FILTER_MISC_MASK,
+            AURA_MODIFIER_FILTER_MISC_VALUE
+        };
+
+        struct AuraModifierCacheEntry
+        {
+            uint32 Version;
+            int32 Modifier;
+            float Multiplier;
+        };
+
+        // results of GetTotalAuraModifier & co. without custom predicates, valid while the version of their aura type is unchanged
+        uint32 m_auraModifierVersions[TOTAL_AURAS];
+        mutable std::unordered_map<uint64, AuraModifierCacheEntry> m_auraModifierCache;
+
+        template<typename T, typename Calculator>
+        T GetCachedAuraModifier(AuraType auraType, AuraModifierAggregate aggregate, AuraModifierFilter filter, uint32 miscValue, Calculator calculator) const;
+
         AuraList m_scAuras;                        // cast singlecast auras
         AuraApplicationList m_interruptableAuras;  // auras which have interrupt mask applied on unit
         AuraStateAurasMap m_auraStateAuras;        // Used for improve performance of aura state checks on aura apply/remove
@@ -1875,6 +1931,11 @@ class TC_GAME_API Unit : public WorldObject
         float m_auraPctModifiersGroup[UNIT_MOD_END][MODIFIER_TYPE_PCT_END];
         float m_weaponDamage[MAX_ATTACK][2][2];
         bool m_canModifyStats;
+        uint32 m_statUpdateBatchDepth;
+        std::bitset<UNIT_MOD_END> m_dirtyUnitMods;
+
+        // recalculates the UnitMods changed during a stat update batch
+        virtual void UpdateDirtyUnitMods(std::bitset<UNIT_MOD_END> const& dirtyUnitMods);
 
         VisibleAuraMap m_visibleAuras;
 
@@ -1986,6 +2047,20 @@ class TC_GAME_API Unit : public WorldObject
         /* Player Movement fields END*/
 };
 
+// defers the stat recalculation of a unit to the end of the scope, see Unit::BeginStatUpdateBatch
+class StatUpdateBatch
+{
+    public:
+        explicit StatUpdateBatch(Unit* unit) : _unit(unit) { _unit->BeginStatUpdateBatch(); }
+        ~StatUpdateBatch() { _unit->EndStatUpdateBatch(); }
+
+        StatUpdateBatch(StatUpdateBatch const&) = delete;
+        StatUpdateBatch& operator=(StatUpdateBatch const&) = delete;
+
+    private:
+        Unit* _unit;
+};
+
 namespace Trinity
 {
     // Binary predicate for sorting Units based on percent value of a power
@@ -27,9 +27,21 @@
 #include "ObjectMgr.h"
 #include "Pet.h"
 #include "Player.h"
+#include "ShardedRegistry.h"
 #include "Transport.h"
 #include "World.h"
 
+namespace
+{
+    // lookups go through the registry without locking, the container guarded by GetLock() is kept for iteration
+    template<class T>
+    Trinity::ShardedRegistry<ObjectGuid, T*>& GetRegistry()
+    {
+        static Trinity::ShardedRegistry<ObjectGuid, T*> _registry;
+        return _registry;
+    }
+}
+
 template<class T>
 void HashMapHolder<T>::Insert(T* o)
 {
@@ -40,6 +52,7 @@ void HashMapHolder<T>::Insert(T* o)
     std::unique_lock<std::shared_mutex> lock(*GetLock());
 
     GetContainer()[o->GetGUID()] = o;
+    GetRegistry<T>().Insert(o->GetGUID(), o);
 }
 
 template<class T>
@@ -48,15 +61,13 @@ void HashMapHolder<T>::Remove(T* o)
     std::unique_lock<std::shared_mutex> lock(*GetLock());
 
     GetContainer().erase(o->GetGUID());
+    GetRegistry<T>().Remove(o->GetGUID());
 }
 
 template<class T>
 T* HashMapHolder<T>::Find(ObjectGuid guid)
 {
-    std::shared_lock<std::shared_mutex> lock(*GetLock());
-
-    typename MapType::iterator itr = GetContainer().find(guid);
-    return (itr != GetContainer().end()) ? itr->second : nullptr;
+    return GetRegistry<T>().Find(guid);
 }
 
 template<class T>
@@ -83,17 +94,17 @@ template class TC_GAME_API HashMapHolder<Transport>;
 
 namespace PlayerNameMapHolder
 {
-    typedef std::unordered_map<std::string, Player*> MapType;
+    typedef Trinity::ShardedRegistry<std::string, Player*> MapType;
     static MapType PlayerNameMap;
 
     void Insert(Player* p)
     {
-        PlayerNameMap[p->GetName()] = p;
+        PlayerNameMap.Insert(p->GetName(), p);
     }
 
     void Remove(Player* p)
     {
-        PlayerNameMap.erase(p->GetName());
+        PlayerNameMap.Remove(p->GetName());
     }
 
     Player* Find(std::string_view name)
@@ -102,8 +113,7 @@ namespace PlayerNameMapHolder
         if (!normalizePlayerName(charName))
             return nullptr;
 
-        auto itr = PlayerNameMap.find(charName);
-        return (itr != PlayerNameMap.end()) ? itr->second : nullptr;
+        return PlayerNameMap.Find(charName);
     }
 } // namespace PlayerNameMapHolder
 
@@ -118,12 +118,17 @@ namespace Trinity
     {
         WorldObject const* i_source;
         WorldPacket const* i_message;
+        std::size_t i_messageCount;
         uint32 i_phaseMask;
         float i_distSq;
         uint32 team;
         Player const* skipped_receiver;
         MessageDistDeliverer(WorldObject const* src, WorldPacket const* msg, float dist, bool own_team_only = false, Player const* skipped = nullptr)
-            : i_source(src), i_message(msg), i_phaseMask(src->GetPhaseMask()), i_distSq(dist * dist)
+            : MessageDistDeliverer(src, msg, 1, dist, own_team_only, skipped) { }
+
+        // delivers an array of messageCount packets with a single visit
+        MessageDistDeliverer(WorldObject const* src, WorldPacket const* msg, std::size_t messageCount, float dist, bool own_team_only = false, Player const* skipped = nullptr)
+            : i_source(src), i_message(msg), i_messageCount(messageCount), i_phaseMask(src->GetPhaseMask()), i_distSq(dist * dist)
             , team(0)
             , skipped_receiver(skipped)
         {
@@ -146,7 +151,8 @@ namespace Trinity
             if (!player->HaveAtClient(i_source))
                 return;
 
-            player->SendDirectMessage(i_message);
+            for (std::size_t i = 0; i < i_messageCount; ++i)
+                player->SendDirectMessage(&i_message[i]);
         }
     };
 
@@ -48,6 +48,7 @@
 #include "Weather.h"
 #include "WeatherMgr.h"
 #include "World.h"
+#include <boost/container/small_vector.hpp>
 #include <unordered_set>
 #include <vector>
 
@@ -233,6 +234,9 @@ void Map::LoadMap(int gx, int gy, bool reload)
     sScriptMgr->OnLoadGridMap(this, GridMaps[gx][gy], gx, gy);
 }
 
+// map query cache statistics are sent every this many map updates
+static constexpr uint32 MAP_QUERY_CACHE_METRIC_INTERVAL = 128;
+
 void Map::LoadMapAndVMap(int gx, int gy)
 {
     LoadMap(gx, gy);
@@ -241,7 +245,118 @@ void Map::LoadMapAndVMap(int gx, int gy)
     {
         LoadVMap(gx, gy);
         LoadMMap(gx, gy);
+        OnStaticTileChanged(gx, gy);
+    }
+}
+
+void Map::OnStaticTileChanged(int gx, int gy)
+{
+    // results computed with the old set of tiles are no longer valid, in every instance of the map
+    uint32 generation = ++_staticTileGeneration;
+
+    // instanced maps load the tiles of their base map from their own update threads, they drop their whole caches on their next query
+    if (Instanceable())
+        return;
+
+    // nobody else uses the tiles of this map, only the entries touching the grid are dropped
+    InvalidateQueryCaches(gx, gy);
+    _queryCacheTileGeneration = generation;
+}
+
+void Map::InvalidateQueryCaches(int gx, int gy)
+{
+    if (!_lineOfSightCache.IsEnabled())
+        return;
+
+    // world bounds of the grid
+    float const minX = (CENTER_GRID_ID - gx - 1) * SIZE_OF_GRIDS;
+    float const maxX = (CENTER_GRID_ID - gx) * SIZE_OF_GRIDS;
+    float const minY = (CENTER_GRID_ID - gy - 1) * SIZE_OF_GRIDS;
+    float const maxY = (CENTER_GRID_ID - gy) * SIZE_OF_GRIDS;
+
+    // vmap trees only hold models overlapping their own tiles, so only queries touching the grid can change
+    _lineOfSightCache.Invalidate([&](MapLineOfSightCacheKey const& key)
+    {
+        float x1 = GetExactMapQueryCoordValue(key.Values[0]);
+        float y1 = GetExactMapQueryCoordValue(key.Values[1]);
+        float x2 = GetExactMapQueryCoordValue(key.Values[3]);
+        float y2 = GetExactMapQueryCoordValue(key.Values[4]);
+        return std::min(x1, x2) <= maxX && std::max(x1, x2) >= minX && std::min(y1, y2) <= maxY && std::max(y1, y2) >= minY;
+    });
+
+    // quantized bounds, widened by one step for the rounding of the keys
+    int32 const minQuantizedX = QuantizeMapQueryCoord(minX) - 1;
+    int32 const maxQuantizedX = QuantizeMapQueryCoord(maxX) + 1;
+    int32 const minQuantizedY = QuantizeMapQueryCoord(minY) - 1;
+    int32 const maxQuantizedY = QuantizeMapQueryCoord(maxY) + 1;
+    auto isInGrid = [&](int32 x, int32 y)
+    {
+        return x >= minQuantizedX && x <= maxQuantizedX && y >= minQuantizedY && y <= maxQuantizedY;
+    };
+
+    _heightCache.Invalidate([&](MapHeightCacheKey const& key) { return isInGrid(key.Values[0], key.Values[1]); });
+    _areaInfoCache.Invalidate([&](MapAreaInfoCacheKey const& key) { return isInGrid(key.Values[0], key.Values[1]); });
+}
+
+void Map::ValidateQueryCaches() const
+{
+    uint32 generation = m_parentMap->_staticTileGeneration.load(std::memory_order_acquire);
+    if (generation == _queryCacheTileGeneration)
+        return;
+
+    // a vmap tile of this map was loaded or unloaded by another instance
+    _lineOfSightCache.Clear();
+    _heightCache.Clear();
+    _areaInfoCache.Clear();
+    _queryCacheTileGeneration = generation;
+}
+
+void Map::UpdateQueryCacheMetrics()
+{
+    if (!_lineOfSightCache.IsEnabled() || ++_queryCacheMetricTicks < MAP_QUERY_CACHE_METRIC_INTERVAL)
+        return;
+
+    _queryCacheMetricTicks = 0;
+    if (sMetric->IsEnabled())
+    {
+        std::string mapIdTag = std::to_string(GetId());
+        std::string instanceIdTag = std::to_string(GetInstanceId());
+        auto sendMetrics = [&](char const* type, uint64 hits, uint64 misses, uint32 entries)
+        {
+            TC_METRIC_VALUE("map_query_cache_hit_ratio", hits + misses ? float(hits) / float(hits + misses) : 0.0f,
+                TC_METRIC_TAG("map_id", mapIdTag),
+                TC_METRIC_TAG("map_instanceid", instanceIdTag),
+                TC_METRIC_TAG("type", type));
+
+            TC_METRIC_VALUE("map_query_cache_hits", hits,
+                TC_METRIC_TAG("map_id", mapIdTag),
+                TC_METRIC_TAG("map_instanceid", instanceIdTag),
+                TC_METRIC_TAG("type", type));
+
+            TC_METRIC_VALUE("map_query_cache_misses", misses,
+                TC_METRIC_TAG("map_id", mapIdTag),
+                TC_METRIC_TAG("map_instanceid", instanceIdTag),
+                TC_METRIC_TAG("type", type));
+
+            TC_METRIC_VALUE("map_query_cache_entries", uint64(entries),
+                TC_METRIC_TAG("map_id", mapIdTag),
+                TC_METRIC_TAG("map_instanceid", instanceIdTag),
+                TC_METRIC_TAG("type", type));
+        };
+
+        sendMetrics("los", _lineOfSightCache.GetHits(), _lineOfSightCache.GetMisses(), _lineOfSightCache.GetEntryCount());
+        sendMetrics("height", _heightCache.GetHits(), _heightCache.GetMisses(), _heightCache.GetEntryCount());
+        sendMetrics("area", _areaInfoCache.GetHits(), _areaInfoCache.GetMisses(), _areaInfoCache.GetEntryCount());
+
+        TC_METRIC_VALUE("map_query_cache_memory", uint64(_lineOfSightCache.GetMemoryUsage() + _heightCache.GetMemoryUsage() + _areaInfoCache.GetMemoryUsage()),
+            TC_METRIC_TAG("map_id", mapIdTag),
+            TC_METRIC_TAG("map_instanceid", instanceIdTag));
     }
+
+    // the hit counters cover one interval
+    _lineOfSightCache.ResetHitCounters();
+    _heightCache.ResetHitCounters();
+    _areaInfoCache.ResetHitCounters();
 }
 
 void Map::LoadAllCells()
@@ -271,6 +386,7 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode, Map* _par
 _creatureToMoveLock(false), _gameObjectsToMoveLock(false), _dynamicObjectsToMoveLock(false),
 i_mapEntry(sMapStore.LookupEntry(id)), i_spawnMode(SpawnMode), i_InstanceId(InstanceId),
 m_unloadTimer(0), m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE),
+_staticTileGeneration(0), _queryCacheTileGeneration(0), _queryCacheMetricTicks(0),
 m_VisibilityNotifyPeriod(DEFAULT_VISIBILITY_NOTIFY_PERIOD),
 m_activeNonPlayersIter(m_activeNonPlayers.end()), _transportsUpdateIter(_transports.end()),
 i_gridExpiry(expiry),
@@ -294,6 +410,11 @@ i_scriptLock(false), _respawnCheckTimer(0)
 
     _weatherUpdateTimer.SetInterval(time_t(1 * IN_MILLISECONDS));
 
+    uint32 queryCacheSize = sWorld->getIntConfig(CONFIG_MAP_QUERY_CACHE_SIZE);
+    _lineOfSightCache.Resize(queryCacheSize);
+    _heightCache.Resize(queryCacheSize);
+    _areaInfoCache.Resize(queryCacheSize);
+
     sScriptMgr->OnCreateMap(this);
 }
 
@@ -758,123 +879,151 @@ void Map::UpdatePlayerZoneStats(uint32 oldZone, uint32 newZone)
 
 void Map::Update(uint32 t_diff)
 {
-    _dynamicTree.update(t_diff);
+    _updateProfiler.StartTick();
+
+    {
+        MapUpdateProfiler::PhaseTimer phaseTimer(_updateProfiler, MAP_UPDATE_PHASE_DYNAMIC_TREE);
+        _dynamicTree.update(t_diff);
+    }
+
     /// update worldsessions for existing players
-    for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
     {
-        Player* player = m_mapRefIter->GetSource();
-        if (player && player->IsInWorld())
+        MapUpdateProfiler::PhaseTimer phaseTimer(_updateProfiler, MAP_UPDATE_PHASE_SESSIONS);
+        for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
         {
-            //player->Update(t_diff);
-            WorldSession* session = player->GetSession();
-            MapSessionFilter updater(session);
-            session->Update(t_diff, updater);
+            Player* player = m_mapRefIter->GetSource();
+            if (player && player->IsInWorld())
+            {
+                //player->Update(t_diff);
+                WorldSession* session = player->GetSession();
+                MapSessionFilter updater(session);
+                session->Update(t_diff, updater);
+            }
         }
     }
 
     /// process any due respawns
     if (_respawnCheckTimer <= t_diff)
     {
+        MapUpdateProfiler::PhaseTimer phaseTimer(_updateProfiler, MAP_UPDATE_PHASE_RESPAWNS);
         ProcessRespawns();
         _respawnCheckTimer = sWorld->getIntConfig(CONFIG_RESPAWN_MINCHECKINTERVALMS);
     }
     else
         _respawnCheckTimer -= t_diff;
 
-    /// update active cells around players and active objects
-    resetMarkedCells();
-
     Trinity::ObjectUpdater updater(t_diff);
     // for creature
     TypeContainerVisitor<Trinity::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
     // for pets
     TypeContainerVisitor<Trinity::ObjectUpdater, WorldTypeMapContainer > world_object_update(updater);
 
-    // the player iterator is stored in the map object
-    // to make sure calls to Map::Remove don't invalidate it
-    for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
     {
-        Player* player = m_mapRefIter->GetSource();
+        MapUpdateProfiler::PhaseTimer phaseTimer(_updateProfiler, MAP_UPDATE_PHASE_PLAYERS);
 
-        if (!player || !player->IsInWorld())
-            continue;
+        /// update active cells around players and active objects
+        resetMarkedCells();
+
+        // the player iterator is stored in the map object
+        // to make sure calls to Map::Remove don't invalidate it
+        for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+        {
+            Player* player = m_mapRefIter->GetSource();
 
-        // update players at tick
-        player->Update(t_diff);
+            if (!player || !player->IsInWorld())
+                continue;
 
-        VisitNearbyCellsOf(player, grid_object_update, world_object_update);
+            // update players at tick
+            player->Update(t_diff);
 
-        // If player is using far sight or mind vision, visit that object too
-        if (WorldObject* viewPoint = player->GetViewpoint())
-            VisitNearbyCellsOf(viewPoint, grid_object_update, world_object_update);
+            VisitNearbyCellsOf(player, grid_object_update, world_object_update);
 
-        // Handle updates for creatures in combat with player and are more than 60 yards away
-        if (player->IsInCombat())
-        {
-            std::vector<Unit*> toVisit;
-            for (auto const& pair : player->GetCombatManager().GetPvECombatRefs())
-                if (Creature* unit = pair.second->GetOther(player)->ToCreature())
-                    if (unit->GetMapId() == player->GetMapId() && !unit->IsWithinDistInMap(player, GetVisibilityRange(), false))
-                        toVisit.push_back(unit);
-            for (Unit* unit : toVisit)
-                VisitNearbyCellsOf(unit, grid_object_update, world_object_update);
-        }
+            // If player is using far sight or mind vision, visit that object too
+            if (WorldObject* viewPoint = player->GetViewpoint())
+                VisitNearbyCellsOf(viewPoint, grid_object_update, world_object_update);
 
-        { // Update any creatures that own auras the player has applications of
-            std::unordered_set<Unit*> toVisit;
-            for (std::pair<uint32, AuraApplication*> pair : player->GetAppliedAuras())
+            // Handle updates for creatures in combat with player and are more than 60 yards away
+            if (player->IsInCombat())
             {
-                if (Unit* caster = pair.second->GetBase()->GetCaster())
-                    if (caster->GetTypeId() != TYPEID_PLAYER && !caster->IsWithinDistInMap(player, GetVisibilityRange(), false))
-                        toVisit.insert(caster);
+                std::vector<Unit*> toVisit;
+                for (auto const& pair : player->GetCombatManager().GetPvECombatRefs())
+                    if (Creature* unit = pair.second->GetOther(player)->ToCreature())
+                        if (unit->GetMapId() == player->GetMapId() && !unit->IsWithinDistInMap(player, GetVisibilityRange(), false))
+                            toVisit.push_back(unit);
+                for (Unit* unit : toVisit)
+                    VisitNearbyCellsOf(unit, grid_object_update, world_object_update);
+            }
+
+            { // Update any creatures that own auras the player has applications of
+                std::unordered_set<Unit*> toVisit;
+                for (std::pair<uint32, AuraApplication*> pair : player->GetAppliedAuras())
+                {
+                    if (Unit* caster = pair.second->GetBase()->GetCaster())
+                        if (caster->GetTypeId() != TYPEID_PLAYER && !caster->IsWithinDistInMap(player, GetVisibilityRange(), false))
+                            toVisit.insert(caster);
+                }
+                for (Unit* unit : toVisit)
+                    VisitNearbyCellsOf(unit, grid_object_update, world_object_update);
             }
-            for (Unit* unit : toVisit)
-                VisitNearbyCellsOf(unit, grid_object_update, world_object_update);
-        }
 
-        { // Update player's summons
-            std::vector<Unit*> toVisit;
+            { // Update player's summons
+                std::vector<Unit*> toVisit;
 
-            // Totems
-            for (ObjectGuid const& summonGuid : player->m_SummonSlot)
-                if (summonGuid)
-                    if (Creature* unit = GetCreature(summonGuid))
-                        if (unit->GetMapId() == player->GetMapId() && !unit->IsWithinDistInMap(player, GetVisibilityRange(), false))
-                            toVisit.push_back(unit);
+                // Totems
+                for (ObjectGuid const& summonGuid : player->m_SummonSlot)
+                    if (summonGuid)
+                        if (Creature* unit = GetCreature(summonGuid))
+                            if (unit->GetMapId() == player->GetMapId() && !unit->IsWithinDistInMap(player, GetVisibilityRange(), false))
+                                toVisit.push_back(unit);
 
-            for (Unit* unit : toVisit)
-                VisitNearbyCellsOf(unit, grid_object_update, world_object_update);
+                for (Unit* unit : toVisit)
+                    VisitNearbyCellsOf(unit, grid_object_update, world_object_update);
+            }
         }
     }
 
     // non-player active objects, increasing iterator in the loop in case of object removal
-    for (m_activeNonPlayersIter = m_activeNonPlayers.begin(); m_activeNonPlayersIter != m_activeNonPlayers.end();)
     {
-        WorldObject* obj = *m_activeNonPlayersIter;
-        ++m_activeNonPlayersIter;
+        MapUpdateProfiler::PhaseTimer phaseTimer(_updateProfiler, MAP_UPDATE_PHASE_ACTIVE_OBJECTS);
+        for (m_activeNonPlayersIter = m_activeNonPlayers.begin(); m_activeNonPlayersIter != m_activeNonPlayers.end();)
+        {
+            WorldObject* obj = *m_activeNonPlayersIter;
+            ++m_activeNonPlayersIter;
 
-        if (!obj || !obj->IsInWorld())
-            continue;
+            if (!obj || !obj->IsInWorld())
+                continue;
 
-        VisitNearbyCellsOf(obj, grid_object_update, world_object_update);
+            VisitNearbyCellsOf(obj, grid_object_update, world_object_update);
+        }
     }
 
-    for (_transportsUpdateIter = _transports.begin(); _transportsUpdateIter != _transports.end();)
     {
-        WorldObject* obj = *_transportsUpdateIter;
-        ++_transportsUpdateIter;
+        MapUpdateProfiler::PhaseTimer phaseTimer(_updateProfiler, MAP_UPDATE_PHASE_TRANSPORTS);
+        for (_transportsUpdateIter = _transports.begin(); _transportsUpdateIter != _transports.end();)
+        {
+            WorldObject* obj = *_transportsUpdateIter;
+            ++_transportsUpdateIter;
 
-        if (!obj->IsInWorld())
-            continue;
+            if (!obj->IsInWorld())
+                continue;
 
-        obj->Update(t_diff);
+            obj->Update(t_diff);
+        }
     }
 
-    SendObjectUpdates();
+    {
+        MapUpdateProfiler::PhaseTimer phaseTimer(_updateProfiler, MAP_UPDATE_PHASE_OBJECT_UPDATES);
+        // a slot that ends in this update is sent before the health and power changes of this update,
+        // ticks logged in earlier updates of a longer slot arrive after their changes
+        _periodicAuraLogBatch.Update(this, t_diff);
+
+        SendObjectUpdates();
+    }
 
     ///- Process necessary scripts
     if (!m_scriptSchedule.empty())
     {
+        MapUpdateProfiler::PhaseTimer phaseTimer(_updateProfiler, MAP_UPDATE_PHASE_SCRIPTS);
         i_scriptLock = true;
         ScriptsProcess();
         i_scriptLock = false;
@@ -883,6 +1032,7 @@ void Map::Update(uint32 t_diff)
     _weatherUpdateTimer.Update(t_diff);
     if (_weatherUpdateTimer.Passed())
     {
+        MapUpdateProfiler::PhaseTimer phaseTimer(_updateProfiler, MAP_UPDATE_PHASE_WEATHER);
         for (auto&& zoneInfo : _zoneDynamicInfo)
             if (zoneInfo.second.DefaultWeather && !zoneInfo.second.DefaultWeather->Update(_weatherUpdateTimer.GetInterval()))
                 zoneInfo.second.DefaultWeather.reset();
@@ -890,13 +1040,22 @@ void Map::Update(uint32 t_diff)
         _weatherUpdateTimer.Reset();
     }
 
-    MoveAllCreaturesInMoveList();
-    MoveAllGameObjectsInMoveList();
+    {
+        MapUpdateProfiler::PhaseTimer phaseTimer(_updateProfiler, MAP_UPDATE_PHASE_MOVE_LISTS);
+        MoveAllCreaturesInMoveList();
+        MoveAllGameObjectsInMoveList();
+    }
 
     if (!m_mapRefManager.isEmpty() || !m_activeNonPlayers.empty())
+    {
+        MapUpdateProfiler::PhaseTimer phaseTimer(_updateProfiler, MAP_UPDATE_PHASE_RELOCATION_NOTIFIES);
         ProcessRelocationNotifies(t_diff);
+    }
 
-    sScriptMgr->OnMapUpdate(this, t_diff);
+    {
+        MapUpdateProfiler::PhaseTimer phaseTimer(_updateProfiler, MAP_UPDATE_PHASE_MAP_SCRIPT);
+        sScriptMgr->OnMapUpdate(this, t_diff);
+    }
 
     TC_METRIC_VALUE("map_creatures", uint64(GetObjectsStore().Size<Creature>()),
         TC_METRIC_TAG("map_id", std::to_string(GetId())),
@@ -1712,6 +1871,7 @@ bool Map::UnloadGrid(NGridType& ngrid, bool unloadAll)
             }
             VMAP::VMapFactory::createOrGetVMapManager()->unloadMap(GetId(), gx, gy);
             MMAP::MMapFactory::createOrGetMMapManager()->unloadMap(GetId(), gx, gy);
+            OnStaticTileChanged(gx, gy);
         }
         else
             ((MapInstanced*)m_parentMap)->RemoveGridMapReference(GridCoord(gx, gy));
@@ -1745,6 +1905,9 @@ void Map::UnloadAll()
     _creaturesToMove.clear();
     _gameObjectsToMove.clear();
 
+    // the targets of queued periodic aura logs are still on the map
+    _periodicAuraLogBatch.Flush(this);
+
     for (GridRefManager<NGridType>::iterator i = GridRefManager<NGridType>::begin(); i != GridRefManager<NGridType>::end();)
     {
         NGridType &grid(*i->GetSource());
@@ -2491,7 +2654,20 @@ float Map::GetHeight(float x, float y, float z, bool checkVMap /*= true*/, float
     {
         VMAP::IVMapManager* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
         if (vmgr->isHeightCalcEnabled())
-            vmapHeight = vmgr->getHeight(GetId(), x, y, z, maxSearchDist);
+        {
+            if (_heightCache.IsEnabled())
+            {
+                ValidateQueryCaches();
+                MapHeightCacheKey key = { { QuantizeMapQueryCoord(x), QuantizeMapQueryCoord(y), QuantizeMapQueryCoord(z), QuantizeMapQueryCoord(maxSearchDist) } };
+                if (!_heightCache.Find(key, vmapHeight))
+                {
+                    vmapHeight = vmgr->getHeight(GetId(), x, y, z, maxSearchDist);
+                    _heightCache.Insert(key, vmapHeight);
+                }
+            }
+            else
+                vmapHeight = vmgr->getHeight(GetId(), x, y, z, maxSearchDist);
+        }
     }
 
     // mapHeight set for any above raw ground Z or <= INVALID_HEIGHT
@@ -2552,7 +2728,28 @@ bool Map::GetAreaInfo(uint32 phaseMask, float x, float y, float z, uint32& flags
     int32 drootId;
     int32 dgroupId;
 
-    bool hasVmapAreaInfo = vmgr->getAreaInfo(GetId(), x, y, vmap_z, vflags, vadtId, vrootId, vgroupId);
+    bool hasVmapAreaInfo;
+    if (_areaInfoCache.IsEnabled())
+        ValidateQueryCaches();
+
+    MapAreaInfoCacheKey key = { { QuantizeMapQueryCoord(x), QuantizeMapQueryCoord(y), QuantizeMapQueryCoord(z) } };
+    MapAreaInfoCacheEntry cached;
+    if (_areaInfoCache.IsEnabled() && _areaInfoCache.Find(key, cached))
+    {
+        hasVmapAreaInfo = cached.HasAreaInfo;
+        vflags = cached.Flags;
+        vadtId = cached.AdtId;
+        vrootId = cached.RootId;
+        vgroupId = cached.GroupId;
+        vmap_z = cached.Z;
+    }
+    else
+    {
+        hasVmapAreaInfo = vmgr->getAreaInfo(GetId(), x, y, vmap_z, vflags, vadtId, vrootId, vgroupId);
+        if (_areaInfoCache.IsEnabled())
+            _areaInfoCache.Insert(key, { hasVmapAreaInfo, vflags, vadtId, vrootId, vgroupId, vmap_z });
+    }
+
     bool hasDynamicAreaInfo = _dynamicTree.getAreaInfo(x, y, dynamic_z, phaseMask, dflags, dadtId, drootId, dgroupId);
     auto useVmap = [&]() { check_z = vmap_z; flags = vflags; adtId = vadtId; rootId = vrootId; groupId = vgroupId; };
     auto useDyn = [&]() { check_z = dynamic_z; flags = dflags; adtId = dadtId; rootId = drootId; groupId = dgroupId; };
@@ -2876,10 +3073,27 @@ float Map::GetWaterLevel(float x, float y) const
         return 0;
 }
 
+bool Map::IsInStaticLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, VMAP::ModelIgnoreFlags ignoreFlags) const
+{
+    if (!_lineOfSightCache.IsEnabled())
+        return VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), x1, y1, z1, x2, y2, z2, ignoreFlags);
+
+    ValidateQueryCaches();
+    MapLineOfSightCacheKey key = { { GetExactMapQueryCoord(x1), GetExactMapQueryCoord(y1), GetExactMapQueryCoord(z1),
+        GetExactMapQueryCoord(x2), GetExactMapQueryCoord(y2), GetExactMapQueryCoord(z2), int32(ignoreFlags) } };
+    bool result;
+    if (!_lineOfSightCache.Find(key, result))
+    {
+        result = VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), x1, y1, z1, x2, y2, z2, ignoreFlags);
+        _lineOfSightCache.Insert(key, result);
+    }
+
+    return result;
+}
+
 bool Map::isInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phasemask, LineOfSightChecks checks, VMAP::ModelIgnoreFlags ignoreFlags) const
 {
-    if ((checks & LINEOFSIGHT_CHECK_VMAP)
-      && !VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), x1, y1, z1, x2, y2, z2, ignoreFlags))
+    if ((checks & LINEOFSIGHT_CHECK_VMAP) && !IsInStaticLineOfSight(x1, y1, z1, x2, y2, z2, ignoreFlags))
         return false;
     if (sWorld->getBoolConfig(CONFIG_CHECK_GOBJECT_LOS) && (checks & LINEOFSIGHT_CHECK_GOBJECT)
       && !_dynamicTree.isInLineOfSight(x1, y1, z1, x2, y2, z2, phasemask))
@@ -2887,6 +3101,58 @@ bool Map::isInLineOfSight(float x1, float y1, float z1, float x2, float y2, floa
     return true;
 }
 
+void Map::isInLineOfSight(float const* segments, bool* results, uint32 count, uint32 phasemask, LineOfSightChecks checks, VMAP::ModelIgnoreFlags ignoreFlags) const
+{
+    auto makeCacheKey = [segments, ignoreFlags](uint32 i)
+    {
+        float const* segment = segments + i * 6;
+        return MapLineOfSightCacheKey{ { GetExactMapQueryCoord(segment[0]), GetExactMapQueryCoord(segment[1]), GetExactMapQueryCoord(segment[2]),
+            GetExactMapQueryCoord(segment[3]), GetExactMapQueryCoord(segment[4]), GetExactMapQueryCoord(segment[5]), int32(ignoreFlags) } };
+    };
+
+    if ((checks & LINEOFSIGHT_CHECK_VMAP) && _lineOfSightCache.IsEnabled())
+    {
+        ValidateQueryCaches();
+
+        // only trace the segments that are not cached yet, as one batch
+        boost::container::small_vector<uint32, VMAP::LOS_BATCH_INLINE_SIZE> missing;
+        boost::container::small_vector<float, VMAP::LOS_BATCH_INLINE_SIZE * 6> missingSegments;
+        for (uint32 i = 0; i < count; ++i)
+        {
+            if (!_lineOfSightCache.Find(makeCacheKey(i), results[i]))
+            {
+                missing.push_back(i);
+                missingSegments.insert(missingSegments.end(), segments + i * 6, segments + i * 6 + 6);
+            }
+        }
+
+        if (!missing.empty())
+        {
+            boost::container::small_vector<bool, VMAP::LOS_BATCH_INLINE_SIZE> missingResults(missing.size());
+            VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), missingSegments.data(), missingResults.data(), uint32(missing.size()), ignoreFlags);
+            for (std::size_t j = 0; j < missing.size(); ++j)
+            {
+                results[missing[j]] = missingResults[j];
+                _lineOfSightCache.Insert(makeCacheKey(missing[j]), missingResults[j]);
+            }
+        }
+    }
+    else if (checks & LINEOFSIGHT_CHECK_VMAP)
+        VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), segments, results, count, ignoreFlags);
+    else
+        std::fill(results, results + count, true);
+
+    if (sWorld->getBoolConfig(CONFIG_CHECK_GOBJECT_LOS) && (checks & LINEOFSIGHT_CHECK_GOBJECT))
+    {
+        for (uint32 i = 0; i < count; ++i)
+        {
+            float const* segment = segments + i * 6;
+            if (results[i])
+                results[i] = _dynamicTree.isInLineOfSight(segment[0], segment[1], segment[2], segment[3], segment[4], segment[5], phasemask);
+        }
+    }
+}
+
 bool Map::getObjectHitPos(uint32 phasemask, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float& ry, float& rz, float modifyDist)
 {
     G3D::Vector3 startPos(x1, y1, z1);
@@ -3523,7 +3789,22 @@ void Map::DelayedUpdate(uint32 t_diff)
         transport->DelayedUpdate(t_diff);
     }
 
-    RemoveAllObjectsInRemoveList();
+    {
+        MapUpdateProfiler::PhaseTimer phaseTimer(_updateProfiler, MAP_UPDATE_PHASE_REMOVE_LIST);
+        RemoveAllObjectsInRemoveList();
+    }
+
+    if (_updateProfiler.FinishTick(Milliseconds(sWorld->getIntConfig(CONFIG_MAP_UPDATE_SPIKE_THRESHOLD))))
+    {
+        MapUpdateProfiler::TickTimes const& spike = _updateProfiler.GetLastSpike();
+        std::string breakdown = MapUpdateProfiler::FormatPhaseBreakdown(spike);
+        TC_LOG_WARN("maps", "Map::DelayedUpdate: Map %u instance %u update took %u ms: %s",
+            GetId(), GetInstanceId(), spike.TotalTime / 1000, breakdown.c_str());
+        TC_METRIC_EVENT("map_update_spikes", Trinity::StringFormat("Map %u instance %u update took %u ms", GetId(), GetInstanceId(), spike.TotalTime / 1000), breakdown);
+    }
+
+    _updateProfiler.UpdateMetrics(GetId(), GetInstanceId());
+    UpdateQueryCacheMetrics();
 
     // Don't unload grids if it's battleground, since we may have manually added GOs, creatures, those doesn't load from DB at grid re-load !
     // This isn't really bother us, since as soon as we have instanced BG-s, the whole map unloads as the BG gets ended
@@ -24,8 +24,11 @@
 #include "DynamicTree.h"
 #include "GridDefines.h"
 #include "GridRefManager.h"
+#include "MapQueryCache.h"
 #include "MapRefManager.h"
+#include "MapUpdateProfiler.h"
 #include "MPSCQueue.h"
+#include "PeriodicAuraLogBatch.h"
 #include "ObjectGuid.h"
 #include "Optional.h"
 #include "SharedDefines.h"
@@ -33,6 +36,7 @@
 #include "Timer.h"
 #include "Transaction.h"
 #include <boost/heap/fibonacci_heap.hpp>
+#include <atomic>
 #include <bitset>
 #include <list>
 #include <memory>
@@ -525,6 +529,10 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
 
         MapStoredObjectTypesContainer& GetObjectsStore() { return _objectsStore; }
 
+        PeriodicAuraLogBatch& GetPeriodicAuraLogBatch() { return _periodicAuraLogBatch; }
+
+        MapUpdateProfiler const& GetUpdateProfiler() const { return _updateProfiler; }
+
         typedef std::unordered_multimap<ObjectGuid::LowType, Creature*> CreatureBySpawnIdContainer;
         CreatureBySpawnIdContainer& GetCreatureBySpawnIdStore() { return _creatureBySpawnIdStore; }
         CreatureBySpawnIdContainer const& GetCreatureBySpawnIdStore() const { return _creatureBySpawnIdStore; }
@@ -568,9 +576,12 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         float GetHeight(uint32 phasemask, float x, float y, float z, bool vmap = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const { return std::max<float>(GetHeight(x, y, z, vmap, maxSearchDist), GetGameObjectFloor(phasemask, x, y, z, maxSearchDist)); }
         float GetHeight(uint32 phasemask, Position const& pos, bool vmap = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const { return GetHeight(phasemask, pos.GetPositionX(), pos.GetPositionY(), pos.GetPositionZ(), vmap, maxSearchDist); }
         bool isInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phasemask, LineOfSightChecks checks, VMAP::ModelIgnoreFlags ignoreFlags) const;
+        // many rays at once (x1, y1, z1, x2, y2, z2 sextuplets), results[i] is set to true if the end of segment i is in line of sight of its start
+        void isInLineOfSight(float const* segments, bool* results, uint32 count, uint32 phasemask, LineOfSightChecks checks, VMAP::ModelIgnoreFlags ignoreFlags) const;
         void Balance() { _dynamicTree.balance(); }
         void RemoveGameObjectModel(GameObjectModel const& model) { _dynamicTree.remove(model); }
         void InsertGameObjectModel(GameObjectModel const& model) { _dynamicTree.insert(model); }
+        void RelocateGameObjectModel(GameObjectModel const& model) { _dynamicTree.relocate(model); }
         bool ContainsGameObjectModel(GameObjectModel const& model) const { return _dynamicTree.contains(model);}
         float GetGameObjectFloor(uint32 phasemask, float x, float y, float z, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const
         {
@@ -717,6 +728,22 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         float m_VisibleDistance;
         DynamicMapTree _dynamicTree;
 
+        // results of static vmap queries, dynamic gameobject geometry is never cached
+        mutable MapQueryCache<MapLineOfSightCacheKey, bool> _lineOfSightCache;
+        mutable MapQueryCache<MapHeightCacheKey, float> _heightCache;
+        mutable MapQueryCache<MapAreaInfoCacheKey, MapAreaInfoCacheEntry> _areaInfoCache;
+        // bumped by the base map whenever one of its vmap tiles is loaded or unloaded, the tiles are shared by all instances
+        std::atomic<uint32> _staticTileGeneration;
+        mutable uint32 _queryCacheTileGeneration;
+        uint32 _queryCacheMetricTicks;
+        PeriodicAuraLogBatch _periodicAuraLogBatch;
+        MapUpdateProfiler _updateProfiler;
+        void OnStaticTileChanged(int gx, int gy);
+        void InvalidateQueryCaches(int gx, int gy);
+        void ValidateQueryCaches() const;
+        void UpdateQueryCacheMetrics();
+        bool IsInStaticLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, VMAP::ModelIgnoreFlags ignoreFlags) const;
+
         MapRefManager m_mapRefManager;
         MapRefManager::iterator m_mapRefIter;
 
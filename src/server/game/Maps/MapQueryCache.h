@@ -0,0 +1,204 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITYCORE_MAP_QUERY_CACHE_H
+#define TRINITYCORE_MAP_QUERY_CACHE_H
+
+#include "Define.h"
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+// height and area info coordinates are snapped to 1/64 yard before they are used as cache keys
+static constexpr float MAP_QUERY_CACHE_QUANTIZATION = 64.0f;
+
+inline int32 QuantizeMapQueryCoord(float coord)
+{
+    return int32(std::floor(coord * MAP_QUERY_CACHE_QUANTIZATION));
+}
+
+// line of sight keys hold the exact bits of the coordinates, a result is only reused for the very same segment
+inline int32 GetExactMapQueryCoord(float coord)
+{
+    int32 bits;
+    memcpy(&bits, &coord, sizeof(bits));
+    return bits;
+}
+
+inline float GetExactMapQueryCoordValue(int32 bits)
+{
+    float coord;
+    memcpy(&coord, &bits, sizeof(coord));
+    return coord;
+}
+
+template<uint32 N>
+struct MapQueryCacheKey
+{
+    int32 Values[N];
+
+    bool operator==(MapQueryCacheKey const& right) const { return memcmp(Values, right.Values, sizeof(Values)) == 0; }
+
+    uint32 GetHash() const
+    {
+        // FNV-1a over the key words
+        uint32 hash = 2166136261u;
+        for (int32 value : Values)
+        {
+            hash ^= uint32(value);
+            hash *= 16777619u;
+        }
+        return hash ^ (hash >> 15);
+    }
+};
+
+/**
+    Fixed size, set associative cache for results of static map geometry queries (vmap line of sight, height, area info).
+    Every set holds Ways entries, the least recently used entry of a set is replaced on insert.
+    Memory is allocated once in Resize, lookups and inserts never allocate.
+    Not thread safe, every map owns its caches and only queries them from the thread updating it.
+*/
+template<class Key, class Value, uint32 Ways = 4>
+class MapQueryCache
+{
+public:
+    MapQueryCache() : _setMask(0), _clock(0), _entries(0), _hits(0), _misses(0) { }
+
+    // rounds entries down to a power of two number of sets, 0 disables the cache
+    void Resize(uint32 entries)
+    {
+        uint32 sets = 0;
+        if (entries >= Ways)
+        {
+            sets = 1;
+            while (sets * 2 * Ways <= entries)
+                sets *= 2;
+        }
+
+        _slots.assign(sets * Ways, Slot());
+        _slots.shrink_to_fit();
+        _setMask = sets ? sets - 1 : 0;
+        _entries = 0;
+    }
+
+    bool IsEnabled() const { return !_slots.empty(); }
+
+    bool Find(Key const& key, Value& value)
+    {
+        Slot* set = GetSet(key);
+        for (uint32 i = 0; i < Ways; ++i)
+        {
+            if (set[i].Stamp && set[i].CacheKey == key)
+            {
+                set[i].Stamp = ++_clock;
+                value = set[i].CacheValue;
+                ++_hits;
+                return true;
+            }
+        }
+
+        ++_misses;
+        return false;
+    }
+
+    void Insert(Key const& key, Value const& value)
+    {
+        Slot* set = GetSet(key);
+        Slot* victim = &set[0];
+        for (uint32 i = 0; i < Ways; ++i)
+        {
+            if (!set[i].Stamp || set[i].CacheKey == key)
+            {
+                victim = &set[i];
+                break;
+            }
+
+            if (set[i].Stamp < victim->Stamp)
+                victim = &set[i];
+        }
+
+        if (!victim->Stamp)
+            ++_entries;
+
+        victim->CacheKey = key;
+        victim->CacheValue = value;
+        victim->Stamp = ++_clock;
+    }
+
+    // drops every entry whose key matches the predicate
+    template<class Predicate>
+    void Invalidate(Predicate&& predicate)
+    {
+        for (Slot& slot : _slots)
+        {
+            if (slot.Stamp && predicate(slot.CacheKey))
+            {
+                slot.Stamp = 0;
+                --_entries;
+            }
+        }
+    }
+
+    void Clear()
+    {
+        for (Slot& slot : _slots)
+            slot.Stamp = 0;
+
+        _entries = 0;
+    }
+
+    uint64 GetHits() const { return _hits; }
+    uint64 GetMisses() const { return _misses; }
+    void ResetHitCounters() { _hits = 0; _misses = 0; }
+    uint32 GetEntryCount() const { return _entries; }
+    std::size_t GetMemoryUsage() const { return _slots.capacity() * sizeof(Slot); }
+
+private:
+    struct Slot
+    {
+        Slot() : CacheKey(), CacheValue(), Stamp(0) { }
+
+        Key CacheKey;
+        Value CacheValue;
+        uint64 Stamp;       // last access, 0 for empty slots. 64 bits never wrap, so recent entries never look the oldest
+    };
+
+    Slot* GetSet(Key const& key) { return &_slots[(key.GetHash() & _setMask) * Ways]; }
+
+    std::vector<Slot> _slots;
+    uint32 _setMask;
+    uint64 _clock;
+    uint32 _entries;
+    uint64 _hits;
+    uint64 _misses;
+};
+
+typedef MapQueryCacheKey<7> MapLineOfSightCacheKey;     // exact start, end, ignore flags
+typedef MapQueryCacheKey<4> MapHeightCacheKey;          // position, search distance
+typedef MapQueryCacheKey<3> MapAreaInfoCacheKey;        // position
+
+struct MapAreaInfoCacheEntry
+{
+    bool HasAreaInfo;
+    uint32 Flags;
+    int32 AdtId;
+    int32 RootId;
+    int32 GroupId;
+    float Z;
+};
+
+#endif // TRINITYCORE_MAP_QUERY_CACHE_H
@@ -0,0 +1,146 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapUpdateProfiler.h"
+#include "Metric.h"
+#include "StringFormat.h"
+#include <algorithm>
+#include <limits>
+
+void MapUpdateProfiler::StartTick()
+{
+    _currentTick = TickTimes();
+    _tickStarted = true;
+}
+
+void MapUpdateProfiler::AddPhaseTime(MapUpdatePhase phase, std::chrono::nanoseconds time)
+{
+    uint64 micros = std::min<uint64>(std::chrono::duration_cast<std::chrono::microseconds>(time).count(), std::numeric_limits<uint32>::max());
+    _currentTick.PhaseTime[phase] += uint32(micros);
+    _currentTick.TotalTime += uint32(micros);
+}
+
+bool MapUpdateProfiler::FinishTick(Milliseconds spikeThreshold)
+{
+    // maps created during the world update get their first DelayedUpdate before any Update
+    if (!_tickStarted)
+        return false;
+
+    _tickStarted = false;
+    _history[_nextSample] = _currentTick;
+    _nextSample = (_nextSample + 1) % HISTORY_SIZE;
+    _sampleCount = std::min(_sampleCount + 1, HISTORY_SIZE);
+
+    if (spikeThreshold <= Milliseconds::zero() || _currentTick.TotalTime < uint64(std::chrono::duration_cast<std::chrono::microseconds>(spikeThreshold).count()))
+        return false;
+
+    _lastSpike = _currentTick;
+    return true;
+}
+
+std::chrono::microseconds MapUpdateProfiler::GetPercentile(MapUpdatePhase phase, float percentile) const
+{
+    if (!_sampleCount)
+        return std::chrono::microseconds::zero();
+
+    std::array<uint32, HISTORY_SIZE> samples;
+    for (uint32 i = 0; i < _sampleCount; ++i)
+        samples[i] = phase < MAX_MAP_UPDATE_PHASES ? _history[i].PhaseTime[phase] : _history[i].TotalTime;
+
+    uint32 index = std::min(uint32(_sampleCount * percentile / 100.0f), _sampleCount - 1);
+    std::nth_element(samples.begin(), samples.begin() + index, samples.begin() + _sampleCount);
+    return std::chrono::microseconds(samples[index]);
+}
+
+std::string MapUpdateProfiler::FormatPhaseBreakdown(TickTimes const& tick)
+{
+    std::array<MapUpdatePhase, MAX_MAP_UPDATE_PHASES> phases;
+    for (uint8 i = 0; i < MAX_MAP_UPDATE_PHASES; ++i)
+        phases[i] = MapUpdatePhase(i);
+
+    std::stable_sort(phases.begin(), phases.end(), [&](MapUpdatePhase left, MapUpdatePhase right)
+    {
+        return tick.PhaseTime[left] > tick.PhaseTime[right];
+    });
+
+    std::string breakdown;
+    for (MapUpdatePhase phase : phases)
+    {
+        // anything below a tenth of a millisecond is noise
+        if (tick.PhaseTime[phase] < 100)
+            break;
+
+        if (!breakdown.empty())
+            breakdown += ", ";
+
+        breakdown += Trinity::StringFormat("%s %.1f ms", GetPhaseName(phase), tick.PhaseTime[phase] / 1000.0f);
+    }
+
+    return breakdown;
+}
+
+char const* MapUpdateProfiler::GetPhaseName(MapUpdatePhase phase)
+{
+    switch (phase)
+    {
+        case MAP_UPDATE_PHASE_DYNAMIC_TREE:         return "dynamic_tree";
+        case MAP_UPDATE_PHASE_SESSIONS:             return "sessions";
+        case MAP_UPDATE_PHASE_RESPAWNS:             return "respawns";
+        case MAP_UPDATE_PHASE_PLAYERS:              return "players";
+        case MAP_UPDATE_PHASE_ACTIVE_OBJECTS:       return "active_objects";
+        case MAP_UPDATE_PHASE_TRANSPORTS:           return "transports";
+        case MAP_UPDATE_PHASE_OBJECT_UPDATES:       return "object_updates";
+        case MAP_UPDATE_PHASE_SCRIPTS:              return "scripts";
+        case MAP_UPDATE_PHASE_WEATHER:              return "weather";
+        case MAP_UPDATE_PHASE_MOVE_LISTS:           return "move_lists";
+        case MAP_UPDATE_PHASE_RELOCATION_NOTIFIES:  return "relocation_notifies";
+        case MAP_UPDATE_PHASE_MAP_SCRIPT:           return "map_script";
+        case MAP_UPDATE_PHASE_REMOVE_LIST:          return "remove_list";
+        default:
+            break;
+    }
+
+    return "total";
+}
+
+void MapUpdateProfiler::UpdateMetrics(uint32 mapId, uint32 instanceId)
+{
+    // a full window of new ticks was recorded since the last call
+    if (_nextSample || _sampleCount < HISTORY_SIZE || !sMetric->IsEnabled())
+        return;
+
+    std::string mapIdTag = std::to_string(mapId);
+    std::string instanceIdTag = std::to_string(instanceId);
+    for (uint8 i = 0; i <= MAX_MAP_UPDATE_PHASES; ++i)
+    {
+        MapUpdatePhase phase = MapUpdatePhase(i);
+        TC_METRIC_VALUE("map_update_phase_time_p50", uint64(GetPercentile(phase, 50.0f).count()),
+            TC_METRIC_TAG("map_id", mapIdTag),
+            TC_METRIC_TAG("map_instanceid", instanceIdTag),
+            TC_METRIC_TAG("phase", GetPhaseName(phase)));
+
+        TC_METRIC_VALUE("map_update_phase_time_p99", uint64(GetPercentile(phase, 99.0f).count()),
+            TC_METRIC_TAG("map_id", mapIdTag),
+            TC_METRIC_TAG("map_instanceid", instanceIdTag),
+            TC_METRIC_TAG("phase", GetPhaseName(phase)));
+
+        TC_METRIC_VALUE("map_update_phase_time_max", uint64(GetPercentile(phase, 100.0f).count()),
+            TC_METRIC_TAG("map_id", mapIdTag),
+            TC_METRIC_TAG("map_instanceid", instanceIdTag),
+            TC_METRIC_TAG("phase", GetPhaseName(phase)));
+    }
+}
@@ -0,0 +1,107 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITYCORE_MAP_UPDATE_PROFILER_H
+#define TRINITYCORE_MAP_UPDATE_PROFILER_H
+
+#include "Define.h"
+#include "Duration.h"
+#include <array>
+#include <string>
+
+enum MapUpdatePhase : uint8
+{
+    MAP_UPDATE_PHASE_DYNAMIC_TREE,
+    MAP_UPDATE_PHASE_SESSIONS,
+    MAP_UPDATE_PHASE_RESPAWNS,
+    MAP_UPDATE_PHASE_PLAYERS,               // players and the grid objects around them
+    MAP_UPDATE_PHASE_ACTIVE_OBJECTS,
+    MAP_UPDATE_PHASE_TRANSPORTS,
+    MAP_UPDATE_PHASE_OBJECT_UPDATES,        // periodic aura log and SendObjectUpdates
+    MAP_UPDATE_PHASE_SCRIPTS,
+    MAP_UPDATE_PHASE_WEATHER,
+    MAP_UPDATE_PHASE_MOVE_LISTS,
+    MAP_UPDATE_PHASE_RELOCATION_NOTIFIES,
+    MAP_UPDATE_PHASE_MAP_SCRIPT,            // ScriptMgr::OnMapUpdate
+    MAP_UPDATE_PHASE_REMOVE_LIST,           // Map::DelayedUpdate
+
+    MAX_MAP_UPDATE_PHASES
+};
+
+/**
+    Phase times of the last HISTORY_SIZE ticks of a single map.
+    A tick starts in Map::Update and ends after the remove list is processed in Map::DelayedUpdate,
+    it is only accessed by the thread updating the map and by the world thread while no maps are updated.
+*/
+class TC_GAME_API MapUpdateProfiler
+{
+public:
+    // ticks used for the rolling percentiles, also the interval in ticks at which they are sent to Metric
+    static constexpr uint32 HISTORY_SIZE = 128;
+
+    struct TickTimes
+    {
+        std::array<uint32, MAX_MAP_UPDATE_PHASES> PhaseTime = { };  // microseconds
+        uint32 TotalTime = 0;                                       // microseconds, sum of all phases
+    };
+
+    class PhaseTimer
+    {
+    public:
+        PhaseTimer(MapUpdateProfiler& profiler, MapUpdatePhase phase) : _profiler(profiler), _phase(phase), _start(std::chrono::steady_clock::now()) { }
+        ~PhaseTimer() { _profiler.AddPhaseTime(_phase, std::chrono::steady_clock::now() - _start); }
+
+        PhaseTimer(PhaseTimer const&) = delete;
+        PhaseTimer& operator=(PhaseTimer const&) = delete;
+
+    private:
+        MapUpdateProfiler& _profiler;
+        MapUpdatePhase _phase;
+        TimePoint _start;
+    };
+
+    MapUpdateProfiler() : _tickStarted(false), _nextSample(0), _sampleCount(0) { }
+
+    void StartTick();
+    void AddPhaseTime(MapUpdatePhase phase, std::chrono::nanoseconds time);
+
+    // stores the tick in the history, returns true if it took at least spikeThreshold (0 disables spike capture)
+    bool FinishTick(Milliseconds spikeThreshold);
+
+    // percentile over the recorded ticks, MAX_MAP_UPDATE_PHASES selects the total tick time
+    std::chrono::microseconds GetPercentile(MapUpdatePhase phase, float percentile) const;
+    uint32 GetSampleCount() const { return _sampleCount; }
+
+    // last tick that exceeded the spike threshold
+    TickTimes const& GetLastSpike() const { return _lastSpike; }
+    static std::string FormatPhaseBreakdown(TickTimes const& tick);
+
+    static char const* GetPhaseName(MapUpdatePhase phase);
+
+    // sends the percentiles to Metric every HISTORY_SIZE ticks
+    void UpdateMetrics(uint32 mapId, uint32 instanceId);
+
+private:
+    TickTimes _currentTick;
+    bool _tickStarted;
+    std::array<TickTimes, HISTORY_SIZE> _history;
+    uint32 _nextSample;
+    uint32 _sampleCount;
+    TickTimes _lastSpike;
+};
+
+#endif // TRINITYCORE_MAP_UPDATE_PROFILER_H
@@ -0,0 +1,125 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PeriodicAuraLogBatch.h"
+#include "CellImpl.h"
+#include "GridNotifiers.h"
+#include "GridNotifiersImpl.h"
+#include "Map.h"
+#include "Opcodes.h"
+#include "Pet.h"
+#include "Player.h"
+#include "SpellAuraEffects.h"
+#include "World.h"
+#include <algorithm>
+#include <tuple>
+
+namespace
+{
+    Unit* GetTarget(Map* map, ObjectGuid const& guid)
+    {
+        if (guid.IsPlayer())
+            return map->GetPlayer(guid);
+
+        if (guid.IsPet())
+            return map->GetPet(guid);
+
+        return map->GetCreature(guid);
+    }
+}
+
+bool PeriodicAuraLogBatch::Add(Unit const* target, SpellPeriodicAuraLogInfo const* info)
+{
+    if (!sWorld->getIntConfig(CONFIG_PERIODIC_AURA_LOG_BATCH_INTERVAL))
+        return false;
+
+    Entry entry;
+    entry.Target = target->GetGUID();
+    entry.Caster = info->auraEff->GetCasterGUID();
+    entry.SpellId = info->auraEff->GetId();
+    entry.Offset = uint32(_entryData.wpos());
+    if (Unit::BuildPeriodicAuraLogEntry(_entryData, info))
+    {
+        entry.Size = uint32(_entryData.wpos()) - entry.Offset;
+        _entries.push_back(entry);
+    }
+
+    return true;
+}
+
+void PeriodicAuraLogBatch::Update(Map* map, uint32 diff)
+{
+    _slotTimer += diff;
+    if (_slotTimer >= sWorld->getIntConfig(CONFIG_PERIODIC_AURA_LOG_BATCH_INTERVAL))
+        Flush(map);
+}
+
+void PeriodicAuraLogBatch::Flush(Map* map)
+{
+    _slotTimer = 0;
+    if (_entries.empty())
+        return;
+
+    // ticks of the same target, caster and spell keep the order they were logged in
+    std::stable_sort(_entries.begin(), _entries.end(), [](Entry const& left, Entry const& right)
+    {
+        return std::tie(left.Target, left.Caster, left.SpellId) < std::tie(right.Target, right.Caster, right.SpellId);
+    });
+
+    for (auto targetBegin = _entries.begin(); targetBegin != _entries.end();)
+    {
+        auto targetEnd = std::find_if(targetBegin, _entries.end(), [&](Entry const& entry) { return entry.Target != targetBegin->Target; });
+
+        // the target may have left the map since its ticks were logged
+        Unit* target = GetTarget(map, targetBegin->Target);
+        if (target && target->IsInWorld())
+        {
+            _packets.clear();
+            for (auto groupBegin = targetBegin; groupBegin != targetEnd;)
+            {
+                auto groupEnd = std::find_if(groupBegin, targetEnd, [&](Entry const& entry)
+                {
+                    return entry.Caster != groupBegin->Caster || entry.SpellId != groupBegin->SpellId;
+                });
+
+                _packets.emplace_back(SMSG_PERIODICAURALOG, 30);
+                WorldPacket& data = _packets.back();
+                data << target->GetPackGUID();
+                data << groupBegin->Caster.WriteAsPacked();
+                data << uint32(groupBegin->SpellId);
+                data << uint32(std::distance(groupBegin, groupEnd));    // count
+                for (auto itr = groupBegin; itr != groupEnd; ++itr)
+                    data.append(_entryData.contents() + itr->Offset, itr->Size);
+
+                groupBegin = groupEnd;
+            }
+
+            if (Player* player = target->ToPlayer())
+                for (WorldPacket const& data : _packets)
+                    player->SendDirectMessage(&data);
+
+            float const range = target->GetVisibilityRange();
+            Trinity::MessageDistDeliverer notifier(target, _packets.data(), _packets.size(), range);
+            Cell::VisitWorldObjects(target, notifier, range);
+        }
+
+        targetBegin = targetEnd;
+    }
+
+    _entries.clear();
+    _entryData.clear();
+}
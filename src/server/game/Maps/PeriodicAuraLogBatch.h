@@ -0,0 +1,64 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITYCORE_PERIODIC_AURA_LOG_BATCH_H
+#define TRINITYCORE_PERIODIC_AURA_LOG_BATCH_H
+
+#include "Define.h"
+#include "ByteBuffer.h"
+#include "ObjectGuid.h"
+#include "WorldPacket.h"
+#include <vector>
+
+class Map;
+class Unit;
+struct SpellPeriodicAuraLogInfo;
+
+/**
+    Collects the SMSG_PERIODICAURALOG entries of all periodic ticks on one map during a time slot (PeriodicAura.LogBatchInterval).
+    At the end of the slot ticks with the same target, caster and spell are sent as one packet and all packets
+    of a target are delivered with a single visit of the surrounding cells.
+*/
+class TC_GAME_API PeriodicAuraLogBatch
+{
+public:
+    PeriodicAuraLogBatch() : _slotTimer(0) { }
+
+    // queues the log of a periodic tick, returns false if batching is disabled and the caller has to send it
+    bool Add(Unit const* target, SpellPeriodicAuraLogInfo const* info);
+
+    // sends the queued logs if the current slot has ended
+    void Update(Map* map, uint32 diff);
+    void Flush(Map* map);
+
+private:
+    struct Entry
+    {
+        ObjectGuid Target;
+        ObjectGuid Caster;
+        uint32 SpellId;
+        uint32 Offset;      // aura type and tick data in _entryData
+        uint32 Size;
+    };
+
+    std::vector<Entry> _entries;
+    ByteBuffer _entryData;
+    std::vector<WorldPacket> _packets;
+    uint32 _slotTimer;
+};
+
+#endif // TRINITYCORE_PERIODIC_AURA_LOG_BATCH_H
@@ -23,12 +23,13 @@
 #include "MovementDefines.h"
 #include "MoveSpline.h"
 #include "MoveSplineInit.h"
+#include "PathGenerator.h"
 #include "World.h"
 
 //----- Point Movement Generator
 
 template<class T>
-PointMovementGenerator<T>::PointMovementGenerator(uint32 id, float x, float y, float z, bool generatePath, float speed, Optional<float> finalOrient) : _movementId(id), _x(x), _y(y), _z(z), _speed(speed), _generatePath(generatePath), _finalOrient(finalOrient)
+PointMovementGenerator<T>::PointMovementGenerator(uint32 id, float x, float y, float z, bool generatePath, float speed, Optional<float> finalOrient) : _movementId(id), _x(x), _y(y), _z(z), _speed(speed), _generatePath(generatePath), _pathDistance(0.0f), _finalOrient(finalOrient)
 {
     this->Mode = MOTION_MODE_DEFAULT;
     this->Priority = MOTION_PRIORITY_NORMAL;
@@ -72,6 +73,7 @@ void PointMovementGenerator<T>::DoInitialize(T* owner)
         init.SetFacing(*_finalOrient);
 
     init.Launch();
+    _pathDistance = _generatePath ? owner->GetExactDist2d(_x, _y) : 0.0f;
 
     // Call for creature group update
     if (Creature* creature = owner->ToCreature())
@@ -120,6 +122,7 @@ bool PointMovementGenerator<T>::DoUpdate(T* owner, uint32 /*diff*/)
         if (_speed > 0.0f) // Default value for point motion type is 0.0, if 0.0 spline will use GetSpeed on unit
             init.SetVelocity(_speed);
         init.Launch();
+        _pathDistance = _generatePath ? owner->GetExactDist2d(_x, _y) : 0.0f;
 
         // Call for creature group update
         if (Creature* creature = owner->ToCreature())
@@ -128,6 +131,26 @@ bool PointMovementGenerator<T>::DoUpdate(T* owner, uint32 /*diff*/)
 
     if (owner->movespline->Finalized())
     {
+        // long distance paths stop where the path length limit is reached, continue from there as long as we get closer
+        if (_pathDistance > HIERARCHICAL_PATH_SEGMENT_LENGTH)
+        {
+            float distance = owner->GetExactDist2d(_x, _y);
+            if (distance > CONTACT_DISTANCE && distance < _pathDistance - SMOOTH_PATH_STEP_SIZE)
+            {
+                Movement::MoveSplineInit init(owner);
+                init.MoveTo(_x, _y, _z, _generatePath);
+                if (_speed > 0.0f)
+                    init.SetVelocity(_speed);
+
+                if (_finalOrient)
+                    init.SetFacing(*_finalOrient);
+
+                init.Launch();
+                _pathDistance = distance;
+                return true;
+            }
+        }
+
         MovementGenerator::RemoveFlag(MOVEMENTGENERATOR_FLAG_TRANSITORY);
         MovementGenerator::AddFlag(MOVEMENTGENERATOR_FLAG_INFORM_ENABLED);
         return false;
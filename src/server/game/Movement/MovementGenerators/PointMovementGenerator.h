@@ -48,6 +48,8 @@ class PointMovementGenerator : public MovementGeneratorMedium<T, PointMovementGe
         float _x, _y, _z;
         float _speed;
         bool _generatePath;
+        //! 2d distance to the destination when the last path was launched, long paths are only built up to the path length limit
+        float _pathDistance;
         //! if set then unit will turn to specified _orient in provided _pos
         Optional<float> _finalOrient;
 };
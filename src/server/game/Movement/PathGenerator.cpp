@@ -31,7 +31,7 @@ PathGenerator::PathGenerator(WorldObject const* owner) :
     _polyLength(0), _type(PATHFIND_BLANK), _useStraightPath(false),
     _forceDestination(false), _pointPathLimit(MAX_POINT_PATH_LENGTH), _useRaycast(false),
     _endPosition(G3D::Vector3::zero()), _source(owner), _navMesh(nullptr),
-    _navMeshQuery(nullptr)
+    _navMeshQuery(nullptr), _tileGraph(nullptr)
 {
     memset(_pathPolyRefs, 0, sizeof(_pathPolyRefs));
 
@@ -43,6 +43,7 @@ PathGenerator::PathGenerator(WorldObject const* owner) :
         MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
         _navMesh = mmap->GetNavMesh(mapId);
         _navMeshQuery = mmap->GetNavMeshQuery(mapId, _source->GetInstanceId());
+        _tileGraph = mmap->GetTileGraph(mapId);
     }
 
     CreateFilter();
@@ -287,6 +288,10 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
         return;
     }
 
+    // long distance path, built in segments along the coarse tile route
+    if (!_useRaycast && BuildHierarchicalPolyPath(startPoly, startPoint, endPoly, endPoint, startFarFromPoly, endFarFromPoly))
+        return;
+
     // look for startPoly/endPoly in current path
     /// @todo we can merge it with getPathPolyByPosition() loop
     bool startPolyFound = false;
@@ -526,6 +531,185 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
     BuildPointPath(startPoint, endPoint);
 }
 
+bool PathGenerator::BuildHierarchicalPolyPath(dtPolyRef startPoly, float const* startPoint, dtPolyRef endPoly, float const* endPoint, bool startFarFromPoly, bool endFarFromPoly)
+{
+    // forced destinations and custom length limits keep the old behavior of a single bounded path
+    if (!_tileGraph || _forceDestination || _pointPathLimit != MAX_POINT_PATH_LENGTH ||
+        dtVdist2DSqr(startPoint, endPoint) <= HIERARCHICAL_PATH_SEGMENT_LENGTH * HIERARCHICAL_PATH_SEGMENT_LENGTH)
+    {
+        _tileRoute.clear();
+        return false;
+    }
+
+    int32 startTileX, startTileY, endTileX, endTileY;
+    _navMesh->calcTileLoc(startPoint, &startTileX, &startTileY);
+    _navMesh->calcTileLoc(endPoint, &endTileX, &endTileY);
+
+    if (!UpdateTileRoute(startTileX, startTileY, startPoint, endTileX, endTileY, endPoint))
+        return false;
+
+    TC_METRIC_DETAILED_EVENT("mmap_events", "BuildHierarchicalPolyPath", "");
+
+    // the route is a line from start over the portals to the end, it is cut into pieces of HIERARCHICAL_PATH_SEGMENT_LENGTH
+    // every piece is a regular findPath that fits in MAX_PATH_LENGTH, the pieces are joined into one corridor
+    uint32 const routePointCount = uint32(_tileRoute.size()) + 1;
+    auto getRoutePoint = [&](uint32 index) -> float const*
+    {
+        if (index == 0)
+            return startPoint;
+        if (index == routePointCount - 1)
+            return endPoint;
+        return _tileRoute[index].portal;
+    };
+
+    struct SegmentEnd
+    {
+        uint32 polyLength;
+        float point[VERTEX_SIZE];
+    };
+
+    std::vector<SegmentEnd> segmentEnds;
+    dtPolyRef segmentPolyRefs[MAX_PATH_LENGTH];
+    dtPolyRef segmentStartPoly = startPoly;
+    float segmentStart[VERTEX_SIZE];
+    dtVcopy(segmentStart, startPoint);
+    uint32 nextRoutePoint = 1;
+    bool complete = false;
+
+    Clear();
+
+    while (!complete)
+    {
+        float segmentEnd[VERTEX_SIZE];
+        dtVcopy(segmentEnd, segmentStart);
+        float remaining = HIERARCHICAL_PATH_SEGMENT_LENGTH;
+        while (nextRoutePoint < routePointCount)
+        {
+            float const* routePoint = getRoutePoint(nextRoutePoint);
+            float dist = dtVdist2D(segmentEnd, routePoint);
+            if (dist > remaining)
+            {
+                dtVlerp(segmentEnd, segmentEnd, routePoint, remaining / dist);
+                break;
+            }
+
+            remaining -= dist;
+            dtVcopy(segmentEnd, routePoint);
+            ++nextRoutePoint;
+        }
+
+        bool lastSegment = nextRoutePoint == routePointCount;
+        dtPolyRef segmentEndPoly = endPoly;
+        if (!lastSegment)
+        {
+            // points between portals only have interpolated heights
+            float extents[VERTEX_SIZE] = { 5.0f, 50.0f, 5.0f };
+            float snappedEnd[VERTEX_SIZE];
+            if (dtStatusFailed(_navMeshQuery->findNearestPoly(segmentEnd, extents, &_filter, &segmentEndPoly, snappedEnd)) || segmentEndPoly == INVALID_POLYREF)
+            {
+                TC_LOG_DEBUG("maps.mmaps", "++ BuildHierarchicalPolyPath :: no polygon near segment end (%.2f, %.2f, %.2f) for %s", segmentEnd[2], segmentEnd[0], segmentEnd[1], _source->GetGUID().ToString().c_str());
+                Clear();
+                _tileRoute.clear();
+                return false;
+            }
+
+            dtVcopy(segmentEnd, snappedEnd);
+        }
+
+        uint32 segmentPolyLength = 0;
+        dtStatus dtResult = _navMeshQuery->findPath(
+                                segmentStartPoly,   // start polygon
+                                segmentEndPoly,     // end polygon
+                                segmentStart,       // start position
+                                segmentEnd,         // end position
+                                &_filter,           // polygon search filter
+                                segmentPolyRefs,    // [out] path
+                                (int*)&segmentPolyLength,
+                                MAX_PATH_LENGTH);   // max number of polygons in output path
+
+        if (!segmentPolyLength || dtStatusFailed(dtResult) || segmentPolyRefs[segmentPolyLength - 1] != segmentEndPoly)
+        {
+            // the coarse route does not know about the filter, the tiles may only be connected for other movement types
+            TC_LOG_DEBUG("maps.mmaps", "++ BuildHierarchicalPolyPath :: segment %u failed for %s, using a regular path", uint32(segmentEnds.size()), _source->GetGUID().ToString().c_str());
+            Clear();
+            _tileRoute.clear();
+            return false;
+        }
+
+        // segments share their start polygon with the end of the previous one
+        uint32 firstNewPoly = _polyLength ? 1 : 0;
+        if (_polyLength + segmentPolyLength - firstNewPoly > MAX_PATH_LENGTH)
+            break;
+
+        std::copy(segmentPolyRefs + firstNewPoly, segmentPolyRefs + segmentPolyLength, _pathPolyRefs + _polyLength);
+        _polyLength += segmentPolyLength - firstNewPoly;
+
+        SegmentEnd& end = segmentEnds.emplace_back();
+        end.polyLength = _polyLength;
+        dtVcopy(end.point, segmentEnd);
+
+        segmentStartPoly = segmentEndPoly;
+        dtVcopy(segmentStart, segmentEnd);
+        complete = lastSegment;
+    }
+
+    TC_LOG_DEBUG("maps.mmaps", "++ BuildHierarchicalPolyPath :: route length %u tiles, %u segments, poly-size %u, complete %u", uint32(_tileRoute.size()), uint32(segmentEnds.size()), _polyLength, uint32(complete));
+
+    // the point path has its own limit, drop segments from the end until it fits
+    while (true)
+    {
+        if (complete && !startFarFromPoly && !endFarFromPoly)
+            _type = PATHFIND_NORMAL;
+        else
+            _type = PATHFIND_INCOMPLETE;
+
+        AddFarFromPolyFlags(startFarFromPoly, endFarFromPoly);
+
+        BuildPointPath(startPoint, segmentEnds.back().point);
+        if (!(_type & PATHFIND_SHORT) || segmentEnds.size() == 1)
+            break;
+
+        segmentEnds.pop_back();
+        _polyLength = segmentEnds.back().polyLength;
+        complete = false;
+    }
+
+    return true;
+}
+
+bool PathGenerator::UpdateTileRoute(int32 startTileX, int32 startTileY, float const* startPoint, int32 endTileX, int32 endTileY, float const* endPoint)
+{
+    if (startTileX == endTileX && startTileY == endTileY)
+    {
+        _tileRoute.clear();
+        return false;
+    }
+
+    // reuse the previous route if we are still on it and heading to the same tile
+    if (!_tileRoute.empty() && _tileRoute.back().tileX == endTileX && _tileRoute.back().tileY == endTileY)
+    {
+        auto itr = std::find_if(_tileRoute.begin(), _tileRoute.end(), [startTileX, startTileY](MMAP::MMapTileRouteStep const& step)
+        {
+            return step.tileX == startTileX && step.tileY == startTileY;
+        });
+
+        if (itr != _tileRoute.end() && std::next(itr) != _tileRoute.end())
+        {
+            _tileRoute.erase(_tileRoute.begin(), itr);
+            return true;
+        }
+    }
+
+    if (!_tileGraph->FindRoute(startTileX, startTileY, startPoint, endTileX, endTileY, endPoint, _tileRoute))
+    {
+        TC_LOG_DEBUG("maps.mmaps", "++ UpdateTileRoute :: no tile route from [%d, %d] to [%d, %d] for %s", startTileX, startTileY, endTileX, endTileY, _source->GetGUID().ToString().c_str());
+        _tileRoute.clear();
+        return false;
+    }
+
+    return _tileRoute.size() > 1;
+}
+
 void PathGenerator::BuildPointPath(const float *startPoint, const float *endPoint)
 {
     float pathPoints[MAX_POINT_PATH_LENGTH*VERTEX_SIZE];
@@ -21,8 +21,10 @@
 #include "MapDefines.h"
 #include "DetourNavMesh.h"
 #include "DetourNavMeshQuery.h"
+#include "MMapTileGraph.h"
 #include "MoveSplineInitArgs.h"
 #include <G3D/Vector3.h>
+#include <vector>
 
 class Unit;
 class WorldObject;
@@ -33,6 +35,10 @@ class WorldObject;
 #define MAX_PATH_LENGTH         74
 #define MAX_POINT_PATH_LENGTH   74
 
+// paths longer than this are first routed over the mmap tile graph, the route is then cut into
+// segments of this length that are joined as long as the path fits in MAX_PATH_LENGTH/MAX_POINT_PATH_LENGTH
+#define HIERARCHICAL_PATH_SEGMENT_LENGTH    120.0f
+
 #define SMOOTH_PATH_STEP_SIZE   4.0f
 #define SMOOTH_PATH_SLOP        0.3f
 
@@ -104,6 +110,9 @@ class TC_GAME_API PathGenerator
 
         dtQueryFilter _filter;  // use single filter for all movements, update it when needed
 
+        MMAP::MMapTileGraph const* _tileGraph;          // tile level graph used for long distance paths
+        std::vector<MMAP::MMapTileRouteStep> _tileRoute; // coarse route of the last long distance path, reused while the destination tile stays the same
+
         void SetStartPosition(G3D::Vector3 const& point) { _startPosition = point; }
         void SetEndPosition(G3D::Vector3 const& point) { _actualEndPosition = point; _endPosition = point; }
         void SetActualEndPosition(G3D::Vector3 const& point) { _actualEndPosition = point; }
@@ -124,6 +133,8 @@ class TC_GAME_API PathGenerator
         bool HaveTile(G3D::Vector3 const& p) const;
 
         void BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 const& endPos);
+        bool BuildHierarchicalPolyPath(dtPolyRef startPoly, float const* startPoint, dtPolyRef endPoly, float const* endPoint, bool startFarFromPoly, bool endFarFromPoly);
+        bool UpdateTileRoute(int32 startTileX, int32 startTileY, float const* startPoint, int32 endTileX, int32 endTileY, float const* endPoint);
         void BuildPointPath(float const* startPoint, float const* endPoint);
         void BuildShortcut();
 
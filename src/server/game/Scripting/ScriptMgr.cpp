@@ -28,6 +28,7 @@
 #include "LFGScripts.h"
 #include "Log.h"
 #include "MapManager.h"
+#include "Metric.h"
 #include "ObjectMgr.h"
 #include "OutdoorPvPMgr.h"
 #include "Player.h"
@@ -886,6 +887,55 @@ public:
     }
 };
 
+/// This hook is responsible for the opcode dispatch table of ServerScript packet hooks
+template<typename Base>
+class ScriptRegistrySwapHooks<ServerScript, Base>
+    : public ScriptRegistrySwapHookBase
+{
+public:
+    void BeforeReleaseContext(std::string const& /*context*/) final override
+    {
+        _packetHooks.clear();
+    }
+
+    void BeforeSwapContext(bool /*initialize*/) override
+    {
+        _packetHooks.assign(NUM_MSG_TYPES, { });
+        for (auto const& [context, script] : static_cast<Base*>(this)->GetScripts())
+        {
+            if (script->GetPacketOpcodes().empty())
+            {
+                for (std::vector<ServerScript*>& scripts : _packetHooks)
+                    scripts.push_back(script.get());
+                continue;
+            }
+
+            for (uint16 opcode : script->GetPacketOpcodes())
+            {
+                if (opcode < NUM_MSG_TYPES)
+                    _packetHooks[opcode].push_back(script.get());
+                else
+                    TC_LOG_ERROR("scripts", "ServerScript '%s' subscribed to invalid opcode %u, skipped.", script->GetName().c_str(), opcode);
+            }
+        }
+    }
+
+    void BeforeUnload() final override
+    {
+        _packetHooks.clear();
+    }
+
+    // scripts whose packet hooks are called for the opcode
+    std::vector<ServerScript*> const& GetPacketHooks(uint16 opcode) const
+    {
+        static std::vector<ServerScript*> const none;
+        return opcode < _packetHooks.size() ? _packetHooks[opcode] : none;
+    }
+
+private:
+    std::vector<std::vector<ServerScript*>> _packetHooks;
+};
+
 // Database unbound script registry
 template<typename ScriptType>
 class SpecializedScriptRegistry<ScriptType, false>
@@ -998,7 +1048,12 @@ struct TSpellSummary
     uint8 Effects; // set of enum SelectEffect
 } *SpellSummary;
 
-ScriptObject::ScriptObject(char const* name) : _name(name)
+ScriptObject::ScriptObject(char const* name) : _name(name), _hooks((1u << MAX_SCRIPT_HOOKS) - 1)
+{
+    sScriptMgr->IncreaseScriptCount();
+}
+
+ScriptObject::ScriptObject(char const* name, uint32 hooks) : _name(name), _hooks(hooks)
 {
     sScriptMgr->IncreaseScriptCount();
 }
@@ -1011,6 +1066,8 @@ ScriptObject::~ScriptObject()
 ScriptMgr::ScriptMgr()
     : _scriptCount(0), _script_loader_callback(nullptr)
 {
+    for (std::atomic<uint32>& subscribers : _hookSubscribers)
+        subscribers = 0;
 }
 
 ScriptMgr::~ScriptMgr() { }
@@ -1087,6 +1144,7 @@ void ScriptMgr::SwapScriptContext(bool initialize)
 {
     sScriptRegistryCompositum->SwapContext(initialize);
     _currentContext.clear();
+    UpdateHookSubscribers();
 }
 
 std::string const& ScriptMgr::GetNameOfStaticContext()
@@ -1118,6 +1176,7 @@ std::shared_ptr<ModuleReference>
 void ScriptMgr::Unload()
 {
     sScriptRegistryCompositum->Unload();
+    UpdateHookSubscribers();
 
     delete[] SpellSummary;
     delete[] UnitAI::AISpellInfo;
@@ -1286,22 +1345,26 @@ void ScriptMgr::OnSocketClose(std::shared_ptr<WorldSocket> socket)
 
 void ScriptMgr::OnPacketReceive(WorldSession* session, WorldPacket const& packet)
 {
-    if (SCR_REG_LST(ServerScript).empty())
+    std::vector<ServerScript*> const& scripts = ScriptRegistry<ServerScript>::Instance()->GetPacketHooks(packet.GetOpcode());
+    if (scripts.empty())
         return;
 
-    WorldPacket copy(packet);
-    FOREACH_SCRIPT(ServerScript)->OnPacketReceive(session, copy);
+    ScriptPacketView view(packet);
+    for (ServerScript* script : scripts)
+        script->OnPacketReceive(session, view);
 }
 
 void ScriptMgr::OnPacketSend(WorldSession* session, WorldPacket const& packet)
 {
     ASSERT(session);
 
-    if (SCR_REG_LST(ServerScript).empty())
+    std::vector<ServerScript*> const& scripts = ScriptRegistry<ServerScript>::Instance()->GetPacketHooks(packet.GetOpcode());
+    if (scripts.empty())
         return;
 
-    WorldPacket copy(packet);
-    FOREACH_SCRIPT(ServerScript)->OnPacketSend(session, copy);
+    ScriptPacketView view(packet);
+    for (ServerScript* script : scripts)
+        script->OnPacketSend(session, view);
 }
 
 void ScriptMgr::OnOpenStateChange(bool open)
@@ -1955,7 +2018,7 @@ void ScriptMgr::OnPlayerBindToInstance(Player* player, Difficulty difficulty, ui
 
 void ScriptMgr::OnPlayerUpdateZone(Player* player, uint32 newZone, uint32 newArea)
 {
-    FOREACH_SCRIPT(PlayerScript)->OnUpdateZone(player, newZone, newArea);
+    DispatchHook<SCRIPT_HOOK_PLAYER_ON_UPDATE_ZONE, PlayerScript>([&](PlayerScript* script) { script->OnUpdateZone(player, newZone, newArea); });
 }
 
 void ScriptMgr::OnQuestStatusChange(Player* player, uint32 questId)
@@ -2100,27 +2163,78 @@ void ScriptMgr::OnGroupDisband(Group* group)
 // Unit
 void ScriptMgr::OnHeal(Unit* healer, Unit* reciever, uint32& gain)
 {
-    FOREACH_SCRIPT(UnitScript)->OnHeal(healer, reciever, gain);
+    DispatchHook<SCRIPT_HOOK_UNIT_ON_HEAL, UnitScript>([&](UnitScript* script) { script->OnHeal(healer, reciever, gain); });
 }
 
 void ScriptMgr::OnDamage(Unit* attacker, Unit* victim, uint32& damage)
 {
-    FOREACH_SCRIPT(UnitScript)->OnDamage(attacker, victim, damage);
+    DispatchHook<SCRIPT_HOOK_UNIT_ON_DAMAGE, UnitScript>([&](UnitScript* script) { script->OnDamage(attacker, victim, damage); });
 }
 
 void ScriptMgr::ModifyPeriodicDamageAurasTick(Unit* target, Unit* attacker, uint32& damage)
 {
-    FOREACH_SCRIPT(UnitScript)->ModifyPeriodicDamageAurasTick(target, attacker, damage);
+    DispatchHook<SCRIPT_HOOK_UNIT_MODIFY_PERIODIC_DAMAGE_AURAS_TICK, UnitScript>([&](UnitScript* script) { script->ModifyPeriodicDamageAurasTick(target, attacker, damage); });
 }
 
 void ScriptMgr::ModifyMeleeDamage(Unit* target, Unit* attacker, uint32& damage)
 {
-    FOREACH_SCRIPT(UnitScript)->ModifyMeleeDamage(target, attacker, damage);
+    DispatchHook<SCRIPT_HOOK_UNIT_MODIFY_MELEE_DAMAGE, UnitScript>([&](UnitScript* script) { script->ModifyMeleeDamage(target, attacker, damage); });
 }
 
 void ScriptMgr::ModifySpellDamageTaken(Unit* target, Unit* attacker, int32& damage)
 {
-    FOREACH_SCRIPT(UnitScript)->ModifySpellDamageTaken(target, attacker, damage);
+    DispatchHook<SCRIPT_HOOK_UNIT_MODIFY_SPELL_DAMAGE_TAKEN, UnitScript>([&](UnitScript* script) { script->ModifySpellDamageTaken(target, attacker, damage); });
+}
+
+static char const* GetScriptHookName(ScriptHook hook)
+{
+    static char const* const HookNames[MAX_SCRIPT_HOOKS] =
+    {
+        "UnitScript::OnHeal",
+        "UnitScript::OnDamage",
+        "UnitScript::ModifyPeriodicDamageAurasTick",
+        "UnitScript::ModifyMeleeDamage",
+        "UnitScript::ModifySpellDamageTaken",
+        "PlayerScript::OnUpdateZone"
+    };
+
+    return HookNames[hook];
+}
+
+template<ScriptHook Hook, class ScriptType, class Call>
+void ScriptMgr::DispatchHook(Call&& call)
+{
+    if (!_hookSubscribers[Hook].load(std::memory_order_relaxed))
+        return;
+
+    // every hook has its own instantiation, so the metrics are registered once per hook
+    TC_METRIC_COUNTER("script_hook_calls", 1, TC_METRIC_TAG("hook", GetScriptHookName(Hook)));
+    TC_METRIC_AGGREGATED_TIMER("script_hook_time", TC_METRIC_TAG("hook", GetScriptHookName(Hook)));
+
+    for (auto const& [context, script] : SCR_REG_LST(ScriptType))
+        if (script->IsSubscribedToHook(Hook))
+            call(script.get());
+}
+
+template<class ScriptType>
+void ScriptMgr::CountHookSubscribers(std::initializer_list<ScriptHook> hooks)
+{
+    for (ScriptHook hook : hooks)
+    {
+        uint32 subscribers = 0;
+        for (auto const& [context, script] : SCR_REG_LST(ScriptType))
+            if (script->IsSubscribedToHook(hook))
+                ++subscribers;
+
+        _hookSubscribers[hook] = subscribers;
+    }
+}
+
+void ScriptMgr::UpdateHookSubscribers()
+{
+    CountHookSubscribers<UnitScript>({ SCRIPT_HOOK_UNIT_ON_HEAL, SCRIPT_HOOK_UNIT_ON_DAMAGE, SCRIPT_HOOK_UNIT_MODIFY_PERIODIC_DAMAGE_AURAS_TICK,
+        SCRIPT_HOOK_UNIT_MODIFY_MELEE_DAMAGE, SCRIPT_HOOK_UNIT_MODIFY_SPELL_DAMAGE_TAKEN });
+    CountHookSubscribers<PlayerScript>({ SCRIPT_HOOK_PLAYER_ON_UPDATE_ZONE });
 }
 
 SpellScriptLoader::SpellScriptLoader(char const* name)
@@ -2129,12 +2243,34 @@ SpellScriptLoader::SpellScriptLoader(char const* name)
     ScriptRegistry<SpellScriptLoader>::Instance()->AddScript(this);
 }
 
+ScriptPacketView::ScriptPacketView(WorldPacket const& packet) : _packet(packet) { }
+
+ScriptPacketView::~ScriptPacketView() = default;
+
+uint16 ScriptPacketView::GetOpcode() const
+{
+    return _packet.GetOpcode();
+}
+
+WorldPacket& ScriptPacketView::GetCopy()
+{
+    if (!_copy)
+        _copy = std::make_unique<WorldPacket>(_packet);
+    return *_copy;
+}
+
 ServerScript::ServerScript(char const* name)
     : ScriptObject(name)
 {
     ScriptRegistry<ServerScript>::Instance()->AddScript(this);
 }
 
+ServerScript::ServerScript(char const* name, std::vector<uint16> packetOpcodes)
+    : ScriptObject(name), _packetOpcodes(std::move(packetOpcodes))
+{
+    ScriptRegistry<ServerScript>::Instance()->AddScript(this);
+}
+
 WorldScript::WorldScript(char const* name)
     : ScriptObject(name)
 {
@@ -2153,6 +2289,12 @@ UnitScript::UnitScript(char const* name)
     ScriptRegistry<UnitScript>::Instance()->AddScript(this);
 }
 
+UnitScript::UnitScript(char const* name, uint32 hooks)
+    : ScriptObject(name, hooks)
+{
+    ScriptRegistry<UnitScript>::Instance()->AddScript(this);
+}
+
 WorldMapScript::WorldMapScript(char const* name, uint32 mapId)
     : ScriptObject(name), MapScript<Map>(sMapStore.LookupEntry(mapId))
 {
@@ -2300,6 +2442,12 @@ PlayerScript::PlayerScript(char const* name)
     ScriptRegistry<PlayerScript>::Instance()->AddScript(this);
 }
 
+PlayerScript::PlayerScript(char const* name, uint32 hooks)
+    : ScriptObject(name, hooks)
+{
+    ScriptRegistry<PlayerScript>::Instance()->AddScript(this);
+}
+
 AccountScript::AccountScript(char const* name)
     : ScriptObject(name)
 {
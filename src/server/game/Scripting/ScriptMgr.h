@@ -22,6 +22,10 @@
 #include "ObjectGuid.h"
 #include "Tuples.h"
 #include "Types.h"
+#include <array>
+#include <atomic>
+#include <initializer_list>
+#include <type_traits>
 #include <vector>
 
 class AccountMgr;
@@ -166,6 +170,30 @@ enum XPColorChar : uint8;
     event on all registered scripts of that type.
 */
 
+// Hooks that are only called on scripts subscribed to them. Scripts built with ScriptHooksOf<their class> are subscribed
+// to the hooks their class overrides, scripts built with a constructor without it are subscribed to all of them.
+enum ScriptHook : uint8
+{
+    SCRIPT_HOOK_UNIT_ON_HEAL,
+    SCRIPT_HOOK_UNIT_ON_DAMAGE,
+    SCRIPT_HOOK_UNIT_MODIFY_PERIODIC_DAMAGE_AURAS_TICK,
+    SCRIPT_HOOK_UNIT_MODIFY_MELEE_DAMAGE,
+    SCRIPT_HOOK_UNIT_MODIFY_SPELL_DAMAGE_TAKEN,
+    SCRIPT_HOOK_PLAYER_ON_UPDATE_ZONE,
+
+    MAX_SCRIPT_HOOKS
+};
+
+template<class Script>
+struct ScriptHooksOf { };
+
+// a pointer to an inherited member function has the type of the base class, it only changes if the hook is declared again
+template<class Hook, class BaseHook>
+constexpr uint32 GetScriptHookIfOverridden(ScriptHook hook)
+{
+    return std::is_same_v<Hook, BaseHook> ? 0 : 1u << hook;
+}
+
 class TC_GAME_API ScriptObject
 {
     friend class ScriptMgr;
@@ -174,14 +202,18 @@ class TC_GAME_API ScriptObject
 
         const std::string& GetName() const { return _name; }
 
+        bool IsSubscribedToHook(ScriptHook hook) const { return (_hooks & (1u << hook)) != 0; }
+
     protected:
 
         ScriptObject(char const* name);
+        ScriptObject(char const* name, uint32 hooks);
         virtual ~ScriptObject();
 
     private:
 
         const std::string _name;
+        uint32 const _hooks;
 };
 
 template<class TObject> class UpdatableScript
@@ -214,14 +246,42 @@ class TC_GAME_API SpellScriptLoader : public ScriptObject
         virtual AuraScript* GetAuraScript() const { return nullptr; }
 };
 
+// Packet passed to the ServerScript packet hooks. GetPacket() reads the original packet without copying it,
+// GetCopy() copies it on first use for scripts that need a writable packet, changes to the copy are not sent or handled.
+class TC_GAME_API ScriptPacketView
+{
+    public:
+        explicit ScriptPacketView(WorldPacket const& packet);
+        ~ScriptPacketView();
+
+        ScriptPacketView(ScriptPacketView const&) = delete;
+        ScriptPacketView& operator=(ScriptPacketView const&) = delete;
+
+        WorldPacket const& GetPacket() const { return _packet; }
+        uint16 GetOpcode() const;
+
+        // shared by all scripts of the hook
+        WorldPacket& GetCopy();
+
+    private:
+        WorldPacket const& _packet;
+        std::unique_ptr<WorldPacket> _copy;
+};
+
 class TC_GAME_API ServerScript : public ScriptObject
 {
     protected:
 
         ServerScript(char const* name);
 
+        // OnPacketSend and OnPacketReceive are only called for the given opcodes
+        ServerScript(char const* name, std::vector<uint16> packetOpcodes);
+
     public:
 
+        // Opcodes the packet hooks are called for, all opcodes if empty.
+        std::vector<uint16> const& GetPacketOpcodes() const { return _packetOpcodes; }
+
         // Called when reactive socket I/O is started (WorldTcpSessionMgr).
         virtual void OnNetworkStart() { }
 
@@ -235,13 +295,16 @@ class TC_GAME_API ServerScript : public ScriptObject
         // being open; it is not.
         virtual void OnSocketClose(std::shared_ptr<WorldSocket> /*socket*/) { }
 
-        // Called when a packet is sent to a client. The packet object is a copy of the original packet, so reading
-        // and modifying it is safe.
-        virtual void OnPacketSend(WorldSession* /*session*/, WorldPacket& /*packet*/) { }
+        // Called when a packet with one of the subscribed opcodes is sent to a client. The original packet is only copied
+        // if a script asks for a writable copy.
+        virtual void OnPacketSend(WorldSession* /*session*/, ScriptPacketView& /*packet*/) { }
+
+        // Called when a (valid) packet with one of the subscribed opcodes is received by a client. The original packet is only
+        // copied if a script asks for a writable copy. Make sure to check WorldSession pointer before usage, it might be null in case of auth packets
+        virtual void OnPacketReceive(WorldSession* /*session*/, ScriptPacketView& /*packet*/) { }
 
-        // Called when a (valid) packet is received by a client. The packet object is a copy of the original packet, so
-        // reading and modifying it is safe. Make sure to check WorldSession pointer before usage, it might be null in case of auth packets
-        virtual void OnPacketReceive(WorldSession* /*session*/, WorldPacket& /*packet*/) { }
+    private:
+        std::vector<uint16> _packetOpcodes;
 };
 
 class TC_GAME_API WorldScript : public ScriptObject
@@ -396,6 +459,25 @@ class TC_GAME_API UnitScript : public ScriptObject
 
         UnitScript(char const* name);
 
+        // the hooks are only called if Script overrides them
+        template<class Script>
+        UnitScript(char const* name, ScriptHooksOf<Script>) : UnitScript(name, GetOverriddenHooks<Script>()) { }
+
+    private:
+
+        UnitScript(char const* name, uint32 hooks);
+
+        template<class Script>
+        static constexpr uint32 GetOverriddenHooks()
+        {
+            static_assert(std::is_base_of_v<UnitScript, Script>, "ScriptHooksOf must name the class of the script");
+            return GetScriptHookIfOverridden<decltype(&Script::OnHeal), decltype(&UnitScript::OnHeal)>(SCRIPT_HOOK_UNIT_ON_HEAL)
+                | GetScriptHookIfOverridden<decltype(&Script::OnDamage), decltype(&UnitScript::OnDamage)>(SCRIPT_HOOK_UNIT_ON_DAMAGE)
+                | GetScriptHookIfOverridden<decltype(&Script::ModifyPeriodicDamageAurasTick), decltype(&UnitScript::ModifyPeriodicDamageAurasTick)>(SCRIPT_HOOK_UNIT_MODIFY_PERIODIC_DAMAGE_AURAS_TICK)
+                | GetScriptHookIfOverridden<decltype(&Script::ModifyMeleeDamage), decltype(&UnitScript::ModifyMeleeDamage)>(SCRIPT_HOOK_UNIT_MODIFY_MELEE_DAMAGE)
+                | GetScriptHookIfOverridden<decltype(&Script::ModifySpellDamageTaken), decltype(&UnitScript::ModifySpellDamageTaken)>(SCRIPT_HOOK_UNIT_MODIFY_SPELL_DAMAGE_TAKEN);
+        }
+
     public:
         // Called when a unit deals healing to another unit
         virtual void OnHeal(Unit* /*healer*/, Unit* /*reciever*/, uint32& /*gain*/) { }
@@ -627,6 +709,21 @@ class TC_GAME_API PlayerScript : public ScriptObject
 
         PlayerScript(char const* name);
 
+        // OnUpdateZone is only called if Script overrides it
+        template<class Script>
+        PlayerScript(char const* name, ScriptHooksOf<Script>) : PlayerScript(name, GetOverriddenHooks<Script>()) { }
+
+    private:
+
+        PlayerScript(char const* name, uint32 hooks);
+
+        template<class Script>
+        static constexpr uint32 GetOverriddenHooks()
+        {
+            static_assert(std::is_base_of_v<PlayerScript, Script>, "ScriptHooksOf must name the class of the script");
+            return GetScriptHookIfOverridden<decltype(&Script::OnUpdateZone), decltype(&PlayerScript::OnUpdateZone)>(SCRIPT_HOOK_PLAYER_ON_UPDATE_ZONE);
+        }
+
     public:
 
         // Called when a player kills another player
@@ -1081,11 +1178,24 @@ class TC_GAME_API ScriptMgr
         void ModifyMeleeDamage(Unit* target, Unit* attacker, uint32& damage);
         void ModifySpellDamageTaken(Unit* target, Unit* attacker, int32& damage);
 
+    public: /* Hook subscribers */
+
+        // false if no script is subscribed to the hook
+        bool HasHookSubscribers(ScriptHook hook) const { return _hookSubscribers[hook].load(std::memory_order_relaxed) != 0; }
+
     private:
+        template<ScriptHook Hook, class ScriptType, class Call>
+        void DispatchHook(Call&& call);
+        template<class ScriptType>
+        void CountHookSubscribers(std::initializer_list<ScriptHook> hooks);
+        void UpdateHookSubscribers();
+
         uint32 _scriptCount;
 
         ScriptLoaderCallbackType _script_loader_callback;
 
+        std::array<std::atomic<uint32>, MAX_SCRIPT_HOOKS> _hookSubscribers;
+
         std::string _currentContext;
 };
 
@@ -0,0 +1,227 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OpcodeProfiler.h"
+#include "Metric.h"
+#include "Opcodes.h"
+#include <algorithm>
+
+struct OpcodeProfiler::ThreadStats
+{
+    // only the owning thread writes, so plain loads and stores are enough and no read-modify-write is needed
+    struct Counters
+    {
+        std::atomic<uint64> Count;
+        std::atomic<uint64> Bytes;
+        std::atomic<uint64> TotalTime;
+        std::atomic<uint64> MaxTime;
+        std::atomic<uint64> TotalQueueWait;
+        std::array<std::atomic<uint64>, TIME_BUCKETS> TimeHistogram;
+    };
+
+    static void Add(std::atomic<uint64>& counter, uint64 value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    void Clear()
+    {
+        for (Counters& counters : Opcodes)
+        {
+            counters.Count.store(0, std::memory_order_relaxed);
+            counters.Bytes.store(0, std::memory_order_relaxed);
+            counters.TotalTime.store(0, std::memory_order_relaxed);
+            counters.MaxTime.store(0, std::memory_order_relaxed);
+            counters.TotalQueueWait.store(0, std::memory_order_relaxed);
+            for (std::atomic<uint64>& bucket : counters.TimeHistogram)
+                bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    std::array<Counters, NUM_MSG_TYPES> Opcodes;
+    std::atomic<uint32> Generation;
+    ThreadStats* Next;
+};
+
+namespace
+{
+    uint32 GetTimeBucket(std::chrono::nanoseconds time)
+    {
+        uint64 micros = uint64(std::chrono::duration_cast<std::chrono::microseconds>(time).count());
+        uint32 bucket = 0;
+        while (micros && bucket < OpcodeProfiler::TIME_BUCKETS - 1)
+        {
+            micros >>= 1;
+            ++bucket;
+        }
+        return bucket;
+    }
+}
+
+std::chrono::microseconds OpcodeProfiler::OpcodeStats::GetTimePercentile(float percentile) const
+{
+    uint64 remaining = uint64(Count * percentile / 100.0f);
+    for (uint32 i = 0; i < TIME_BUCKETS; ++i)
+    {
+        if (TimeHistogram[i] > remaining)
+            return std::chrono::microseconds(uint64(1) << i);
+
+        remaining -= TimeHistogram[i];
+    }
+
+    return std::chrono::duration_cast<std::chrono::microseconds>(MaxTime);
+}
+
+OpcodeProfiler::OpcodeProfiler() : _threadStats(nullptr), _resetGeneration(0), _deltaGeneration(0)
+{
+}
+
+OpcodeProfiler::~OpcodeProfiler()
+{
+    ThreadStats* stats = _threadStats.load(std::memory_order_acquire);
+    while (stats)
+    {
+        ThreadStats* next = stats->Next;
+        delete stats;
+        stats = next;
+    }
+}
+
+OpcodeProfiler* OpcodeProfiler::instance()
+{
+    static OpcodeProfiler instance;
+    return &instance;
+}
+
+OpcodeProfiler::ThreadStats* OpcodeProfiler::GetThreadStats()
+{
+    static thread_local ThreadStats* CurrentThreadStats = nullptr;
+    if (!CurrentThreadStats)
+    {
+        ThreadStats* stats = new ThreadStats();
+        stats->Clear();
+        stats->Generation.store(_resetGeneration.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        stats->Next = _threadStats.load(std::memory_order_relaxed);
+        while (!_threadStats.compare_exchange_weak(stats->Next, stats, std::memory_order_release, std::memory_order_relaxed))
+            ;
+
+        CurrentThreadStats = stats;
+    }
+
+    return CurrentThreadStats;
+}
+
+void OpcodeProfiler::Record(uint16 opcode, std::size_t bytes, std::chrono::nanoseconds queueWait, std::chrono::nanoseconds handlerTime)
+{
+    if (opcode >= NUM_MSG_TYPES)
+        return;
+
+    ThreadStats* stats = GetThreadStats();
+
+    uint32 generation = _resetGeneration.load(std::memory_order_relaxed);
+    if (stats->Generation.load(std::memory_order_relaxed) != generation)
+    {
+        stats->Clear();
+        stats->Generation.store(generation, std::memory_order_relaxed);
+    }
+
+    ThreadStats::Counters& counters = stats->Opcodes[opcode];
+    ThreadStats::Add(counters.Count, 1);
+    ThreadStats::Add(counters.Bytes, bytes);
+    ThreadStats::Add(counters.TotalTime, handlerTime.count());
+    ThreadStats::Add(counters.TotalQueueWait, queueWait.count());
+    ThreadStats::Add(counters.TimeHistogram[GetTimeBucket(handlerTime)], 1);
+    if (uint64(handlerTime.count()) > counters.MaxTime.load(std::memory_order_relaxed))
+        counters.MaxTime.store(handlerTime.count(), std::memory_order_relaxed);
+}
+
+std::vector<OpcodeProfiler::OpcodeStats> OpcodeProfiler::GetStats(uint32 generation) const
+{
+    std::vector<OpcodeStats> result(NUM_MSG_TYPES);
+    for (ThreadStats* stats = _threadStats.load(std::memory_order_acquire); stats; stats = stats->Next)
+    {
+        // threads that did not handle a packet since the last reset still hold the old counters
+        if (stats->Generation.load(std::memory_order_relaxed) != generation)
+            continue;
+
+        for (uint32 opcode = 0; opcode < NUM_MSG_TYPES; ++opcode)
+        {
+            ThreadStats::Counters const& counters = stats->Opcodes[opcode];
+            OpcodeStats& total = result[opcode];
+            total.Count += counters.Count.load(std::memory_order_relaxed);
+            total.Bytes += counters.Bytes.load(std::memory_order_relaxed);
+            total.TotalTime += std::chrono::nanoseconds(counters.TotalTime.load(std::memory_order_relaxed));
+            total.MaxTime = std::max(total.MaxTime, std::chrono::nanoseconds(counters.MaxTime.load(std::memory_order_relaxed)));
+            total.TotalQueueWait += std::chrono::nanoseconds(counters.TotalQueueWait.load(std::memory_order_relaxed));
+            for (uint32 i = 0; i < TIME_BUCKETS; ++i)
+                total.TimeHistogram[i] += counters.TimeHistogram[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    return result;
+}
+
+std::vector<OpcodeProfiler::OpcodeStats> OpcodeProfiler::GetStatsSinceLastDelta()
+{
+    uint32 generation = _resetGeneration.load(std::memory_order_relaxed);
+    std::vector<OpcodeStats> stats = GetStats(generation);
+
+    // a reset cleared the counters, everything counted since then is new
+    if (_deltaGeneration != generation || _deltaBaseline.size() != stats.size())
+    {
+        _deltaBaseline.assign(stats.size(), OpcodeStats());
+        _deltaGeneration = generation;
+    }
+
+    std::vector<OpcodeStats> delta = stats;
+    for (uint32 opcode = 0; opcode < stats.size(); ++opcode)
+    {
+        OpcodeStats& current = delta[opcode];
+        OpcodeStats const& previous = _deltaBaseline[opcode];
+        current.Count -= std::min(current.Count, previous.Count);
+        current.Bytes -= std::min(current.Bytes, previous.Bytes);
+        current.TotalTime -= std::min(current.TotalTime, previous.TotalTime);
+        current.TotalQueueWait -= std::min(current.TotalQueueWait, previous.TotalQueueWait);
+        for (uint32 i = 0; i < TIME_BUCKETS; ++i)
+            current.TimeHistogram[i] -= std::min(current.TimeHistogram[i], previous.TimeHistogram[i]);
+    }
+
+    _deltaBaseline = std::move(stats);
+    return delta;
+}
+
+void OpcodeProfiler::UpdateMetrics()
+{
+    if (!sMetric->IsEnabled())
+        return;
+
+    std::vector<OpcodeStats> stats = GetStatsSinceLastDelta();
+    for (uint32 opcode = 0; opcode < stats.size(); ++opcode)
+    {
+        OpcodeStats const& delta = stats[opcode];
+        if (!delta.Count)
+            continue;
+
+        std::string opcodeName = opcodeTable[static_cast<OpcodeClient>(opcode)]->Name;
+        TC_METRIC_VALUE("opcode_count", delta.Count, TC_METRIC_TAG("opcode", opcodeName));
+        TC_METRIC_VALUE("opcode_bytes", delta.Bytes, TC_METRIC_TAG("opcode", opcodeName));
+        TC_METRIC_VALUE("opcode_time", delta.TotalTime, TC_METRIC_TAG("opcode", opcodeName));
+        TC_METRIC_VALUE("opcode_queue_wait", delta.TotalQueueWait, TC_METRIC_TAG("opcode", opcodeName));
+        TC_METRIC_VALUE("opcode_time_p50", uint64(delta.GetTimePercentile(50.0f).count()), TC_METRIC_TAG("opcode", opcodeName));
+        TC_METRIC_VALUE("opcode_time_p99", uint64(delta.GetTimePercentile(99.0f).count()), TC_METRIC_TAG("opcode", opcodeName));
+    }
+}
@@ -0,0 +1,81 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OpcodeProfiler_h__
+#define OpcodeProfiler_h__
+
+#include "Define.h"
+#include "Duration.h"
+#include <array>
+#include <atomic>
+#include <vector>
+
+// Always on statistics of the client packets handled by WorldSession::ProcessPackets.
+// Every thread records into its own counters, totals are only summed up when they are read.
+class TC_GAME_API OpcodeProfiler
+{
+public:
+    // handler times are counted in power of two microsecond buckets, [0, 1us), [1us, 2us), [2us, 4us) ... the last one is open
+    static constexpr uint32 TIME_BUCKETS = 20;
+
+    struct OpcodeStats
+    {
+        uint64 Count = 0;
+        uint64 Bytes = 0;
+        std::chrono::nanoseconds TotalTime = std::chrono::nanoseconds::zero();
+        std::chrono::nanoseconds MaxTime = std::chrono::nanoseconds::zero();
+        std::chrono::nanoseconds TotalQueueWait = std::chrono::nanoseconds::zero();
+        std::array<uint64, TIME_BUCKETS> TimeHistogram = { };
+
+        // upper bound of the histogram bucket that contains the percentile
+        std::chrono::microseconds GetTimePercentile(float percentile) const;
+    };
+
+    static OpcodeProfiler* instance();
+
+    void Record(uint16 opcode, std::size_t bytes, std::chrono::nanoseconds queueWait, std::chrono::nanoseconds handlerTime);
+
+    // indexed by opcode, counted since startup or the last Reset()
+    std::vector<OpcodeStats> GetStats() const { return GetStats(_resetGeneration.load(std::memory_order_relaxed)); }
+    void Reset() { ++_resetGeneration; }
+
+    // indexed by opcode, counted since the previous call or the last Reset(), MaxTime is the maximum of GetStats()
+    std::vector<OpcodeStats> GetStatsSinceLastDelta();
+
+    // logs the opcodes handled since the previous call to Metric
+    void UpdateMetrics();
+
+private:
+    OpcodeProfiler();
+    ~OpcodeProfiler();
+
+    struct ThreadStats;
+    ThreadStats* GetThreadStats();
+    std::vector<OpcodeStats> GetStats(uint32 generation) const;
+
+    std::atomic<ThreadStats*> _threadStats;
+    std::atomic<uint32> _resetGeneration;
+    std::vector<OpcodeStats> _deltaBaseline;
+    uint32 _deltaGeneration;
+
+    OpcodeProfiler(OpcodeProfiler const&) = delete;
+    OpcodeProfiler& operator=(OpcodeProfiler const&) = delete;
+};
+
+#define sOpcodeProfiler OpcodeProfiler::instance()
+
+#endif // OpcodeProfiler_h__
@@ -1364,7 +1364,8 @@ enum PacketProcessing
 {
     PROCESS_INPLACE = 0,                                    //process packet whenever we receive it - mostly for non-handled or non-implemented packets
     PROCESS_THREADUNSAFE,                                   //packet is not thread-safe - process it in World::UpdateSessions()
-    PROCESS_THREADSAFE                                      //packet is thread-safe - process it in Map::Update()
+    PROCESS_THREADSAFE,                                     //packet is thread-safe - process it in Map::Update()
+    PROCESS_CONCURRENT                                      //packet only reads static data and its own session - process it on WorldSessionUpdater threads
 };
 
 class WorldSession;
@@ -84,7 +84,7 @@ class WorldPacket : public ByteBuffer
 
     protected:
         uint16 m_opcode;
-        TimePoint m_receivedTime; // only set for a specific set of opcodes, for performance reasons.
+        TimePoint m_receivedTime; // only set for packets received from the client
 };
 
 #endif
@@ -40,6 +40,7 @@
 #include "MoveSpline.h"
 #include "ObjectAccessor.h"
 #include "ObjectMgr.h"
+#include "OpcodeProfiler.h"
 #include "Opcodes.h"
 #include "OutdoorPvPMgr.h"
 #include "PacketUtilities.h"
@@ -67,7 +68,7 @@ bool MapSessionFilter::Process(WorldPacket* packet)
     ClientOpcodeHandler const* opHandle = opcodeTable[static_cast<OpcodeClient>(packet->GetOpcode())];
 
     //let's check if our opcode can be really processed in Map::Update()
-    if (opHandle->ProcessingPlace == PROCESS_INPLACE)
+    if (opHandle->ProcessingPlace == PROCESS_INPLACE || opHandle->ProcessingPlace == PROCESS_CONCURRENT)
         return true;
 
     //we do not process thread-unsafe packets
@@ -89,7 +90,7 @@ bool WorldSessionFilter::Process(WorldPacket* packet)
     ClientOpcodeHandler const* opHandle = opcodeTable[static_cast<OpcodeClient>(packet->GetOpcode())];
 
     //check if packet handler is supposed to be safe
-    if (opHandle->ProcessingPlace == PROCESS_INPLACE)
+    if (opHandle->ProcessingPlace == PROCESS_INPLACE || opHandle->ProcessingPlace == PROCESS_CONCURRENT)
         return true;
 
     //thread-unsafe packets should be processed in World::UpdateSessions()
@@ -105,6 +106,18 @@ bool WorldSessionFilter::Process(WorldPacket* packet)
     return (player->IsInWorld() == false);
 }
 
+//process only packets that may run in parallel with other sessions, in WorldSessionUpdater
+bool ConcurrentSessionFilter::Process(WorldPacket* packet)
+{
+    ClientOpcodeHandler const* opHandle = opcodeTable[static_cast<OpcodeClient>(packet->GetOpcode())];
+    if (opHandle->ProcessingPlace != PROCESS_CONCURRENT)
+        return false;
+
+    //leave everything to World::UpdateSessions() while the player is not in world
+    Player* player = m_pSession->GetPlayer();
+    return player && player->IsInWorld();
+}
+
 /// WorldSession constructor
 WorldSession::WorldSession(uint32 id, std::string&& name, std::shared_ptr<WorldSocket> sock, AccountTypes sec, uint8 expansion, time_t mute_time, LocaleConstant locale, uint32 recruiter, bool isARecruiter):
     m_muteTime(mute_time),
@@ -283,7 +296,56 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
     if (IsConnectionIdle() && !HasPermission(rbac::RBAC_PERM_IGNORE_IDLE_CONNECTION))
         m_Socket->CloseSocket();
 
-    ///- Retrieve packets from the receive queue and call the appropriate handlers
+    ProcessPackets(updater);
+
+    if (!updater.ProcessUnsafe()) // <=> updater is of type MapSessionFilter
+    {
+        // Send time sync packet every 10s.
+        if (_timeSyncTimer > 0)
+        {
+            if (diff >= _timeSyncTimer)
+                SendTimeSync();
+            else
+                _timeSyncTimer -= diff;
+        }
+    }
+
+    ProcessQueryCallbacks();
+
+    //check if we are safe to proceed with logout
+    //logout procedure should happen only in World::UpdateSessions() method!!!
+    if (updater.ProcessUnsafe())
+    {
+        if (m_Socket && m_Socket->IsOpen() && _warden)
+            _warden->Update(diff);
+
+        ///- If necessary, log the player out
+        if (ShouldLogOut(GameTime::GetGameTime()) && !m_playerLoading)
+            LogoutPlayer(true);
+
+        ///- Cleanup socket pointer if need
+        if (m_Socket && !m_Socket->IsOpen())
+        {
+            if (GetPlayer() && _warden)
+                _warden->Update(diff);
+
+            expireTime -= expireTime > diff ? diff : expireTime;
+            if (expireTime < diff || forceExit || !GetPlayer())
+            {
+                m_Socket = nullptr;
+            }
+        }
+
+        if (!m_Socket)
+            return false;                                       //Will remove this session from the world session map
+    }
+
+    return true;
+}
+
+/// Retrieve packets from the receive queue that pass the filter and call the appropriate handlers
+void WorldSession::ProcessPackets(PacketFilter& updater)
+{
     /// not process packets if socket already closed
     WorldPacket* packet = nullptr;
     //! Delete packet after processing by default
@@ -299,6 +361,9 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
         OpcodeClient opcode = static_cast<OpcodeClient>(packet->GetOpcode());
         ClientOpcodeHandler const* opHandle = opcodeTable[opcode];
         TC_METRIC_DETAILED_TIMER("worldsession_update_opcode_time", TC_METRIC_TAG("opcode", opHandle->Name));
+        std::size_t packetSize = packet->size();
+        TimePoint receivedTime = packet->GetReceivedTime();
+        TimePoint handlerStart = std::chrono::steady_clock::now();
 
         try
         {
@@ -420,7 +485,15 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
         }
 
         if (deletePacket)
+        {
+            std::chrono::nanoseconds handlerTime = std::chrono::steady_clock::now() - handlerStart;
+            sOpcodeProfiler->Record(opcode, packetSize, handlerStart - receivedTime, handlerTime);
+            ++_packetStats.Count;
+            _packetStats.Bytes += packetSize;
+            _packetStats.HandlerTime += handlerTime;
+
             delete packet;
+        }
 
         deletePacket = true;
 
@@ -432,53 +505,9 @@ bool WorldSession::Update(uint32 diff, PacketFilter& updater)
             break;
     }
 
-    TC_METRIC_VALUE("processed_packets", processedPackets);
+    TC_METRIC_COUNTER("processed_packets", processedPackets);
 
     _recvQueue.readd(requeuePackets.begin(), requeuePackets.end());
-
-    if (!updater.ProcessUnsafe()) // <=> updater is of type MapSessionFilter
-    {
-        // Send time sync packet every 10s.
-        if (_timeSyncTimer > 0)
-        {
-            if (diff >= _timeSyncTimer)
-                SendTimeSync();
-            else
-                _timeSyncTimer -= diff;
-        }
-    }
-
-    ProcessQueryCallbacks();
-
-    //check if we are safe to proceed with logout
-    //logout procedure should happen only in World::UpdateSessions() method!!!
-    if (updater.ProcessUnsafe())
-    {
-        if (m_Socket && m_Socket->IsOpen() && _warden)
-            _warden->Update(diff);
-
-        ///- If necessary, log the player out
-        if (ShouldLogOut(currentTime) && !m_playerLoading)
-            LogoutPlayer(true);
-
-        ///- Cleanup socket pointer if need
-        if (m_Socket && !m_Socket->IsOpen())
-        {
-            if (GetPlayer() && _warden)
-                _warden->Update(diff);
-
-            expireTime -= expireTime > diff ? diff : expireTime;
-            if (expireTime < diff || forceExit || !GetPlayer())
-            {
-                m_Socket = nullptr;
-            }
-        }
-
-        if (!m_Socket)
-            return false;                                       //Will remove this session from the world session map
-    }
-
-    return true;
 }
 
 /// %Log the player out
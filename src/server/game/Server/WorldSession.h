@@ -333,6 +333,18 @@ public:
     virtual bool Process(WorldPacket* packet) override;
 };
 
+//class used to filter only packets that can be processed concurrently with other sessions
+//in WorldSessionUpdater, before World::UpdateSessions() processes the rest
+class ConcurrentSessionFilter : public PacketFilter
+{
+public:
+    explicit ConcurrentSessionFilter(WorldSession* pSession) : PacketFilter(pSession) { }
+    ~ConcurrentSessionFilter() { }
+
+    virtual bool Process(WorldPacket* packet) override;
+    virtual bool ProcessUnsafe() const override { return false; }
+};
+
 // Proxy structure to contain data passed to callback function,
 // only to prevent bloating the parameter list
 class CharacterCreateInfo
@@ -484,6 +496,7 @@ class TC_GAME_API WorldSession
 
         void QueuePacket(WorldPacket* new_packet);
         bool Update(uint32 diff, PacketFilter& updater);
+        void ProcessPackets(PacketFilter& updater);
 
         /// Handle the authentication waiting queue (to be completed)
         void SendAuthWaitQueue(uint32 position);
@@ -576,6 +589,16 @@ class TC_GAME_API WorldSession
         uint32 GetLatency() const { return m_latency; }
         void SetLatency(uint32 latency) { m_latency = latency; }
 
+        // totals of the packets handled for this session, see also OpcodeProfiler
+        struct PacketStats
+        {
+            uint64 Count = 0;
+            uint64 Bytes = 0;
+            std::chrono::nanoseconds HandlerTime = std::chrono::nanoseconds::zero();
+        };
+
+        PacketStats const& GetPacketStats() const { return _packetStats; }
+
         std::atomic<time_t> m_timeOutTime;
 
         void ResetTimeOutTime(bool onlyActive);
@@ -1204,6 +1227,7 @@ class TC_GAME_API WorldSession
         LocaleConstant m_sessionDbcLocale;
         LocaleConstant m_sessionDbLocaleIndex;
         std::atomic<uint32> m_latency;
+        PacketStats _packetStats;
         AccountData m_accountData[NUM_ACCOUNT_DATA_TYPES];
         uint32 m_Tutorials[MAX_ACCOUNT_TUTORIAL_VALUES];
         uint8  m_TutorialsChanged;
@@ -0,0 +1,103 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "WorldSessionUpdater.h"
+#include "DatabaseEnv.h"
+#include "Metric.h"
+#include "WorldSession.h"
+#include <limits>
+
+// more shards than threads, so a few busy sessions do not leave the other threads idle
+constexpr std::size_t SHARDS_PER_THREAD = 4;
+
+void WorldSessionUpdater::Activate(std::size_t numThreads)
+{
+    _shards.resize(numThreads * SHARDS_PER_THREAD);
+
+    for (std::size_t i = 0; i < numThreads; ++i)
+        _workerThreads.emplace_back(&WorldSessionUpdater::WorkerThread, this);
+}
+
+void WorldSessionUpdater::Deactivate()
+{
+    _queue.Cancel();
+
+    for (std::thread& thread : _workerThreads)
+        thread.join();
+
+    _workerThreads.clear();
+    _shards.clear();
+}
+
+void WorldSessionUpdater::ProcessConcurrentPackets(std::unordered_map<uint32, WorldSession*> const& sessions)
+{
+    for (std::vector<WorldSession*>& shard : _shards)
+        shard.clear();
+
+    for (auto const& [accountId, session] : sessions)
+        _shards[accountId % _shards.size()].push_back(session);
+
+    std::unique_lock<std::mutex> lock(_lock);
+
+    for (uint32 i = 0; i < _shards.size(); ++i)
+    {
+        if (_shards[i].empty())
+            continue;
+
+        ++_pendingShards;
+        _queue.Push(i);
+    }
+
+    while (_pendingShards > 0)
+        _condition.wait(lock);
+}
+
+void WorldSessionUpdater::ProcessShard(uint32 shard)
+{
+    TC_METRIC_AGGREGATED_TIMER("world_update_concurrent_packets_shard_time");
+
+    for (WorldSession* session : _shards[shard])
+    {
+        ConcurrentSessionFilter filter(session);
+        session->ProcessPackets(filter);
+    }
+
+    std::lock_guard<std::mutex> lock(_lock);
+
+    if (!--_pendingShards)
+        _condition.notify_all();
+}
+
+void WorldSessionUpdater::WorkerThread()
+{
+    LoginDatabase.WarnAboutSyncQueries(true);
+    CharacterDatabase.WarnAboutSyncQueries(true);
+    WorldDatabase.WarnAboutSyncQueries(true);
+
+    while (true)
+    {
+        uint32 shard = std::numeric_limits<uint32>::max();
+
+        _queue.WaitAndPop(shard);
+
+        // the queue only returns without a value when it was cancelled
+        if (shard == std::numeric_limits<uint32>::max())
+            return;
+
+        ProcessShard(shard);
+    }
+}
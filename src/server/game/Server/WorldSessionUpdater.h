@@ -0,0 +1,62 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WorldSessionUpdater_h__
+#define WorldSessionUpdater_h__
+
+#include "Define.h"
+#include "ProducerConsumerQueue.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class WorldSession;
+
+// Worker pool that processes PROCESS_CONCURRENT packets at the start of World::UpdateSessions().
+// Sessions are split into shards, a shard is handled by a single thread so packets of a session keep their order.
+class TC_GAME_API WorldSessionUpdater
+{
+public:
+    WorldSessionUpdater() : _pendingShards(0) { }
+    ~WorldSessionUpdater() { }
+
+    void Activate(std::size_t numThreads);
+    void Deactivate();
+    bool IsActive() const { return !_workerThreads.empty(); }
+
+    // blocks until the packets of all sessions are processed
+    void ProcessConcurrentPackets(std::unordered_map<uint32, WorldSession*> const& sessions);
+
+private:
+    void ProcessShard(uint32 shard);
+    void WorkerThread();
+
+    ProducerConsumerQueue<uint32> _queue;
+    std::vector<std::thread> _workerThreads;
+    std::vector<std::vector<WorldSession*>> _shards;
+
+    std::mutex _lock;
+    std::condition_variable _condition;
+    std::size_t _pendingShards;
+
+    WorldSessionUpdater(WorldSessionUpdater const&) = delete;
+    WorldSessionUpdater& operator=(WorldSessionUpdater const&) = delete;
+};
+
+#endif // WorldSessionUpdater_h__
@@ -352,12 +352,8 @@ WorldSocket::ReadDataHandlerResult WorldSocket::ReadDataHandler()
             }
             TC_LOG_ERROR("network", "WorldSocket::ReadDataHandler: client %s sent CMSG_KEEP_ALIVE without being authenticated", GetRemoteIpAddress().to_string().c_str());
             return ReadDataHandlerResult::Error;
-        case CMSG_TIME_SYNC_RESP:
-            packetToQueue = new WorldPacket(std::move(packet), std::chrono::steady_clock::now());
-            break;
-
         default:
-            packetToQueue = new WorldPacket(std::move(packet));
+            packetToQueue = new WorldPacket(std::move(packet), std::chrono::steady_clock::now());
             break;
     }
 
@@ -656,6 +656,17 @@ void AuraEffect::CalculateSpellMod()
     GetBase()->CallScriptEffectCalcSpellModHandlers(this, m_spellmod);
 }
 
+void AuraEffect::SetAmount(int32 amount)
+{
+    _amount = amount;
+    m_canBeRecalculated = false;
+
+    // cached modifier aggregates of every target include the amount
+    for (Aura::ApplicationMap::value_type const& pair : GetBase()->GetApplicationMap())
+        if (pair.second->HasEffect(GetEffIndex()))
+            pair.second->GetTarget()->InvalidateAuraModifierCache(GetAuraType());
+}
+
 void AuraEffect::ChangeAmount(int32 newAmount, bool mark, bool onStackOrReapply)
 {
     // Reapply if amount change
@@ -3415,6 +3426,7 @@ void AuraEffect::HandleAuraModStat(AuraApplication const* aurApp, uint8 mode, bo
     if (std::abs(spellGroupVal) >= std::abs(GetAmount()))
         return;
 
+    StatUpdateBatch statUpdateBatch(target);
     for (int32 i = STAT_STRENGTH; i < MAX_STATS; ++i)
     {
         // -1 or -2 is all stats (misc < -2 checked in function beginning)
@@ -3451,6 +3463,7 @@ void AuraEffect::HandleModPercentStat(AuraApplication const* aurApp, uint8 mode,
     if (target->GetTypeId() != TYPEID_PLAYER)
         return;
 
+    StatUpdateBatch statUpdateBatch(target);
     for (int32 i = STAT_STRENGTH; i < MAX_STATS; ++i)
     {
         if (GetMiscValue() == i || GetMiscValue() == -1)
@@ -3568,6 +3581,8 @@ void AuraEffect::HandleModTotalPercentStat(AuraApplication const* aurApp, uint8
     if (target->getDeathState() == CORPSE)
         zeroHealth = (target->GetHealth() == 0);
 
+    // stats are recalculated once after the loop, before max health is read below
+    target->BeginStatUpdateBatch();
     for (int32 i = STAT_STRENGTH; i < MAX_STATS; ++i)
     {
         if (GetMiscValue() == i || GetMiscValue() == -1) // affect the same stats
@@ -3587,6 +3602,7 @@ void AuraEffect::HandleModTotalPercentStat(AuraApplication const* aurApp, uint8
                 target->UpdateStatBuffMod(Stats(i));
         }
     }
+    target->EndStatUpdateBatch();
 
     // recalculate current HP/MP after applying aura modifications (only for spells with SPELL_ATTR0_ABILITY 0x00000010 flag)
     // this check is total bullshit i think
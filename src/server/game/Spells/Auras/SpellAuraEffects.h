@@ -36,6 +36,8 @@ class TC_GAME_API AuraEffect
         explicit AuraEffect(Aura* base, SpellEffectInfo const& spellEfffectInfo, int32 const* baseAmount, Unit* caster);
 
     public:
+        SPELL_OBJECT_POOL_OPERATORS(SPELL_OBJECT_POOL_AURA_EFFECT)
+
         Unit* GetCaster() const { return GetBase()->GetCaster(); }
         ObjectGuid GetCasterGUID() const { return GetBase()->GetCasterGUID(); }
         Aura* GetBase() const { return m_base; }
@@ -56,7 +58,7 @@ class TC_GAME_API AuraEffect
         int32 GetMiscValue() const { return GetSpellEffectInfo().MiscValue; }
         AuraType GetAuraType() const { return GetSpellEffectInfo().ApplyAuraName; }
         int32 GetAmount() const { return _amount; }
-        void SetAmount(int32 amount) { _amount = amount; m_canBeRecalculated = false; }
+        void SetAmount(int32 amount);
 
         int32 GetPeriodicTimer() const { return _periodicTimer; }
         void SetPeriodicTimer(int32 periodicTimer) { _periodicTimer = periodicTimer; }
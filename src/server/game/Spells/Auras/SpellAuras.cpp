@@ -939,10 +939,26 @@ void Aura::SetCharges(uint8 charges)
         return;
 
     m_procCharges = charges;
-    m_isUsingCharges = m_procCharges != 0;
+    SetUsingCharges(m_procCharges != 0);
     SetNeedClientUpdateForTargets();
 }
 
+void Aura::SetUsingCharges(bool val)
+{
+    if (m_isUsingCharges == val)
+        return;
+
+    m_isUsingCharges = val;
+
+    // spell modifiers with charges are resolved on every cast, the others are cached by the player
+    if (!HasEffectType(SPELL_AURA_ADD_FLAT_MODIFIER) && !HasEffectType(SPELL_AURA_ADD_PCT_MODIFIER))
+        return;
+
+    for (ApplicationMap::value_type const& pair : m_applications)
+        if (Player* player = pair.second->GetTarget()->ToPlayer())
+            player->InvalidateSpellModCache();
+}
+
 uint8 Aura::CalcMaxCharges(Unit* caster) const
 {
     uint32 maxProcCharges = m_spellInfo->ProcCharges;
@@ -20,6 +20,7 @@
 
 #include "SpellAuraDefines.h"
 #include "SpellInfo.h"
+#include "SpellObjectPool.h"
 
 class SpellInfo;
 struct SpellModifier;
@@ -46,6 +47,9 @@ class TC_GAME_API AuraApplication
 {
     friend class Unit;
 
+    public:
+        SPELL_OBJECT_POOL_OPERATORS(SPELL_OBJECT_POOL_AURA_APPLICATION)
+
     private:
         Unit* const _target;
         Aura* const _base;
@@ -219,7 +223,7 @@ class TC_GAME_API Aura
         void AddProcCooldown(TimePoint cooldownEnd);
         void ResetProcCooldown();
         bool IsUsingCharges() const { return m_isUsingCharges; }
-        void SetUsingCharges(bool val) { m_isUsingCharges = val; }
+        void SetUsingCharges(bool val);
         void PrepareProcToTrigger(AuraApplication* aurApp, ProcEventInfo& eventInfo, TimePoint now);
         uint8 GetProcEffectMask(AuraApplication* aurApp, ProcEventInfo& eventInfo, TimePoint now) const;
         float CalcProcChance(SpellProcEntry const& procEntry, ProcEventInfo& eventInfo) const;
@@ -310,6 +314,8 @@ class TC_GAME_API UnitAura : public Aura
     protected:
         explicit UnitAura(AuraCreateInfo const& createInfo);
     public:
+        SPELL_OBJECT_POOL_OPERATORS(SPELL_OBJECT_POOL_UNIT_AURA)
+
         void _ApplyForTarget(Unit* target, Unit* caster, AuraApplication* aurApp) override;
         void _UnapplyForTarget(Unit* target, Unit* caster, AuraApplication* aurApp) override;
 
@@ -334,6 +340,8 @@ class TC_GAME_API DynObjAura : public Aura
     protected:
         explicit DynObjAura(AuraCreateInfo const& createInfo);
     public:
+        SPELL_OBJECT_POOL_OPERATORS(SPELL_OBJECT_POOL_DYNOBJ_AURA)
+
         void Remove(AuraRemoveMode removeMode = AURA_REMOVE_BY_DEFAULT) override;
 
         void FillTargetMap(std::unordered_map<Unit*, uint8>& targets, Unit* caster) override;
@@ -61,9 +61,57 @@
 #include "World.h"
 #include "WorldPacket.h"
 #include "WorldSession.h"
+#include <boost/container/small_vector.hpp>
 
 extern SpellEffectHandlerFn SpellEffectHandlers[TOTAL_SPELL_EFFECTS];
 
+namespace
+{
+    /**
+        Scratch container for target selection, borrowed from a per thread pool and returned with its capacity kept,
+        so repeated area and chain searches do not allocate. Selection can nest (chain targets search area targets,
+        scripts cast spells from target hooks), every level gets its own buffer.
+    */
+    template<typename T>
+    class SpellTargetBuffer
+    {
+    public:
+        SpellTargetBuffer()
+        {
+            if (!_pool.empty())
+            {
+                _buffer = std::move(_pool.back());
+                _pool.pop_back();
+            }
+        }
+
+        ~SpellTargetBuffer()
+        {
+            // don't keep memory of huge searches around
+            if (_pool.size() >= MaxPooledBuffers || _buffer.capacity() > MaxPooledCapacity)
+                return;
+
+            _buffer.clear();
+            _pool.push_back(std::move(_buffer));
+        }
+
+        SpellTargetBuffer(SpellTargetBuffer const&) = delete;
+        SpellTargetBuffer& operator=(SpellTargetBuffer const&) = delete;
+
+        std::vector<T>& operator*() { return _buffer; }
+
+    private:
+        static constexpr std::size_t MaxPooledBuffers = 8;
+        static constexpr std::size_t MaxPooledCapacity = 1024;
+
+        std::vector<T> _buffer;
+        static thread_local std::vector<std::vector<T>> _pool;
+    };
+
+    template<typename T>
+    thread_local std::vector<std::vector<T>> SpellTargetBuffer<T>::_pool;
+}
+
 SpellDestination::SpellDestination()
 {
     _position.Relocate(0, 0, 0, 0);
@@ -490,6 +538,8 @@ class TC_GAME_API SpellEvent : public BasicEvent
         SpellEvent(Spell* spell);
         ~SpellEvent();
 
+        SPELL_OBJECT_POOL_OPERATORS(SPELL_OBJECT_POOL_SPELL_EVENT)
+
         bool Execute(uint64 e_time, uint32 p_time) override;
         void Abort(uint64 e_time) override;
         bool IsDeletable() const override;
@@ -1150,7 +1200,8 @@ void Spell::SelectImplicitConeTargets(SpellEffectInfo const& spellEffectInfo, Sp
         ABORT_MSG("Spell::SelectImplicitConeTargets: received not implemented target reference type");
         return;
     }
-    std::list<WorldObject*> targets;
+    SpellTargetBuffer<WorldObject*> targetBuffer;
+    std::vector<WorldObject*>& targets = *targetBuffer;
     SpellTargetObjectTypes objectType = targetType.GetObjectType();
     SpellTargetCheckTypes selectionType = targetType.GetCheckType();
     ConditionContainer* condList = spellEffectInfo.ImplicitTargetConditions;
@@ -1246,7 +1297,8 @@ void Spell::SelectImplicitAreaTargets(SpellEffectInfo const& spellEffectInfo, Sp
              ABORT_MSG("Spell::SelectImplicitAreaTargets: received not implemented target reference type");
              return;
     }
-    std::list<WorldObject*> targets;
+    SpellTargetBuffer<WorldObject*> targetBuffer;
+    std::vector<WorldObject*>& targets = *targetBuffer;
     float radius = spellEffectInfo.CalcRadius(m_caster);
     // Workaround for some spells that don't have RadiusEntry set in dbc (but SpellRange instead)
     if (G3D::fuzzyEq(radius, 0.f))
@@ -1268,10 +1320,19 @@ void Spell::SelectImplicitAreaTargets(SpellEffectInfo const& spellEffectInfo, Sp
             Trinity::Containers::RandomResize(targets, maxTargets);
         }
 
-        for (WorldObject* itr : targets)
+        // trace the line of sight of all units at once instead of one ray per target and effect
+        boost::container::small_vector<bool, VMAP::LOS_BATCH_INLINE_SIZE> targetsInLOS;
+        if (targets.size() > 1 && !IsIgnoringLOS())
         {
+            targetsInLOS.resize(targets.size());
+            CheckAreaTargetsLOS(targets, *center, targetsInLOS.data());
+        }
+
+        for (std::size_t i = 0; i < targets.size(); ++i)
+        {
+            WorldObject* itr = targets[i];
             if (Unit* unit = itr->ToUnit())
-                AddUnitTarget(unit, effMask, false, true, center);
+                AddUnitTarget(unit, effMask, false, true, center, !targetsInLOS.empty() ? Optional<bool>(targetsInLOS[i]) : Optional<bool>());
             else if (GameObject* gObjTarget = itr->ToGameObject())
                 AddGOTarget(gObjTarget, effMask);
             else if (Corpse* corpse = itr->ToCorpse())
@@ -1280,6 +1341,43 @@ void Spell::SelectImplicitAreaTargets(SpellEffectInfo const& spellEffectInfo, Sp
     }
 }
 
+void Spell::CheckAreaTargetsLOS(std::vector<WorldObject*> const& targets, Position const& losPosition, bool* results) const
+{
+    std::fill(results, results + targets.size(), true);
+
+    // same rays as Unit::IsWithinLOS, static geometry is traced as one batch
+    SpellTargetBuffer<float> segmentBuffer;
+    std::vector<float>& segments = *segmentBuffer;
+    SpellTargetBuffer<uint32> tracedBuffer;
+    std::vector<uint32>& traced = *tracedBuffer;
+    for (std::size_t i = 0; i < targets.size(); ++i)
+    {
+        Unit const* unit = targets[i]->ToUnit();
+        if (!unit || !unit->IsInWorld())
+            continue;
+
+        float segment[6];
+        unit->GetLineOfSightSegment(losPosition.GetPositionX(), losPosition.GetPositionY(), losPosition.GetPositionZ(), segment);
+        segments.insert(segments.end(), std::begin(segment), std::end(segment));
+        traced.push_back(uint32(i));
+    }
+
+    if (traced.empty())
+        return;
+
+    Map const* map = m_caster->GetMap();
+    boost::container::small_vector<bool, VMAP::LOS_BATCH_INLINE_SIZE> staticResults(traced.size());
+    map->isInLineOfSight(segments.data(), staticResults.data(), uint32(traced.size()), 0, LINEOFSIGHT_CHECK_VMAP, VMAP::ModelIgnoreFlags::M2);
+
+    // gameobjects depend on the phase of every target
+    for (std::size_t j = 0; j < traced.size(); ++j)
+    {
+        float const* segment = &segments[j * 6];
+        results[traced[j]] = staticResults[j] && map->isInLineOfSight(segment[0], segment[1], segment[2], segment[3], segment[4], segment[5],
+            targets[traced[j]]->GetPhaseMask(), LINEOFSIGHT_CHECK_GOBJECT, VMAP::ModelIgnoreFlags::M2);
+    }
+}
+
 void Spell::SelectImplicitCasterDestTargets(SpellEffectInfo const& spellEffectInfo, SpellImplicitTargetInfo const& targetType)
 {
     SpellDestination dest(*m_caster);
@@ -1560,15 +1658,16 @@ void Spell::SelectImplicitChainTargets(SpellEffectInfo const& spellEffectInfo, S
                 m_damageMultipliers[k] = 1.0f;
         m_applyMultiplierMask |= effMask;
 
-        std::list<WorldObject*> targets;
+        SpellTargetBuffer<WorldObject*> targetBuffer;
+        std::vector<WorldObject*>& targets = *targetBuffer;
         SearchChainTargets(targets, maxTargets - 1, target, targetType.GetObjectType(), targetType.GetCheckType()
             , spellEffectInfo.ImplicitTargetConditions, targetType.GetTarget() == TARGET_UNIT_TARGET_CHAINHEAL_ALLY);
 
         // Chain primary target is added earlier
         CallScriptObjectAreaTargetSelectHandlers(targets, spellEffectInfo.EffectIndex, targetType);
 
-        for (std::list<WorldObject*>::iterator itr = targets.begin(); itr != targets.end(); ++itr)
-            if (Unit* unit = (*itr)->ToUnit())
+        for (WorldObject* chainTarget : targets)
+            if (Unit* unit = chainTarget->ToUnit())
                 AddUnitTarget(unit, effMask, false);
     }
 }
@@ -1598,14 +1697,15 @@ void Spell::SelectImplicitTrajTargets(SpellEffectInfo const& spellEffectInfo, Sp
     srcPos.SetOrientation(m_caster->GetOrientation());
     float srcToDestDelta = m_targets.GetDstPos()->m_positionZ - srcPos.m_positionZ;
 
-    std::list<WorldObject*> targets;
+    SpellTargetBuffer<WorldObject*> targetBuffer;
+    std::vector<WorldObject*>& targets = *targetBuffer;
     Trinity::WorldObjectSpellTrajTargetCheck check(dist2d, &srcPos, m_caster, m_spellInfo, targetType.GetCheckType(), spellEffectInfo.ImplicitTargetConditions);
     Trinity::WorldObjectListSearcher<Trinity::WorldObjectSpellTrajTargetCheck> searcher(m_caster, targets, check, GRID_MAP_TYPE_MASK_ALL);
     SearchTargets<Trinity::WorldObjectListSearcher<Trinity::WorldObjectSpellTrajTargetCheck> > (searcher, GRID_MAP_TYPE_MASK_ALL, m_caster, &srcPos, dist2d);
     if (targets.empty())
         return;
 
-    targets.sort(Trinity::ObjectDistanceOrderPred(m_caster));
+    std::stable_sort(targets.begin(), targets.end(), Trinity::ObjectDistanceOrderPred(m_caster));
 
     float b = tangent(m_targets.GetElevation());
     float a = (srcToDestDelta - dist2d * b) / (dist2d * dist2d);
@@ -1840,7 +1940,7 @@ WorldObject* Spell::SearchNearbyTarget(float range, SpellTargetObjectTypes objec
     return target;
 }
 
-void Spell::SearchAreaTargets(std::list<WorldObject*>& targets, float range, Position const* position, WorldObject* referer, SpellTargetObjectTypes objectType, SpellTargetCheckTypes selectionType, ConditionContainer* condList)
+void Spell::SearchAreaTargets(std::vector<WorldObject*>& targets, float range, Position const* position, WorldObject* referer, SpellTargetObjectTypes objectType, SpellTargetCheckTypes selectionType, ConditionContainer* condList)
 {
     uint32 containerTypeMask = GetSearcherTypeMask(objectType, condList);
     if (!containerTypeMask)
@@ -1852,7 +1952,7 @@ void Spell::SearchAreaTargets(std::list<WorldObject*>& targets, float range, Pos
     SearchTargets<Trinity::WorldObjectListSearcher<Trinity::WorldObjectSpellAreaTargetCheck> > (searcher, containerTypeMask, m_caster, position, range + extraSearchRadius);
 }
 
-void Spell::SearchChainTargets(std::list<WorldObject*>& targets, uint32 chainTargets, WorldObject* target, SpellTargetObjectTypes objectType, SpellTargetCheckTypes selectType, ConditionContainer* condList, bool isChainHeal)
+void Spell::SearchChainTargets(std::vector<WorldObject*>& targets, uint32 chainTargets, WorldObject* target, SpellTargetObjectTypes objectType, SpellTargetCheckTypes selectType, ConditionContainer* condList, bool isChainHeal)
 {
     // max dist for jump target selection
     float jumpRadius = 0.0f;
@@ -1887,62 +1987,67 @@ void Spell::SearchChainTargets(std::list<WorldObject*>& targets, uint32 chainTar
     if (isBouncingFar)
         searchRadius *= chainTargets;
 
-    std::list<WorldObject*> tempTargets;
+    SpellTargetBuffer<WorldObject*> tempTargetBuffer;
+    std::vector<WorldObject*>& tempTargets = *tempTargetBuffer;
     SearchAreaTargets(tempTargets, searchRadius, target, m_caster, objectType, selectType, condList);
-    tempTargets.remove(target);
+    tempTargets.erase(std::remove(tempTargets.begin(), tempTargets.end(), target), tempTargets.end());
 
     // remove targets which are always invalid for chain spells
     // for some spells allow only chain targets in front of caster (swipe for example)
     if (!isBouncingFar)
     {
-        for (std::list<WorldObject*>::iterator itr = tempTargets.begin(); itr != tempTargets.end();)
+        tempTargets.erase(std::remove_if(tempTargets.begin(), tempTargets.end(), [this](WorldObject* tempTarget)
         {
-            std::list<WorldObject*>::iterator checkItr = itr++;
-            if (!m_caster->HasInArc(static_cast<float>(M_PI), *checkItr))
-                tempTargets.erase(checkItr);
-        }
+            return !m_caster->HasInArc(static_cast<float>(M_PI), tempTarget);
+        }), tempTargets.end());
     }
 
+    // candidates keyed by preference for the next jump and their index in tempTargets, the index keeps ties in search order
+    // they are popped from a min heap, so only the leading ones until the first valid target are ordered and need a LoS check
+    SpellTargetBuffer<std::pair<float, uint32>> candidateBuffer;
+    std::vector<std::pair<float, uint32>>& candidates = *candidateBuffer;
+    std::greater<std::pair<float, uint32>> candidateOrder;
+
     while (chainTargets)
     {
-        // try to get unit for next chain jump
-        std::list<WorldObject*>::iterator foundItr = tempTargets.end();
+        candidates.clear();
         // get unit with highest hp deficit in dist
         if (isChainHeal)
         {
-            uint32 maxHPDeficit = 0;
-            for (std::list<WorldObject*>::iterator itr = tempTargets.begin(); itr != tempTargets.end(); ++itr)
-            {
-                if (Unit* unit = (*itr)->ToUnit())
-                {
-                    uint32 deficit = unit->GetMaxHealth() - unit->GetHealth();
-                    if (deficit > maxHPDeficit && target->IsWithinDist(unit, jumpRadius) && target->IsWithinLOSInMap(unit, LINEOFSIGHT_ALL_CHECKS, VMAP::ModelIgnoreFlags::M2))
-                    {
-                        foundItr = itr;
-                        maxHPDeficit = deficit;
-                    }
-                }
-            }
+            for (uint32 i = 0; i < tempTargets.size(); ++i)
+                if (Unit* unit = tempTargets[i]->ToUnit())
+                    if (uint32 deficit = unit->GetMaxHealth() - unit->GetHealth())
+                        if (target->IsWithinDist(unit, jumpRadius))
+                            candidates.emplace_back(-float(deficit), i);
         }
         // get closest object
         else
         {
-            for (std::list<WorldObject*>::iterator itr = tempTargets.begin(); itr != tempTargets.end(); ++itr)
+            for (uint32 i = 0; i < tempTargets.size(); ++i)
+                if (!isBouncingFar || target->IsWithinDist(tempTargets[i], jumpRadius))
+                    candidates.emplace_back(target->GetExactDistSq(tempTargets[i]), i);
+        }
+
+        std::make_heap(candidates.begin(), candidates.end(), candidateOrder);
+
+        WorldObject* found = nullptr;
+        while (!candidates.empty())
+        {
+            std::pop_heap(candidates.begin(), candidates.end(), candidateOrder);
+            uint32 index = candidates.back().second;
+            candidates.pop_back();
+            if (target->IsWithinLOSInMap(tempTargets[index], LINEOFSIGHT_ALL_CHECKS, VMAP::ModelIgnoreFlags::M2))
             {
-                if (foundItr == tempTargets.end())
-                {
-                    if ((!isBouncingFar || target->IsWithinDist(*itr, jumpRadius)) && target->IsWithinLOSInMap(*itr, LINEOFSIGHT_ALL_CHECKS, VMAP::ModelIgnoreFlags::M2))
-                        foundItr = itr;
-                }
-                else if (target->GetDistanceOrder(*itr, *foundItr) && target->IsWithinLOSInMap(*itr, LINEOFSIGHT_ALL_CHECKS, VMAP::ModelIgnoreFlags::M2))
-                    foundItr = itr;
+                found = tempTargets[index];
+                tempTargets.erase(tempTargets.begin() + index);
+                break;
             }
         }
+
         // not found any valid target - chain ends
-        if (foundItr == tempTargets.end())
+        if (!found)
             break;
-        target = *foundItr;
-        tempTargets.erase(foundItr);
+        target = found;
         targets.push_back(target);
         --chainTargets;
     }
@@ -2056,10 +2161,10 @@ class ProcReflectDelayed : public BasicEvent
         ObjectGuid _casterGuid;
 };
 
-void Spell::AddUnitTarget(Unit* target, uint32 effectMask, bool checkIfValid /*= true*/, bool implicit /*= true*/, Position const* losPosition /*= nullptr*/)
+void Spell::AddUnitTarget(Unit* target, uint32 effectMask, bool checkIfValid /*= true*/, bool implicit /*= true*/, Position const* losPosition /*= nullptr*/, Optional<bool> isInLOS /*= {}*/)
 {
     for (SpellEffectInfo const& spellEffectInfo : m_spellInfo->GetEffects())
-        if (!spellEffectInfo.IsEffect() || !CheckEffectTarget(target, spellEffectInfo, losPosition))
+        if (!spellEffectInfo.IsEffect() || !CheckEffectTarget(target, spellEffectInfo, losPosition, isInLOS))
             effectMask &= ~(1 << spellEffectInfo.EffectIndex);
 
     // no effects left
@@ -7270,7 +7375,7 @@ CurrentSpellTypes Spell::GetCurrentContainer() const
     return CURRENT_GENERIC_SPELL;
 }
 
-bool Spell::CheckEffectTarget(Unit const* target, SpellEffectInfo const& spellEffectInfo, Position const* losPosition) const
+bool Spell::CheckEffectTarget(Unit const* target, SpellEffectInfo const& spellEffectInfo, Position const* losPosition, Optional<bool> isInLOS /*= {}*/) const
 {
     switch (spellEffectInfo.ApplyAuraName)
     {
@@ -7292,17 +7397,7 @@ bool Spell::CheckEffectTarget(Unit const* target, SpellEffectInfo const& spellEf
             break;
     }
 
-    // check for ignore LOS on the effect itself
-    if (m_spellInfo->HasAttribute(SPELL_ATTR2_CAN_TARGET_NOT_IN_LOS) || DisableMgr::IsDisabledFor(DISABLE_TYPE_SPELL, m_spellInfo->Id, nullptr, SPELL_DISABLE_LOS))
-        return true;
-
-    // check if gameobject ignores LOS
-    if (GameObject const* gobCaster = m_caster->ToGameObject())
-        if (gobCaster->GetGOInfo()->IsIgnoringLOSChecks())
-            return true;
-
-    // if spell is triggered, need to check for LOS disable on the aura triggering it and inherit that behaviour
-    if (IsTriggered() && m_triggeredByAuraSpell && (m_triggeredByAuraSpell->HasAttribute(SPELL_ATTR2_CAN_TARGET_NOT_IN_LOS) || DisableMgr::IsDisabledFor(DISABLE_TYPE_SPELL, m_triggeredByAuraSpell->Id, nullptr, SPELL_DISABLE_LOS)))
+    if (IsIgnoringLOS())
         return true;
 
     /// @todo shit below shouldn't be here, but it's temporary
@@ -7357,7 +7452,13 @@ bool Spell::CheckEffectTarget(Unit const* target, SpellEffectInfo const& spellEf
         default:                                            // normal case
         {
             if (losPosition)
+            {
+                // already traced by CheckAreaTargetsLOS
+                if (isInLOS)
+                    return *isInLOS;
+
                 return target->IsWithinLOS(losPosition->GetPositionX(), losPosition->GetPositionY(), losPosition->GetPositionZ(), LINEOFSIGHT_ALL_CHECKS, VMAP::ModelIgnoreFlags::M2);
+            }
             else
             {
                 // Get GO cast coordinates if original caster -> GO
@@ -7381,6 +7482,24 @@ bool Spell::IsTriggered() const
     return (_triggeredCastFlags & TRIGGERED_FULL_MASK) != 0;
 }
 
+bool Spell::IsIgnoringLOS() const
+{
+    // check for ignore LOS on the effect itself
+    if (m_spellInfo->HasAttribute(SPELL_ATTR2_CAN_TARGET_NOT_IN_LOS) || DisableMgr::IsDisabledFor(DISABLE_TYPE_SPELL, m_spellInfo->Id, nullptr, SPELL_DISABLE_LOS))
+        return true;
+
+    // check if gameobject ignores LOS
+    if (GameObject const* gobCaster = m_caster->ToGameObject())
+        if (gobCaster->GetGOInfo()->IsIgnoringLOSChecks())
+            return true;
+
+    // if spell is triggered, need to check for LOS disable on the aura triggering it and inherit that behaviour
+    if (IsTriggered() && m_triggeredByAuraSpell && (m_triggeredByAuraSpell->HasAttribute(SPELL_ATTR2_CAN_TARGET_NOT_IN_LOS) || DisableMgr::IsDisabledFor(DISABLE_TYPE_SPELL, m_triggeredByAuraSpell->Id, nullptr, SPELL_DISABLE_LOS)))
+        return true;
+
+    return false;
+}
+
 bool Spell::IsIgnoringCooldowns() const
 {
     return (_triggeredCastFlags & TRIGGERED_IGNORE_SPELL_AND_CATEGORY_CD) != 0;
@@ -7988,18 +8107,33 @@ void Spell::CallScriptAfterHitHandlers()
     }
 }
 
-void Spell::CallScriptObjectAreaTargetSelectHandlers(std::list<WorldObject*>& targets, SpellEffIndex effIndex, SpellImplicitTargetInfo const& targetType)
+void Spell::CallScriptObjectAreaTargetSelectHandlers(std::vector<WorldObject*>& targets, SpellEffIndex effIndex, SpellImplicitTargetInfo const& targetType)
 {
+    // script hooks work on a std::list, only build it when a hook is called
+    std::list<WorldObject*> scriptTargets;
+    bool hookCalled = false;
     for (auto scritr = m_loadedScripts.begin(); scritr != m_loadedScripts.end(); ++scritr)
     {
         (*scritr)->_PrepareScriptCall(SPELL_SCRIPT_HOOK_OBJECT_AREA_TARGET_SELECT);
         auto hookItrEnd = (*scritr)->OnObjectAreaTargetSelect.end(), hookItr = (*scritr)->OnObjectAreaTargetSelect.begin();
         for (; hookItr != hookItrEnd; ++hookItr)
+        {
             if (hookItr->IsEffectAffected(m_spellInfo, effIndex) && targetType.GetTarget() == hookItr->GetTarget())
-                hookItr->Call(*scritr, targets);
+            {
+                if (!hookCalled)
+                {
+                    scriptTargets.assign(targets.begin(), targets.end());
+                    hookCalled = true;
+                }
+                hookItr->Call(*scritr, scriptTargets);
+            }
+        }
 
         (*scritr)->_FinishScriptCall();
     }
+
+    if (hookCalled)
+        targets.assign(scriptTargets.begin(), scriptTargets.end());
 }
 
 void Spell::CallScriptObjectTargetSelectHandlers(WorldObject*& target, SpellEffIndex effIndex, SpellImplicitTargetInfo const& targetType)
@@ -2545,6 +2545,9 @@ int32 SpellInfo::GetDiminishingReturnsLimitDuration(bool triggered) const
 
 void SpellInfo::_LoadImmunityInfo()
 {
+    _allowedMechanicMask = 0;
+    _immunityInfo = { };
+
     for (SpellEffectInfo& effect : _GetEffects())
     {
         uint32 schoolImmunityMask = 0;
@@ -2827,6 +2830,54 @@ void SpellInfo::_LoadImmunityInfo()
     }
 }
 
+uint32 SpellInfo::_GetLoadedDataChecksum() const
+{
+    // FNV-1a over the fields filled by the SpellMgr load passes
+    uint32 hash = 2166136261u;
+    auto mix = [&hash](uint32 value)
+    {
+        hash ^= value;
+        hash *= 16777619u;
+    };
+
+    mix(Id);
+    mix(AttributesCu);
+    mix(ExplicitTargetMask);
+    for (SpellEffectInfo const& effect : _effects)
+    {
+        mix(effect.Effect);
+        mix(effect.ApplyAuraName);
+        mix(uint32(effect.BasePoints));
+        mix(uint32(effect.MiscValue));
+    }
+
+    mix(_spellSpecific);
+    mix(_auraState);
+    for (SpellDiminishInfo const* diminishInfo : { &_diminishInfoNonTriggered, &_diminishInfoTriggered })
+    {
+        mix(diminishInfo->DiminishGroup);
+        mix(diminishInfo->DiminishReturnType);
+        mix(diminishInfo->DiminishMaxLevel);
+        mix(uint32(diminishInfo->DiminishDurationLimit));
+    }
+
+    mix(_allowedMechanicMask);
+    for (ImmunityInfo const& immuneInfo : _immunityInfo)
+    {
+        mix(immuneInfo.SchoolImmuneMask);
+        mix(immuneInfo.ApplyHarmfulAuraImmuneMask);
+        mix(immuneInfo.MechanicImmuneMask);
+        mix(immuneInfo.DispelImmune);
+        mix(immuneInfo.DamageSchoolMask);
+        for (AuraType auraType : immuneInfo.AuraTypeImmune)
+            mix(auraType);
+        for (SpellEffects effect : immuneInfo.SpellEffectImmune)
+            mix(effect);
+    }
+
+    return hash;
+}
+
 void SpellInfo::ApplyAllSpellImmunitiesTo(Unit* target, uint8 effIndex, bool apply) const
 {
     ImmunityInfo const& immuneInfo = _immunityInfo[effIndex];
@@ -295,10 +295,9 @@ class TC_GAME_API SpellInfo
     friend class SpellMgr;
 
     public:
+        // fields read by the cast path (target, location and aura state checks, costs, effects) come first,
+        // rarely read data (cooldown and proc setup, reagents, visuals, names) is kept behind the effects
         uint32 Id;
-        SpellCategoryEntry const* CategoryEntry;
-        uint32 Dispel;
-        uint32 Mechanic;
         uint32 Attributes;
         uint32 AttributesEx;
         uint32 AttributesEx2;
@@ -308,12 +307,20 @@ class TC_GAME_API SpellInfo
         uint32 AttributesEx6;
         uint32 AttributesEx7;
         uint32 AttributesCu;
-        uint64 Stances;
-        uint64 StancesNot;
+        uint32 Dispel;
+        uint32 Mechanic;
+        uint32 SchoolMask;
+        uint32 DmgClass;
+        uint32 PreventionType;
+        uint32 SpellFamilyName;
+        flag96 SpellFamilyFlags;
+        uint32 ExplicitTargetMask;
         uint32 Targets;
         uint32 TargetCreatureType;
-        uint32 RequiresSpellFocus;
         uint32 FacingCasterFlags;
+        uint32 RequiresSpellFocus;
+        uint64 Stances;
+        uint64 StancesNot;
         uint32 CasterAuraState;
         uint32 TargetAuraState;
         uint32 CasterAuraStateNot;
@@ -322,21 +329,16 @@ class TC_GAME_API SpellInfo
         uint32 TargetAuraSpell;
         uint32 ExcludeCasterAuraSpell;
         uint32 ExcludeTargetAuraSpell;
+        uint32 MaxTargetLevel;
+        uint32 MaxAffectedTargets;
+        int32  AreaGroupId;
         SpellCastTimesEntry const* CastTimeEntry;
-        uint32 RecoveryTime;
-        uint32 CategoryRecoveryTime;
-        uint32 StartRecoveryCategory;
-        uint32 StartRecoveryTime;
+        SpellDurationEntry const* DurationEntry;
+        SpellRangeEntry const* RangeEntry;
+        float  Speed;
         uint32 InterruptFlags;
         uint32 AuraInterruptFlags;
         uint32 ChannelInterruptFlags;
-        uint32 ProcFlags;
-        uint32 ProcChance;
-        uint32 ProcCharges;
-        uint32 MaxLevel;
-        uint32 BaseLevel;
-        uint32 SpellLevel;
-        SpellDurationEntry const* DurationEntry;
         Powers PowerType;
         uint32 ManaCost;
         uint32 ManaCostPerlevel;
@@ -344,33 +346,34 @@ class TC_GAME_API SpellInfo
         uint32 ManaPerSecondPerLevel;
         uint32 ManaCostPercentage;
         uint32 RuneCostID;
-        SpellRangeEntry const* RangeEntry;
-        float  Speed;
-        uint32 StackAmount;
-        std::array<uint32, 2> Totem;
-        std::array<int32, MAX_SPELL_REAGENTS>  Reagent;
-        std::array<uint32, MAX_SPELL_REAGENTS> ReagentCount;
         int32  EquippedItemClass;
         int32  EquippedItemSubClassMask;
         int32  EquippedItemInventoryTypeMask;
+        std::array<SpellEffectInfo, MAX_SPELL_EFFECTS> _effects;
+
+        SpellCategoryEntry const* CategoryEntry;
+        uint32 RecoveryTime;
+        uint32 CategoryRecoveryTime;
+        uint32 StartRecoveryCategory;
+        uint32 StartRecoveryTime;
+        uint32 ProcFlags;
+        uint32 ProcChance;
+        uint32 ProcCharges;
+        uint32 MaxLevel;
+        uint32 BaseLevel;
+        uint32 SpellLevel;
+        uint32 StackAmount;
+        uint32 Priority;
+        SpellChainNode const* ChainEntry;
+        std::array<uint32, 2> Totem;
         std::array<uint32, 2> TotemCategory;
+        std::array<int32, MAX_SPELL_REAGENTS>  Reagent;
+        std::array<uint32, MAX_SPELL_REAGENTS> ReagentCount;
         std::array<uint32, 2> SpellVisual;
         uint32 SpellIconID;
         uint32 ActiveIconID;
-        uint32 Priority;
         std::array<char const*, 16> SpellName;
         std::array<char const*, 16> Rank;
-        uint32 MaxTargetLevel;
-        uint32 MaxAffectedTargets;
-        uint32 SpellFamilyName;
-        flag96 SpellFamilyFlags;
-        uint32 DmgClass;
-        uint32 PreventionType;
-        int32  AreaGroupId;
-        uint32 SchoolMask;
-        std::array<SpellEffectInfo, MAX_SPELL_EFFECTS> _effects;
-        uint32 ExplicitTargetMask;
-        SpellChainNode const* ChainEntry;
 
         SpellInfo(SpellEntry const* spellEntry);
         ~SpellInfo();
@@ -514,6 +517,7 @@ class TC_GAME_API SpellInfo
         void _LoadAuraState();
         void _LoadSpellDiminishInfo();
         void _LoadImmunityInfo();
+        uint32 _GetLoadedDataChecksum() const;
 
         std::array<SpellEffectInfo, MAX_SPELL_EFFECTS>& _GetEffects() { return _effects; }
         SpellEffectInfo& _GetEffect(SpellEffIndex index) { ASSERT(index < _effects.size()); return _effects[index]; }
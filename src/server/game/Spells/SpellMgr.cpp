@@ -31,6 +31,57 @@
 #include "Spell.h"
 #include "SpellAuraDefines.h"
 #include "SpellInfo.h"
+#include "World.h"
+#include <thread>
+
+namespace
+{
+    // below this many spells per thread starting another thread costs more than it saves
+    std::size_t const SPELL_LOAD_MIN_SPELLS_PER_THREAD = 1024;
+
+    // calls work(index) for every index in [0, count), split in contiguous ranges over up to threadCount threads
+    // work must only write data owned by its index, the result is then identical to a serial run
+    template<class Work>
+    uint32 ParallelForSpellIndex(std::size_t count, uint32 threadCount, Work const& work)
+    {
+        threadCount = uint32(std::min<std::size_t>(threadCount, std::max<std::size_t>(count / SPELL_LOAD_MIN_SPELLS_PER_THREAD, 1)));
+        if (threadCount <= 1)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                work(i);
+            return 1;
+        }
+
+        std::size_t const rangeSize = (count + threadCount - 1) / threadCount;
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount - 1);
+        for (uint32 t = 1; t < threadCount; ++t)
+        {
+            std::size_t begin = std::min(count, t * rangeSize);
+            std::size_t end = std::min(count, begin + rangeSize);
+            threads.emplace_back([&work, begin, end]()
+            {
+                for (std::size_t i = begin; i < end; ++i)
+                    work(i);
+            });
+        }
+
+        for (std::size_t i = 0; i < std::min(count, rangeSize); ++i)
+            work(i);
+
+        for (std::thread& thread : threads)
+            thread.join();
+
+        return threadCount;
+    }
+
+    // loaders collect entries in a std::multimap, equal keys keep their load order in the flat copy
+    template<class FlatMultiMap, class MultiMap>
+    void BuildFlatMultiMap(FlatMultiMap& flatMap, MultiMap const& multiMap)
+    {
+        flatMap = FlatMultiMap(boost::container::ordered_range, multiMap.begin(), multiMap.end());
+    }
+}
 
 bool IsPrimaryProfessionSkill(uint32 skill)
 {
@@ -54,7 +105,7 @@ bool IsPartOfSkillLine(uint32 skillId, uint32 spellId)
     return false;
 }
 
-SpellMgr::SpellMgr() { }
+SpellMgr::SpellMgr() : _spellProcGeneration(0), _spellInfoStorage(nullptr), _spellInfoStorageSize(0) { }
 
 SpellMgr::~SpellMgr()
 {
@@ -979,6 +1030,9 @@ void SpellMgr::LoadSpellRequired()
     mSpellsReqSpell.clear();                                   // need for reload case
     mSpellReq.clear();                                         // need for reload case
 
+    std::multimap<uint32, uint32> spellsRequired;
+    std::multimap<uint32, uint32> spellsRequiringSpell;
+
     //                                                   0        1
     QueryResult result = WorldDatabase.Query("SELECT spell_id, req_spell from spell_required");
 
@@ -1018,17 +1072,21 @@ void SpellMgr::LoadSpellRequired()
             continue;
         }
 
-        if (IsSpellRequiringSpell(spell_id, spell_req))
+        auto requiringBounds = spellsRequiringSpell.equal_range(spell_req);
+        if (std::any_of(requiringBounds.first, requiringBounds.second, [spell_id](std::pair<uint32 const, uint32> const& requiring) { return requiring.second == spell_id; }))
         {
             TC_LOG_ERROR("sql.sql", "Duplicate entry of req_spell %u and spell_id %u in `spell_required`, skipped.", spell_req, spell_id);
             continue;
         }
 
-        mSpellReq.insert (std::pair<uint32, uint32>(spell_id, spell_req));
-        mSpellsReqSpell.insert (std::pair<uint32, uint32>(spell_req, spell_id));
+        spellsRequired.emplace(spell_id, spell_req);
+        spellsRequiringSpell.emplace(spell_req, spell_id);
         ++count;
     } while (result->NextRow());
 
+    BuildFlatMultiMap(mSpellReq, spellsRequired);
+    BuildFlatMultiMap(mSpellsReqSpell, spellsRequiringSpell);
+
     TC_LOG_INFO("server.loading", ">> Loaded %u spell required records in %u ms", count, GetMSTimeDiffToNow(oldMSTime));
 
 }
@@ -1085,6 +1143,8 @@ void SpellMgr::LoadSpellLearnSpells()
 
     mSpellLearnSpells.clear();                              // need for reload case
 
+    std::multimap<uint32, SpellLearnSpellNode> spellLearnSpells;
+
     //                                                  0      1        2
     QueryResult result = WorldDatabase.Query("SELECT entry, SpellID, Active FROM spell_learn_spell");
     if (!result)
@@ -1123,7 +1183,7 @@ void SpellMgr::LoadSpellLearnSpells()
             continue;
         }
 
-        mSpellLearnSpells.insert(SpellLearnSpellMap::value_type(spell_id, node));
+        spellLearnSpells.emplace(spell_id, node);
 
         ++count;
     } while (result->NextRow());
@@ -1154,10 +1214,10 @@ void SpellMgr::LoadSpellLearnSpells()
                 // other required explicit dependent learning
                 dbc_node.autoLearned = spellEffectInfo.TargetA.GetTarget() == TARGET_UNIT_PET || GetTalentSpellCost(spell) > 0 || entry->IsPassive() || entry->HasEffect(SPELL_EFFECT_SKILL_STEP);
 
-                SpellLearnSpellMapBounds db_node_bounds = GetSpellLearnSpellMapBounds(spell);
+                auto db_node_bounds = spellLearnSpells.equal_range(spell);
 
                 bool found = false;
-                for (SpellLearnSpellMap::const_iterator itr = db_node_bounds.first; itr != db_node_bounds.second; ++itr)
+                for (auto itr = db_node_bounds.first; itr != db_node_bounds.second; ++itr)
                 {
                     if (itr->second.spell == dbc_node.spell)
                     {
@@ -1170,13 +1230,15 @@ void SpellMgr::LoadSpellLearnSpells()
 
                 if (!found)                                  // add new spell-spell pair if not found
                 {
-                    mSpellLearnSpells.insert(SpellLearnSpellMap::value_type(spell, dbc_node));
+                    spellLearnSpells.emplace(spell, dbc_node);
                     ++dbc_count;
                 }
             }
         }
     }
 
+    BuildFlatMultiMap(mSpellLearnSpells, spellLearnSpells);
+
     TC_LOG_INFO("server.loading", ">> Loaded %u spell learn spells + %u found in DBC in %u ms", count, dbc_count, GetMSTimeDiffToNow(oldMSTime));
 }
 
@@ -1518,6 +1580,7 @@ void SpellMgr::LoadSpellProcs()
     uint32 oldMSTime = getMSTime();
 
     mSpellProcMap.clear();                             // need for reload case
+    ++_spellProcGeneration;
 
     //                                                     0           1                2                 3                 4                 5
     QueryResult result = WorldDatabase.Query("SELECT SpellId, SchoolMask, SpellFamilyName, SpellFamilyMask0, SpellFamilyMask1, SpellFamilyMask2, "
@@ -1961,6 +2024,7 @@ void SpellMgr::LoadSkillLineAbilityMap()
 
     mSkillLineAbilityMap.clear();
 
+    std::multimap<uint32, SkillLineAbilityEntry const*> skillLineAbilities;
     uint32 count = 0;
 
     for (uint32 i = 0; i < sSkillLineAbilityStore.GetNumRows(); ++i)
@@ -1969,10 +2033,12 @@ void SpellMgr::LoadSkillLineAbilityMap()
         if (!SkillInfo)
             continue;
 
-        mSkillLineAbilityMap.insert(SkillLineAbilityMap::value_type(SkillInfo->Spell, SkillInfo));
+        skillLineAbilities.emplace(SkillInfo->Spell, SkillInfo);
         ++count;
     }
 
+    BuildFlatMultiMap(mSkillLineAbilityMap, skillLineAbilities);
+
     TC_LOG_INFO("server.loading", ">> Loaded %u SkillLineAbility MultiMap Data in %u ms", count, GetMSTimeDiffToNow(oldMSTime));
 }
 
@@ -2183,6 +2249,7 @@ void SpellMgr::LoadPetLevelupSpellMap()
 
     mPetLevelupSpellMap.clear();                                   // need for reload case
 
+    std::map<uint32, std::multimap<uint32, uint32>> petLevelupSpells;
     uint32 count = 0;
     uint32 family_count = 0;
 
@@ -2213,16 +2280,19 @@ void SpellMgr::LoadPetLevelupSpellMap()
                 if (!spell->SpellLevel)
                     continue;
 
-                PetLevelupSpellSet& spellSet = mPetLevelupSpellMap[creatureFamily->ID];
+                std::multimap<uint32, uint32>& spellSet = petLevelupSpells[creatureFamily->ID];
                 if (spellSet.empty())
                     ++family_count;
 
-                spellSet.insert(PetLevelupSpellSet::value_type(spell->SpellLevel, spell->Id));
+                spellSet.emplace(spell->SpellLevel, spell->Id);
                 ++count;
             }
         }
     }
 
+    for (std::pair<uint32 const, std::multimap<uint32, uint32>> const& familySpells : petLevelupSpells)
+        BuildFlatMultiMap(mPetLevelupSpellMap[familySpells.first], familySpells.second);
+
     TC_LOG_INFO("server.loading", ">> Loaded %u pet levelup and default spells for %u families in %u ms", count, family_count, GetMSTimeDiffToNow(oldMSTime));
 }
 
@@ -2362,6 +2432,12 @@ void SpellMgr::LoadSpellAreas()
     mSpellAreaForQuestEndMap.clear();
     mSpellAreaForAuraMap.clear();
 
+    std::multimap<uint32, SpellArea> spellAreas;
+    std::multimap<uint32, SpellArea const*> spellAreasForArea;
+    std::multimap<uint32, SpellArea const*> spellAreasForQuest;
+    std::multimap<uint32, SpellArea const*> spellAreasForQuestEnd;
+    std::multimap<uint32, SpellArea const*> spellAreasForAura;
+
     //                                                  0     1         2              3               4                 5          6          7       8         9
     QueryResult result = WorldDatabase.Query("SELECT spell, area, quest_start, quest_start_status, quest_end_status, quest_end, aura_spell, racemask, gender, autocast FROM spell_area");
     if (!result)
@@ -2402,8 +2478,8 @@ void SpellMgr::LoadSpellAreas()
 
         {
             bool ok = true;
-            SpellAreaMapBounds sa_bounds = GetSpellAreaMapBounds(spellArea.spellId);
-            for (SpellAreaMap::const_iterator itr = sa_bounds.first; itr != sa_bounds.second; ++itr)
+            auto sa_bounds = spellAreas.equal_range(spellArea.spellId);
+            for (auto itr = sa_bounds.first; itr != sa_bounds.second; ++itr)
             {
                 if (spellArea.spellId != itr->second.spellId)
                     continue;
@@ -2470,8 +2546,8 @@ void SpellMgr::LoadSpellAreas()
             if (spellArea.autocast && spellArea.auraSpell > 0)
             {
                 bool chain = false;
-                SpellAreaForAuraMapBounds saBound = GetSpellAreaForAuraMapBounds(spellArea.spellId);
-                for (SpellAreaForAuraMap::const_iterator itr = saBound.first; itr != saBound.second; ++itr)
+                auto saBound = spellAreasForAura.equal_range(spellArea.spellId);
+                for (auto itr = saBound.first; itr != saBound.second; ++itr)
                 {
                     if (itr->second->autocast && itr->second->auraSpell > 0)
                     {
@@ -2486,8 +2562,8 @@ void SpellMgr::LoadSpellAreas()
                     continue;
                 }
 
-                SpellAreaMapBounds saBound2 = GetSpellAreaMapBounds(spellArea.auraSpell);
-                for (SpellAreaMap::const_iterator itr2 = saBound2.first; itr2 != saBound2.second; ++itr2)
+                auto saBound2 = spellAreas.equal_range(spellArea.auraSpell);
+                for (auto itr2 = saBound2.first; itr2 != saBound2.second; ++itr2)
                 {
                     if (itr2->second.autocast && itr2->second.auraSpell > 0)
                     {
@@ -2516,37 +2592,58 @@ void SpellMgr::LoadSpellAreas()
             continue;
         }
 
-        SpellArea const* sa = &mSpellAreaMap.insert(SpellAreaMap::value_type(spell, spellArea))->second;
+        SpellArea const* sa = &spellAreas.emplace(spell, spellArea)->second;
 
         // for search by current zone/subzone at zone/subzone change
         if (spellArea.areaId)
-            mSpellAreaForAreaMap.insert(SpellAreaForAreaMap::value_type(spellArea.areaId, sa));
+            spellAreasForArea.emplace(spellArea.areaId, sa);
 
         // for search at quest update checks
         if (spellArea.questStart || spellArea.questEnd)
         {
             if (spellArea.questStart == spellArea.questEnd)
-                mSpellAreaForQuestMap.insert(SpellAreaForQuestMap::value_type(spellArea.questStart, sa));
+                spellAreasForQuest.emplace(spellArea.questStart, sa);
             else
             {
                 if (spellArea.questStart)
-                    mSpellAreaForQuestMap.insert(SpellAreaForQuestMap::value_type(spellArea.questStart, sa));
+                    spellAreasForQuest.emplace(spellArea.questStart, sa);
                 if (spellArea.questEnd)
-                    mSpellAreaForQuestMap.insert(SpellAreaForQuestMap::value_type(spellArea.questEnd, sa));
+                    spellAreasForQuest.emplace(spellArea.questEnd, sa);
             }
         }
 
         // for search at quest start/reward
         if (spellArea.questEnd)
-            mSpellAreaForQuestEndMap.insert(SpellAreaForQuestMap::value_type(spellArea.questEnd, sa));
+            spellAreasForQuestEnd.emplace(spellArea.questEnd, sa);
 
         // for search at aura apply
         if (spellArea.auraSpell)
-            mSpellAreaForAuraMap.insert(SpellAreaForAuraMap::value_type(abs(spellArea.auraSpell), sa));
+            spellAreasForAura.emplace(abs(spellArea.auraSpell), sa);
 
         ++count;
     } while (result->NextRow());
 
+    BuildFlatMultiMap(mSpellAreaMap, spellAreas);
+
+    // the lookup maps were filled with pointers into spellAreas, point them to the same entries in mSpellAreaMap
+    std::unordered_map<SpellArea const*, SpellArea const*> spellAreaAddresses;
+    SpellAreaMap::const_iterator flatItr = mSpellAreaMap.begin();
+    for (std::pair<uint32 const, SpellArea> const& loadedArea : spellAreas)
+        spellAreaAddresses[&loadedArea.second] = &(flatItr++)->second;
+
+    auto buildLookupMap = [&spellAreaAddresses](boost::container::flat_multimap<uint32, SpellArea const*>& lookupMap, std::multimap<uint32, SpellArea const*>& loadedMap)
+    {
+        for (std::pair<uint32 const, SpellArea const*>& loaded : loadedMap)
+            loaded.second = spellAreaAddresses[loaded.second];
+
+        BuildFlatMultiMap(lookupMap, loadedMap);
+    };
+
+    buildLookupMap(mSpellAreaForAreaMap, spellAreasForArea);
+    buildLookupMap(mSpellAreaForQuestMap, spellAreasForQuest);
+    buildLookupMap(mSpellAreaForQuestEndMap, spellAreasForQuestEnd);
+    buildLookupMap(mSpellAreaForAuraMap, spellAreasForAura);
+
     TC_LOG_INFO("server.loading", ">> Loaded %u spell area requirements in %u ms", count, GetMSTimeDiffToNow(oldMSTime));
 }
 
@@ -2557,8 +2654,15 @@ void SpellMgr::LoadSpellInfoStore()
     UnloadSpellInfoStore();
     mSpellInfoMap.resize(sSpellStore.GetNumRows(), nullptr);
 
-    for (SpellEntry const* spellEntry : sSpellStore)
-        mSpellInfoMap[spellEntry->ID] = new SpellInfo(spellEntry);
+    // all SpellInfo objects live in one block, in spell id order
+    std::vector<SpellEntry const*> spellEntries(sSpellStore.begin(), sSpellStore.end());
+    _spellInfoStorage = std::allocator<SpellInfo>().allocate(spellEntries.size());
+
+    uint32 threads = ParallelForSpellIndex(spellEntries.size(), sWorld->getIntConfig(CONFIG_SPELL_LOAD_THREADS), [&](std::size_t index)
+    {
+        mSpellInfoMap[spellEntries[index]->ID] = new (&_spellInfoStorage[index]) SpellInfo(spellEntries[index]);
+    });
+    _spellInfoStorageSize = spellEntries.size();
 
     for (uint32 spellIndex = 0; spellIndex < GetSpellInfoStoreSize(); ++spellIndex)
     {
@@ -2575,14 +2679,72 @@ void SpellMgr::LoadSpellInfoStore()
         }
     }
 
-    TC_LOG_INFO("server.loading", ">> Loaded SpellInfo store in %u ms", GetMSTimeDiffToNow(oldMSTime));
+    uint32 checksum = GetSpellInfoChecksum();
+    TC_LOG_INFO("server.loading", ">> Loaded SpellInfo store in %u ms (%u threads, checksum 0x%08X)", GetMSTimeDiffToNow(oldMSTime), threads, checksum);
+
+    if (threads > 1 && sWorld->getBoolConfig(CONFIG_SPELL_LOAD_VERIFY))
+    {
+        for (uint32 i = 0; i < _spellInfoStorageSize; ++i)
+        {
+            _spellInfoStorage[i].~SpellInfo();
+            new (&_spellInfoStorage[i]) SpellInfo(spellEntries[i]);
+        }
+
+        uint32 serialChecksum = GetSpellInfoChecksum();
+        if (serialChecksum != checksum)
+            TC_LOG_ERROR("server.loading", "SpellInfo store checksum 0x%08X differs from serial load checksum 0x%08X", checksum, serialChecksum);
+    }
+}
+
+uint32 SpellMgr::GetSpellInfoChecksum() const
+{
+    uint32 hash = 2166136261u;
+    for (SpellInfo const* spellInfo : mSpellInfoMap)
+    {
+        if (!spellInfo)
+            continue;
+
+        hash ^= spellInfo->_GetLoadedDataChecksum();
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+void SpellMgr::ProcessSpellInfoPass(char const* description, std::function<void(SpellInfo*)> const& pass)
+{
+    uint32 oldMSTime = getMSTime();
+
+    auto work = [this, &pass](std::size_t index)
+    {
+        if (SpellInfo* spellInfo = mSpellInfoMap[index])
+            pass(spellInfo);
+    };
+
+    uint32 threads = ParallelForSpellIndex(mSpellInfoMap.size(), sWorld->getIntConfig(CONFIG_SPELL_LOAD_THREADS), work);
+    uint32 checksum = GetSpellInfoChecksum();
+    TC_LOG_INFO("server.loading", ">> Loaded SpellInfo %s in %u ms (%u threads, checksum 0x%08X)", description, GetMSTimeDiffToNow(oldMSTime), threads, checksum);
+
+    // every pass overwrites all data it computes, running it again serially must reproduce the same data
+    if (threads > 1 && sWorld->getBoolConfig(CONFIG_SPELL_LOAD_VERIFY))
+    {
+        ParallelForSpellIndex(mSpellInfoMap.size(), 1, work);
+        uint32 serialChecksum = GetSpellInfoChecksum();
+        if (serialChecksum != checksum)
+            TC_LOG_ERROR("server.loading", "SpellInfo %s checksum 0x%08X differs from serial load checksum 0x%08X", description, checksum, serialChecksum);
+    }
 }
 
 void SpellMgr::UnloadSpellInfoStore()
 {
-    for (uint32 i = 0; i < GetSpellInfoStoreSize(); ++i)
-        delete mSpellInfoMap[i];
+    for (uint32 i = 0; i < _spellInfoStorageSize; ++i)
+        _spellInfoStorage[i].~SpellInfo();
+
+    if (_spellInfoStorage)
+        std::allocator<SpellInfo>().deallocate(_spellInfoStorage, _spellInfoStorageSize);
 
+    _spellInfoStorage = nullptr;
+    _spellInfoStorageSize = 0;
     mSpellInfoMap.clear();
 }
 
@@ -5050,47 +5212,26 @@ void SpellMgr::LoadSpellInfoCorrections()
 
 void SpellMgr::LoadSpellInfoSpellSpecificAndAuraState()
 {
-    uint32 oldMSTime = getMSTime();
-
-    for (SpellInfo* spellInfo : mSpellInfoMap)
+    ProcessSpellInfoPass("SpellSpecific and AuraState", [](SpellInfo* spellInfo)
     {
-        if (!spellInfo)
-            continue;
-
         // AuraState depends on SpellSpecific
         spellInfo->_LoadSpellSpecific();
         spellInfo->_LoadAuraState();
-    }
-
-    TC_LOG_INFO("server.loading", ">> Loaded SpellInfo SpellSpecific and AuraState in %u ms", GetMSTimeDiffToNow(oldMSTime));
+    });
 }
 
 void SpellMgr::LoadSpellInfoDiminishing()
 {
-    uint32 oldMSTime = getMSTime();
-
-    for (SpellInfo* spellInfo : mSpellInfoMap)
+    ProcessSpellInfoPass("diminishing infos", [](SpellInfo* spellInfo)
     {
-        if (!spellInfo)
-            continue;
-
         spellInfo->_LoadSpellDiminishInfo();
-    }
-
-    TC_LOG_INFO("server.loading", ">> Loaded SpellInfo diminishing infos in %u ms", GetMSTimeDiffToNow(oldMSTime));
+    });
 }
 
 void SpellMgr::LoadSpellInfoImmunities()
 {
-    uint32 oldMSTime = getMSTime();
-
-    for (SpellInfo* spellInfo : mSpellInfoMap)
+    ProcessSpellInfoPass("immunity infos", [](SpellInfo* spellInfo)
     {
-        if (!spellInfo)
-            continue;
-
         spellInfo->_LoadImmunityInfo();
-    }
-
-    TC_LOG_INFO("server.loading", ">> Loaded SpellInfo immunity infos in %u ms", GetMSTimeDiffToNow(oldMSTime));
+    });
 }
@@ -25,7 +25,9 @@
 #include "IteratorPair.h"
 #include "SharedDefines.h"
 #include "Util.h"
+#include <boost/container/flat_map.hpp>
 
+#include <functional>
 #include <map>
 #include <set>
 #include <vector>
@@ -483,10 +485,11 @@ struct TC_GAME_API SpellArea
     bool IsFitToRequirements(Player const* player, uint32 newZone, uint32 newArea) const;
 };
 
-typedef std::multimap<uint32, SpellArea> SpellAreaMap;
-typedef std::multimap<uint32, SpellArea const*> SpellAreaForQuestMap;
-typedef std::multimap<uint32, SpellArea const*> SpellAreaForAuraMap;
-typedef std::multimap<uint32, SpellArea const*> SpellAreaForAreaMap;
+// the multimaps below are sorted vectors, filled once at load and only read afterwards
+typedef boost::container::flat_multimap<uint32, SpellArea> SpellAreaMap;
+typedef boost::container::flat_multimap<uint32, SpellArea const*> SpellAreaForQuestMap;
+typedef boost::container::flat_multimap<uint32, SpellArea const*> SpellAreaForAuraMap;
+typedef boost::container::flat_multimap<uint32, SpellArea const*> SpellAreaForAreaMap;
 typedef std::pair<SpellAreaMap::const_iterator, SpellAreaMap::const_iterator> SpellAreaMapBounds;
 typedef std::pair<SpellAreaForQuestMap::const_iterator, SpellAreaForQuestMap::const_iterator> SpellAreaForQuestMapBounds;
 typedef std::pair<SpellAreaForAuraMap::const_iterator, SpellAreaForAuraMap::const_iterator> SpellAreaForAuraMapBounds;
@@ -505,11 +508,11 @@ struct SpellChainNode
 typedef std::unordered_map<uint32, SpellChainNode> SpellChainMap;
 
 //                   spell_id  req_spell
-typedef std::multimap<uint32, uint32> SpellRequiredMap;
+typedef boost::container::flat_multimap<uint32, uint32> SpellRequiredMap;
 typedef std::pair<SpellRequiredMap::const_iterator, SpellRequiredMap::const_iterator> SpellRequiredMapBounds;
 
 //                   req_spell spell_id
-typedef std::multimap<uint32, uint32> SpellsRequiringSpellMap;
+typedef boost::container::flat_multimap<uint32, uint32> SpellsRequiringSpellMap;
 typedef std::pair<SpellsRequiringSpellMap::const_iterator, SpellsRequiringSpellMap::const_iterator> SpellsRequiringSpellMapBounds;
 
 // Spell learning properties (accessed using SpellMgr functions)
@@ -530,13 +533,13 @@ struct SpellLearnSpellNode
     bool autoLearned;
 };
 
-typedef std::multimap<uint32, SpellLearnSpellNode> SpellLearnSpellMap;
+typedef boost::container::flat_multimap<uint32, SpellLearnSpellNode> SpellLearnSpellMap;
 typedef std::pair<SpellLearnSpellMap::const_iterator, SpellLearnSpellMap::const_iterator> SpellLearnSpellMapBounds;
 
-typedef std::multimap<uint32, SkillLineAbilityEntry const*> SkillLineAbilityMap;
+typedef boost::container::flat_multimap<uint32, SkillLineAbilityEntry const*> SkillLineAbilityMap;
 typedef std::pair<SkillLineAbilityMap::const_iterator, SkillLineAbilityMap::const_iterator> SkillLineAbilityMapBounds;
 
-typedef std::multimap<uint32, uint32> PetLevelupSpellSet;
+typedef boost::container::flat_multimap<uint32, uint32> PetLevelupSpellSet;
 typedef std::map<uint32, PetLevelupSpellSet> PetLevelupSpellMap;
 
 typedef std::map<uint32, uint32> SpellDifficultySearcherMap;
@@ -628,6 +631,8 @@ class TC_GAME_API SpellMgr
 
         // Spell proc table
         SpellProcEntry const* GetSpellProcEntry(uint32 spellId) const;
+        // incremented whenever spell_proc is (re)loaded
+        uint32 GetSpellProcGeneration() const { return _spellProcGeneration; }
         static bool CanSpellTriggerProcOnEvent(SpellProcEntry const& procEntry, ProcEventInfo& eventInfo);
 
         // Spell bonus data table
@@ -703,7 +708,13 @@ class TC_GAME_API SpellMgr
         void LoadSpellInfoDiminishing();
         void LoadSpellInfoImmunities();
 
+        // hash of the SpellInfo data computed at load, in spell id order
+        uint32 GetSpellInfoChecksum() const;
+
     private:
+        // runs a pass that only writes to the SpellInfo it is called for, spread over SpellMgr.LoadThreads threads
+        void ProcessSpellInfoPass(char const* description, std::function<void(SpellInfo*)> const& pass);
+
         SpellDifficultySearcherMap mSpellDifficultySearcherMap;
         SpellChainMap              mSpellChains;
         SpellsRequiringSpellMap    mSpellsReqSpell;
@@ -716,6 +727,7 @@ class TC_GAME_API SpellMgr
         SpellGroupStackMap         mSpellGroupStack;
         SameEffectStackMap         mSpellSameEffectStack;
         SpellProcMap               mSpellProcMap;
+        uint32                     _spellProcGeneration;
         SpellBonusMap              mSpellBonusMap;
         SpellThreatMap             mSpellThreatMap;
         SpellPetAuraMap            mSpellPetAuraMap;
@@ -731,6 +743,8 @@ class TC_GAME_API SpellMgr
         PetLevelupSpellMap         mPetLevelupSpellMap;
         PetDefaultSpellsMap        mPetDefaultSpellsMap;           // only spells not listed in related mPetLevelupSpellMap entry
         SpellInfoMap               mSpellInfoMap;
+        SpellInfo*                 _spellInfoStorage;              // contiguous block of all SpellInfo objects, mSpellInfoMap points into it
+        uint32                     _spellInfoStorageSize;
 
     friend class UnitTestDataLoader;
 };
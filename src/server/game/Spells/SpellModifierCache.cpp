@@ -0,0 +1,82 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SpellModifierCache.h"
+#include "Player.h"
+#include "SpellAuras.h"
+#include "SpellInfo.h"
+
+SpellModifierCache::Entry const& SpellModifierCache::Get(SpellInfo const* spellInfo, SpellModOp op, SpellModContainer const& mods)
+{
+    Entry& entry = _entries[uint64(spellInfo->Id) << 8 | op];
+    if (entry.Version != _version)
+    {
+        Resolve(spellInfo, op, mods, entry);
+        entry.Version = _version;
+    }
+
+    return entry;
+}
+
+/*static*/ void SpellModifierCache::Resolve(SpellInfo const* spellInfo, SpellModOp op, SpellModContainer const& mods, Entry& entry)
+{
+    entry.Flat = 0;
+    entry.Pct = 0.0f;
+    entry.Applied.clear();
+    entry.Dynamic.clear();
+
+    for (SpellModifier* mod : mods)
+    {
+        if (IsCheckedPerCall(mod, op))
+        {
+            entry.Dynamic.push_back(mod);
+            continue;
+        }
+
+        if (!Player::IsAffectedBySpellmod(spellInfo, mod))
+            continue;
+
+        if (mod->type == SPELLMOD_FLAT)
+            entry.Flat += mod->value;
+        else
+            entry.Pct += CalculatePct(1.0f, mod->value);
+
+        entry.Applied.push_back(mod);
+    }
+}
+
+/*static*/ bool SpellModifierCache::IsCheckedPerCall(SpellModifier const* mod, SpellModOp op)
+{
+    // charges decide about the modifier applied and are consumed by the cast
+    if (mod->ownerAura && mod->ownerAura->IsUsingCharges())
+        return true;
+
+    if (mod->type != SPELLMOD_PCT)
+        return false;
+
+    // special cases of Player::ApplySpellMod depending on the base value or the cast
+    switch (op)
+    {
+        case SPELLMOD_CASTING_TIME:
+            return mod->value <= -100;
+        case SPELLMOD_CRITICAL_CHANCE:
+        case SPELLMOD_GLOBAL_COOLDOWN:
+            return true;
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,67 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_SPELLMODIFIERCACHE_H
+#define TRINITY_SPELLMODIFIERCACHE_H
+
+#include "Define.h"
+#include "SpellDefines.h"
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class SpellInfo;
+struct SpellModifier;
+
+typedef std::unordered_set<SpellModifier*> SpellModContainer;
+
+/**
+    Per player cache of spell modifiers resolved for a (spell, SpellModOp) pair.
+    Modifiers without charges are summed up once, modifiers with charges and the special cased
+    percent modifiers of Player::ApplySpellMod depend on the cast and are kept aside to be checked on every call.
+    Entries are valid until Invalidate is called, which has to happen whenever the modifier set changes.
+*/
+class TC_GAME_API SpellModifierCache
+{
+public:
+    struct Entry
+    {
+        Entry() : Version(0), Flat(0), Pct(0.0f) { }
+
+        uint32 Version;
+        int32 Flat;                             // sum of resolved flat modifiers
+        float Pct;                              // sum of resolved percent modifiers, as a fraction of 1
+        std::vector<SpellModifier*> Applied;    // resolved modifiers affecting the spell, registered in the cast for the proc system
+        std::vector<SpellModifier*> Dynamic;    // modifiers checked on every call
+    };
+
+    SpellModifierCache() : _version(1) { }
+
+    Entry const& Get(SpellInfo const* spellInfo, SpellModOp op, SpellModContainer const& mods);
+    void Invalidate() { ++_version; }
+    void Clear() { _entries.clear(); ++_version; }
+
+    // full scan of the modifiers, the work done by Get on a miss
+    static void Resolve(SpellInfo const* spellInfo, SpellModOp op, SpellModContainer const& mods, Entry& entry);
+    static bool IsCheckedPerCall(SpellModifier const* mod, SpellModOp op);
+
+private:
+    uint32 _version;
+    std::unordered_map<uint64 /*spellId << 8 | op*/, Entry> _entries;
+};
+
+#endif
@@ -0,0 +1,136 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SpellObjectPool.h"
+#include "Metric.h"
+#include <atomic>
+#include <new>
+
+namespace
+{
+    char const* const PoolNames[MAX_SPELL_OBJECT_POOLS] =
+    {
+        "Spell",
+        "SpellEvent",
+        "UnitAura",
+        "DynObjAura",
+        "AuraEffect",
+        "AuraApplication"
+    };
+
+    struct PoolCounters
+    {
+        std::atomic<uint64> Allocations{ 0 };
+        std::atomic<uint64> HeapAllocations{ 0 };
+    };
+
+    PoolCounters Counters[MAX_SPELL_OBJECT_POOLS];
+
+    struct FreeBlock
+    {
+        FreeBlock* Next;
+    };
+
+    // set when the free lists of the thread are destroyed, objects destroyed by later thread_local or static destructors bypass the pool.
+    // Kept outside of ThreadFreeLists, stores to an object in its own destructor may be optimized away
+    thread_local bool FreeListsDestroyed = false;
+
+    struct ThreadFreeLists
+    {
+        FreeBlock* Head[MAX_SPELL_OBJECT_POOLS] = { };
+        uint32 Count[MAX_SPELL_OBJECT_POOLS] = { };
+        std::size_t BlockSize[MAX_SPELL_OBJECT_POOLS] = { };
+
+        ~ThreadFreeLists()
+        {
+            for (uint8 i = 0; i < MAX_SPELL_OBJECT_POOLS; ++i)
+            {
+                while (FreeBlock* block = Head[i])
+                {
+                    Head[i] = block->Next;
+                    ::operator delete(block);
+                }
+
+                Count[i] = 0;
+            }
+
+            FreeListsDestroyed = true;
+        }
+    };
+
+    thread_local ThreadFreeLists FreeLists;
+}
+
+void* SpellObjectPool::Allocate(SpellObjectPoolType type, std::size_t size)
+{
+    Counters[type].Allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (FreeListsDestroyed)
+    {
+        Counters[type].HeapAllocations.fetch_add(1, std::memory_order_relaxed);
+        return ::operator new(size);
+    }
+
+    if (FreeBlock* block = FreeLists.Head[type])
+    {
+        if (FreeLists.BlockSize[type] == size)
+        {
+            FreeLists.Head[type] = block->Next;
+            --FreeLists.Count[type];
+            return block;
+        }
+    }
+
+    Counters[type].HeapAllocations.fetch_add(1, std::memory_order_relaxed);
+    return ::operator new(size);
+}
+
+void SpellObjectPool::Deallocate(SpellObjectPoolType type, void* ptr, std::size_t size)
+{
+    if (!ptr)
+        return;
+
+    if (FreeListsDestroyed)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+
+    // a pool only keeps blocks of one size, the size of the final class
+    if (!FreeLists.BlockSize[type])
+        FreeLists.BlockSize[type] = size;
+
+    if (FreeLists.BlockSize[type] != size || FreeLists.Count[type] >= SPELL_OBJECT_POOL_MAX_FREE_BLOCKS)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    block->Next = FreeLists.Head[type];
+    FreeLists.Head[type] = block;
+    ++FreeLists.Count[type];
+}
+
+void SpellObjectPool::UpdateMetrics()
+{
+    for (uint8 i = 0; i < MAX_SPELL_OBJECT_POOLS; ++i)
+    {
+        TC_METRIC_VALUE("spell_object_allocations", Counters[i].Allocations.exchange(0, std::memory_order_relaxed), TC_METRIC_TAG("type", PoolNames[i]));
+        TC_METRIC_VALUE("spell_object_heap_allocations", Counters[i].HeapAllocations.exchange(0, std::memory_order_relaxed), TC_METRIC_TAG("type", PoolNames[i]));
+    }
+}
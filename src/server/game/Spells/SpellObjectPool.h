@@ -0,0 +1,59 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_SPELLOBJECTPOOL_H
+#define TRINITY_SPELLOBJECTPOOL_H
+
+#include "Define.h"
+#include <cstddef>
+
+enum SpellObjectPoolType : uint8
+{
+    SPELL_OBJECT_POOL_SPELL,
+    SPELL_OBJECT_POOL_SPELL_EVENT,
+    SPELL_OBJECT_POOL_UNIT_AURA,
+    SPELL_OBJECT_POOL_DYNOBJ_AURA,
+    SPELL_OBJECT_POOL_AURA_EFFECT,
+    SPELL_OBJECT_POOL_AURA_APPLICATION,
+
+    MAX_SPELL_OBJECT_POOLS
+};
+
+// freed blocks kept per pool and thread
+#define SPELL_OBJECT_POOL_MAX_FREE_BLOCKS 1024
+
+/**
+    Recycles the memory of objects created for every cast and aura application.
+    Freed blocks go to a free list of the freeing thread and are handed out again by the next allocation of the same
+    type on that thread. Maps are updated on the map worker threads, so every worker keeps the blocks of the maps it
+    updates. Blocks are plain heap memory until reused, objects moving to another map or freed by another thread need no special care.
+*/
+class TC_GAME_API SpellObjectPool
+{
+public:
+    static void* Allocate(SpellObjectPoolType type, std::size_t size);
+    static void Deallocate(SpellObjectPoolType type, void* ptr, std::size_t size);
+
+    // sends allocation counters since the last call to the metric backend
+    static void UpdateMetrics();
+};
+
+#define SPELL_OBJECT_POOL_OPERATORS(type) \
+    static void* operator new(std::size_t size) { return SpellObjectPool::Allocate(type, size); } \
+    static void operator delete(void* ptr, std::size_t size) { SpellObjectPool::Deallocate(type, ptr, size); }
+
+#endif
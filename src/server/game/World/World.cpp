@@ -77,6 +77,7 @@
 #include "SkillExtraItems.h"
 #include "SmartScriptMgr.h"
 #include "SpellMgr.h"
+#include "SpellObjectPool.h"
 #include "TicketMgr.h"
 #include "TransportMgr.h"
 #include "Unit.h"
@@ -88,6 +89,7 @@
 #include "WeatherMgr.h"
 #include "WhoListStorage.h"
 #include "WorldSession.h"
+#include "WorldSessionUpdater.h"
 
 #include <boost/asio/ip/address.hpp>
 
@@ -107,7 +109,7 @@ TC_GAME_API int32 World::m_visibility_notify_periodInBG         = DEFAULT_VISIBI
 TC_GAME_API int32 World::m_visibility_notify_periodInArenas     = DEFAULT_VISIBILITY_NOTIFY_PERIOD;
 
 /// World constructor
-World::World()
+World::World() : m_sessionUpdater(std::make_unique<WorldSessionUpdater>())
 {
     m_playerLimit = 0;
     m_allowedSecurityLevel = SEC_PLAYER;
@@ -150,6 +152,9 @@ World::World()
 /// World destructor
 World::~World()
 {
+    if (m_sessionUpdater->IsActive())
+        m_sessionUpdater->Deactivate();
+
     ///- Empty the kicked session set
     while (!m_sessions.empty())
     {
@@ -1433,6 +1438,8 @@ void World::LoadConfigSettings(bool reload)
     m_bool_configs[CONFIG_SHOW_MUTE_IN_WORLD] = sConfigMgr->GetBoolDefault("ShowMuteInWorld", false);
     m_bool_configs[CONFIG_SHOW_BAN_IN_WORLD] = sConfigMgr->GetBoolDefault("ShowBanInWorld", false);
     m_int_configs[CONFIG_NUMTHREADS] = sConfigMgr->GetIntDefault("MapUpdate.Threads", 1);
+    m_int_configs[CONFIG_SESSION_UPDATE_THREADS] = sConfigMgr->GetIntDefault("SessionUpdate.Threads", 0);
+    m_int_configs[CONFIG_MAP_UPDATE_SPIKE_THRESHOLD] = sConfigMgr->GetIntDefault("MapUpdate.SpikeThreshold", 0);
     m_int_configs[CONFIG_MAX_RESULTS_LOOKUP_COMMANDS] = sConfigMgr->GetIntDefault("Command.LookupMaxResults", 0);
 
     // Warden
@@ -1542,9 +1549,24 @@ void World::LoadConfigSettings(bool reload)
     // Anti movement cheat measure. Time each client have to acknowledge a movement change until they are kicked
     m_int_configs[CONFIG_PENDING_MOVE_CHANGES_TIMEOUT] = sConfigMgr->GetIntDefault("AntiCheat.PendingMoveChangesTimeoutTime", 0);
 
+    // Number of cached static geometry query results per map and query type
+    m_int_configs[CONFIG_MAP_QUERY_CACHE_SIZE] = sConfigMgr->GetIntDefault("MapQueryCache.Size", 2048);
+
     // Specifies if IP addresses can be logged to the database
     m_bool_configs[CONFIG_ALLOW_LOGGING_IP_ADDRESSES_IN_DATABASE] = sConfigMgr->GetBoolDefault("AllowLoggingIPAddressesInDatabase", true, true);
 
+    // Compare the per unit proc aura index against a full scan of applied auras on every proc event
+    m_bool_configs[CONFIG_PROC_AURA_INDEX_VERIFY] = sConfigMgr->GetBoolDefault("ProcAuraIndex.Verify", false);
+
+    // Number of threads used by the per spell SpellInfo load passes
+    m_int_configs[CONFIG_SPELL_LOAD_THREADS] = sConfigMgr->GetIntDefault("SpellMgr.LoadThreads", 1);
+
+    // Repeat multithreaded SpellInfo load passes serially and compare the checksums
+    m_bool_configs[CONFIG_SPELL_LOAD_VERIFY] = sConfigMgr->GetBoolDefault("SpellMgr.LoadThreads.Verify", false);
+
+    // Time slot in which periodic aura logs of a map are collected before they are sent
+    m_int_configs[CONFIG_PERIODIC_AURA_LOG_BATCH_INTERVAL] = sConfigMgr->GetIntDefault("PeriodicAura.LogBatchInterval", 0);
+
     // call ScriptMgr if we're reloading the configuration
     if (reload)
         sScriptMgr->OnConfigLoad(reload);
@@ -2152,6 +2174,9 @@ void World::SetInitialWorldSettings()
     TC_LOG_INFO("server.loading", "Starting Map System");
     sMapMgr->Initialize();
 
+    if (uint32 sessionThreads = getIntConfig(CONFIG_SESSION_UPDATE_THREADS))
+        m_sessionUpdater->Activate(sessionThreads);
+
     TC_LOG_INFO("server.loading", "Starting Game Event system...");
     uint32 nextGameEvent = sGameEventMgr->StartSystem();
     m_timers[WUPDATE_EVENTS].SetInterval(nextGameEvent);    //depend on next event
@@ -2312,7 +2337,7 @@ void World::LoadAutobroadcasts()
 /// Update the World !
 void World::Update(uint32 diff)
 {
-    TC_METRIC_TIMER("world_update_time_total");
+    TC_METRIC_AGGREGATED_TIMER("world_update_time_total");
     ///- Update the game time and check for shutdown time
     _UpdateGameTime();
     time_t currentGameTime = GameTime::GetGameTime();
@@ -2331,7 +2356,7 @@ void World::Update(uint32 diff)
     ///- Update Who List Storage
     if (m_timers[WUPDATE_WHO_LIST].Passed())
     {
-        TC_METRIC_TIMER("world_update_time", TC_METRIC_TAG("type", "Update who list"));
+        TC_METRIC_AGGREGATED_TIMER("world_update_time", TC_METRIC_TAG("type", "Update who list"));
         m_timers[WUPDATE_WHO_LIST].Reset();
         sWhoListStorageMgr->Update();
     }
@@ -2342,7 +2367,7 @@ void World::Update(uint32 diff)
 
         if (sWorld->getBoolConfig(CONFIG_PRESERVE_CUSTOM_CHANNELS))
         {
-            TC_METRIC_TIMER("world_update_time", TC_METRIC_TAG("type", "Save custom channels"));
+            TC_METRIC_AGGREGATED_TIMER("world_update_time", TC_METRIC_TAG("type", "Save custom channels"));
             ChannelMgr* mgr1 = ASSERT_NOTNULL(ChannelMgr::forTeam(ALLIANCE));
             mgr1->SaveToDB();
             ChannelMgr* mgr2 = ASSERT_NOTNULL(ChannelMgr::forTeam(HORDE));
@@ -2352,32 +2377,32 @@ void World::Update(uint32 diff)
     }
 
     {
-        TC_METRIC_TIMER("world_update_time", TC_METRIC_TAG("type", "Check quest reset times"));
+        TC_METRIC_AGGREGATED_TIMER("world_update_time", TC_METRIC_TAG("type", "Check quest reset times"));
         CheckQuestResetTimes();
     }
 
     if (currentGameTime > m_NextRandomBGReset)
     {
-        TC_METRIC_TIMER("world_update_time", TC_METRIC_TAG("type", "Reset random BG"));
+        TC_METRIC_AGGREGATED_TIMER("world_update_time", TC_METRIC_TAG("type", "Reset random BG"));
         ResetRandomBG();
     }
 
     if (currentGameTime > m_NextCalendarOldEventsDeletionTime)
     {
-        TC_METRIC_TIMER("world_update_time", TC_METRIC_TAG("type", "Delete old calendar events"));
+        TC_METRIC_AGGREGATED_TIMER("world_update_time", TC_METRIC_TAG("type", "Delete old calendar events"));
         CalendarDeleteOldEvents();
     }
 
     if (currentGameTime > m_NextGuildReset)
     {
-        TC_METRIC_TIMER("world_update_time", TC_METRIC_TAG("type", "Reset guild cap"));
+        TC_METRIC_AGGREGATED_TIMER("world_update_time", TC_METRIC_TAG("type", "Reset guild cap"));
         ResetGuildCap();
     }
 
     /// <ul><li> Handle auctions when the timer has passed
     if (m_timers[WUPDATE_AUCTIONS].Passed())
     {
-        TC_METRIC_TIMER("world_update_time", TC_METRIC_TAG("type", "Update expired auctions"));
+        TC_METRIC_AGGREGATED_TIMER("world_update_time", TC_METRIC_TAG("type", "Update expired auctions"));
         m_timers[WUPDATE_AUCTIONS].Reset();
 
         ///- Update mails (return old mails with item, or delete them)
@@ -2394,7 +2419,7 @@ void World::Update(uint32 diff)
 
     if (m_timers[WUPDATE_AUCTIONS_PENDING].Passed())
     {
-        TC_METRIC_TIMER("world_update_time", TC_METRIC_TAG("type", "Update pending auctions"));
+        TC_METRIC_AGGREGATED_TIMER("world_update_time", TC_METRIC_TAG("type", "Update pending auctions"));
         m_timers[WUPDATE_AUCTIONS_PENDING].Reset();
 
         sAuctionMgr->UpdatePendingAuctions();
@@ -2403,7 +2428,7 @@ void World::Update(uint32 diff)
     /// <li> Handle AHBot operations
     if (m_timers[WUPDATE_AHBOT].Passed())
     {
-        TC_METRIC_TIMER("world_update_time", TC_METRIC_TAG("type", "Update AHBot"));
+        TC_METRIC_AGGREGATED_TIMER("world_update_time", TC_METRIC_TAG("type", "Update AHBot"));
         sAuctionBot->Update();
         m_timers[WUPDATE_AHBOT].Reset();
     }
@@ -2411,21 +2436,21 @@ void World::Update(uint32 diff)
     /// <li> Handle file changes
     if (m_timers[WUPDATE_CHECK_FILECHANGES].Passed())
     {
-        TC_METRIC_TIMER("world_update_time", TC_METRIC_TAG("type", "Update HotSwap"));
+        TC_METRIC_AGGREGATED_TIMER("world_update_time", TC_METRIC_TAG("type", "Update HotSwap"));
         sScriptReloadMgr->Update();
         m_timers[WUPDATE_CHECK_FILECHANGES].Reset();
     }
 
     {
         /// <li> Handle session updates when the timer has passed
-        TC_METRIC_TIMER("world_update_time", TC_METRIC_TAG("type", "Update sessions"));
+        TC_METRIC_AGGREGATED_TIMER("world_update_time", TC_METRIC_TAG("type", "Update sessions"));
         UpdateSessions(diff);
     }
 
     /// <li> Update uptime table
     if (m_timers[WUPDATE_UPTIME].Passed())
     {
-        TC_METRIC_TIMER("world_update_time", TC_METRIC_TAG("type", "Update uptime"));
+        TC_METRIC_AGGREGATED_TIMER("world_update_time", TC_METRIC_TAG("type", "Update uptime"));
         uint32 tmpDiff = GameTime::GetUptime();
         uint32 maxOnlinePlayers = GetMaxPlayerCount();
 
@@ -2446,7 +2471,7 @@ void World::Update(uint32 diff)
     {
         if (m_timers[WUPDATE_CLEANDB].Passed())
         {
-            TC_METRIC_TIMER("world_update_time", TC_METRIC_TAG("type", "Clean logs table"));
+            TC_METRIC_AGGREGATED_TIMER("world_update_time", TC_METRIC_TAG("type", "Clean logs table"));
             m_timers[WUPDATE_CLEANDB].Reset();
 
             LoginDatabasePreparedStatement* stmt = LoginDatabase.GetPreparedStatement(LOGIN_DEL_OLD_LOGS);
@@ -2462,7 +2487,7 @@ void World::Update(uint32 diff)
     /// <li> Handle all other objects
     ///- Update objects when the timer has passed (maps, transport, creatures, ...)
     {
-        TC_METRIC_TIMER("world_update_time", TC_METRIC_TAG("type", "Update maps"));
+        TC_METRIC_AGGREGATED_TIMER("world_update_time", TC_METRIC_TAG("type", "Update maps"));
         sMapMgr->Update(diff);
     }
 
@@ -2470,47 +2495,47 @@ void World::Update(uint32 diff)
     {
         if (m_timers[WUPDATE_AUTOBROADCAST].Passed())
         {
-            TC_METRIC_TIMER("world_update_time", TC_METRIC_TAG("type", "Send autobroadcast"));
+            TC_METRIC_AGGREGATED_TIMER("world_update_time", TC_METRIC_TAG("type", "Send autobroadcast"));
             m_timers[WUPDATE_AUTOBROADCAST].Reset();
             SendAutoBroadcast();
         }
     }
 
     {
-        TC_METRIC_TIMER("world_update_time", TC_METRIC_TAG("type", "Update battlegrounds"));
+        TC_METRIC_AGGREGATED_TIMER("world_update_time", TC_METRIC_TAG("type", "Update battlegrounds"));
         sBattlegroundMgr->Update(diff);
     }
 
     {
-        TC_METRIC_TIMER("world_update_time", TC_METRIC_TAG("type", "Update outdoor pvp"));
+        TC_METRIC_AGGREGATED_TIMER("world_update_time", TC_METRIC_TAG("type", "Update outdoor pvp"));
         sOutdoorPvPMgr->Update(diff);
     }
 
     {
-        TC_METRIC_TIMER("world_update_time", TC_METRIC_TAG("type", "Update battlefields"));
+        TC_METRIC_AGGREGATED_TIMER("world_update_time", TC_METRIC_TAG("type", "Update battlefields"));
         sBattlefieldMgr->Update(diff);
     }
 
     ///- Delete all characters which have been deleted X days before
     if (m_timers[WUPDATE_DELETECHARS].Passed())
     {
-        TC_METRIC_TIMER("world_update_time", TC_METRIC_TAG("type", "Delete old characters"));
+        TC_METRIC_AGGREGATED_TIMER("world_update_time", TC_METRIC_TAG("type", "Delete old characters"));
         m_timers[WUPDATE_DELETECHARS].Reset();
         Player::DeleteOldCharacters();
     }
 
     {
-        TC_METRIC_TIMER("world_update_time", TC_METRIC_TAG("type", "Update groups"));
+        TC_METRIC_AGGREGATED_TIMER("world_update_time", TC_METRIC_TAG("type", "Update groups"));
         sGroupMgr->Update(diff);
     }
 
     {
-        TC_METRIC_TIMER("world_update_time", TC_METRIC_TAG("type", "Update LFG"));
+        TC_METRIC_AGGREGATED_TIMER("world_update_time", TC_METRIC_TAG("type", "Update LFG"));
         sLFGMgr->Update(diff);
     }
 
     {
-        TC_METRIC_TIMER("world_update_time", TC_METRIC_TAG("type", "Process query callbacks"));
+        TC_METRIC_AGGREGATED_TIMER("world_update_time", TC_METRIC_TAG("type", "Process query callbacks"));
         // execute callbacks from sql queries that were queued recently
         ProcessQueryCallbacks();
     }
@@ -2518,7 +2543,7 @@ void World::Update(uint32 diff)
     ///- Erase corpses once every 20 minutes
     if (m_timers[WUPDATE_CORPSES].Passed())
     {
-        TC_METRIC_TIMER("world_update_time", TC_METRIC_TAG("type", "Remove old corpses"));
+        TC_METRIC_AGGREGATED_TIMER("world_update_time", TC_METRIC_TAG("type", "Remove old corpses"));
         m_timers[WUPDATE_CORPSES].Reset();
         sMapMgr->DoForAllMaps([](Map* map)
         {
@@ -2529,7 +2554,7 @@ void World::Update(uint32 diff)
     ///- Process Game events when necessary
     if (m_timers[WUPDATE_EVENTS].Passed())
     {
-        TC_METRIC_TIMER("world_update_time", TC_METRIC_TAG("type", "Update game events"));
+        TC_METRIC_AGGREGATED_TIMER("world_update_time", TC_METRIC_TAG("type", "Update game events"));
         m_timers[WUPDATE_EVENTS].Reset();                   // to give time for Update() to be processed
         uint32 nextGameEvent = sGameEventMgr->Update();
         m_timers[WUPDATE_EVENTS].SetInterval(nextGameEvent);
@@ -2539,7 +2564,7 @@ void World::Update(uint32 diff)
     ///- Ping to keep MySQL connections alive
     if (m_timers[WUPDATE_PINGDB].Passed())
     {
-        TC_METRIC_TIMER("world_update_time", TC_METRIC_TAG("type", "Ping MySQL"));
+        TC_METRIC_AGGREGATED_TIMER("world_update_time", TC_METRIC_TAG("type", "Ping MySQL"));
         m_timers[WUPDATE_PINGDB].Reset();
         TC_LOG_DEBUG("misc", "Ping MySQL to keep connection alive");
         CharacterDatabase.KeepAlive();
@@ -2548,7 +2573,7 @@ void World::Update(uint32 diff)
     }
 
     {
-        TC_METRIC_TIMER("world_update_time", TC_METRIC_TAG("type", "Update instance reset times"));
+        TC_METRIC_AGGREGATED_TIMER("world_update_time", TC_METRIC_TAG("type", "Update instance reset times"));
         // update the instance reset times
         sInstanceSaveMgr->Update();
     }
@@ -2564,21 +2589,22 @@ void World::Update(uint32 diff)
     }
 
     {
-        TC_METRIC_TIMER("world_update_time", TC_METRIC_TAG("type", "Process cli commands"));
+        TC_METRIC_AGGREGATED_TIMER("world_update_time", TC_METRIC_TAG("type", "Process cli commands"));
         // And last, but not least handle the issued cli commands
         ProcessCliCommands();
     }
 
     {
-        TC_METRIC_TIMER("world_update_time", TC_METRIC_TAG("type", "Update world scripts"));
+        TC_METRIC_AGGREGATED_TIMER("world_update_time", TC_METRIC_TAG("type", "Update world scripts"));
         sScriptMgr->OnWorldUpdate(diff);
     }
 
     {
-        TC_METRIC_TIMER("world_update_time", TC_METRIC_TAG("type", "Update metrics"));
+        TC_METRIC_AGGREGATED_TIMER("world_update_time", TC_METRIC_TAG("type", "Update metrics"));
         // Stats logger update
         sMetric->Update();
         TC_METRIC_VALUE("update_time_diff", diff);
+        SpellObjectPool::UpdateMetrics();
     }
 }
 
@@ -3100,6 +3126,15 @@ void World::UpdateSessions(uint32 diff)
             AddSession_(sess);
     }
 
+    if (m_sessionUpdater->IsActive())
+    {
+        TC_METRIC_DETAILED_NO_THRESHOLD_TIMER("world_update_time",
+            TC_METRIC_TAG("type", "Process concurrent packets"),
+            TC_METRIC_TAG("parent_type", "Update sessions"));
+        ///- Process packets that do not need the world thread in parallel first
+        m_sessionUpdater->ProcessConcurrentPackets(m_sessions);
+    }
+
     ///- Then send an update signal to remaining ones
     for (SessionMap::iterator itr = m_sessions.begin(), next; itr != m_sessions.end(); itr = next)
     {
@@ -38,6 +38,7 @@
 class Player;
 class WorldPacket;
 class WorldSession;
+class WorldSessionUpdater;
 class WorldSocket;
 struct Realm;
 
@@ -178,6 +179,8 @@ enum WorldBoolConfigs
     CONFIG_RESPAWN_DYNAMIC_ESCORTNPC,
     CONFIG_REGEN_HP_CANNOT_REACH_TARGET_IN_RAID,
     CONFIG_ALLOW_LOGGING_IP_ADDRESSES_IN_DATABASE,
+    CONFIG_PROC_AURA_INDEX_VERIFY,
+    CONFIG_SPELL_LOAD_VERIFY,
     BOOL_CONFIG_VALUE_COUNT
 };
 
@@ -330,6 +333,8 @@ enum WorldIntConfigs
     CONFIG_ENABLE_SINFO_LOGIN,
     CONFIG_PLAYER_ALLOW_COMMANDS,
     CONFIG_NUMTHREADS,
+    CONFIG_SESSION_UPDATE_THREADS,
+    CONFIG_MAP_UPDATE_SPIKE_THRESHOLD,
     CONFIG_LOGDB_CLEARINTERVAL,
     CONFIG_LOGDB_CLEARTIME,
     CONFIG_CLIENTCACHE_VERSION,
@@ -399,6 +404,9 @@ enum WorldIntConfigs
     CONFIG_RESPAWN_GUIDWARNING_FREQUENCY,
     CONFIG_SOCKET_TIMEOUTTIME_ACTIVE,
     CONFIG_PENDING_MOVE_CHANGES_TIMEOUT,
+    CONFIG_MAP_QUERY_CACHE_SIZE,
+    CONFIG_SPELL_LOAD_THREADS,
+    CONFIG_PERIODIC_AURA_LOG_BATCH_INTERVAL,
     INT_CONFIG_VALUE_COUNT
 };
 
@@ -807,6 +815,7 @@ class TC_GAME_API World
         time_t mail_timer_expires;
 
         SessionMap m_sessions;
+        std::unique_ptr<WorldSessionUpdater> m_sessionUpdater;
         typedef std::unordered_map<uint32, time_t> DisconnectMap;
         DisconnectMap m_disconnects;
         uint32 m_maxActiveSessionCount;
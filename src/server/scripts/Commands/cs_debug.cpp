@@ -39,13 +39,17 @@ EndScriptData */
 #include "MapManager.h"
 #include "ObjectAccessor.h"
 #include "ObjectMgr.h"
+#include "OpcodeProfiler.h"
+#include "Opcodes.h"
 #include "PoolMgr.h"
 #include "QuestPools.h"
 #include "RBAC.h"
+#include "SmartAI.h"
 #include "SpellMgr.h"
 #include "Transport.h"
 #include "Warden.h"
 #include "World.h"
+#include "WorldSession.h"
 #include <fstream>
 #include <limits>
 #include <map>
@@ -119,6 +123,9 @@ public:
             { "asan outofbounds",   HandleDebugOutOfBounds,                rbac::RBAC_PERM_COMMAND_DEBUG,   Console::Yes },
             { "guidlimits",         HandleDebugGuidLimitsCommand,          rbac::RBAC_PERM_COMMAND_DEBUG,   Console::Yes },
             { "objectcount",        HandleDebugObjectCountCommand,         rbac::RBAC_PERM_COMMAND_DEBUG,   Console::Yes },
+            { "opcodestats",        HandleDebugOpcodeStatsCommand,         rbac::RBAC_PERM_COMMAND_DEBUG,   Console::Yes },
+            { "mapupdate",          HandleDebugMapUpdateCommand,           rbac::RBAC_PERM_COMMAND_DEBUG,   Console::No },
+            { "smartai",            HandleDebugSmartAICommand,             rbac::RBAC_PERM_COMMAND_DEBUG,   Console::No },
             { "questreset",         HandleDebugQuestResetCommand,          rbac::RBAC_PERM_COMMAND_DEBUG,   Console::Yes },
             { "warden force",       HandleDebugWardenForce,                rbac::RBAC_PERM_COMMAND_DEBUG,   Console::Yes }
         };
@@ -1823,6 +1830,111 @@ public:
             handler->PSendSysMessage("Entry: %u Count: %u", p.first, p.second);
     }
 
+    static bool HandleDebugOpcodeStatsCommand(ChatHandler* handler, Optional<EXACT_SEQUENCE("reset")> reset, Optional<uint32> limit)
+    {
+        using namespace std::chrono;
+
+        if (reset)
+        {
+            sOpcodeProfiler->Reset();
+            handler->SendSysMessage("Opcode statistics reset.");
+            return true;
+        }
+
+        uint32 count = limit.value_or(10);
+
+        std::vector<OpcodeProfiler::OpcodeStats> stats = sOpcodeProfiler->GetStats();
+        std::vector<uint32> opcodes;
+        for (uint32 opcode = 0; opcode < stats.size(); ++opcode)
+            if (stats[opcode].Count)
+                opcodes.push_back(opcode);
+
+        std::sort(opcodes.begin(), opcodes.end(), [&stats](uint32 left, uint32 right) { return stats[left].TotalTime > stats[right].TotalTime; });
+        opcodes.resize(std::min<std::size_t>(opcodes.size(), count));
+
+        handler->PSendSysMessage("Top %u opcodes by handler time:", uint32(opcodes.size()));
+        for (uint32 opcode : opcodes)
+        {
+            OpcodeProfiler::OpcodeStats const& opcodeStats = stats[opcode];
+            handler->PSendSysMessage("%s: " UI64FMTD " packets, " UI64FMTD " bytes, total " UI64FMTD " ms, avg " UI64FMTD " us, p50 < " UI64FMTD " us, p99 < " UI64FMTD " us, max " UI64FMTD " us, avg queue wait " UI64FMTD " us",
+                opcodeTable[static_cast<OpcodeClient>(opcode)]->Name, opcodeStats.Count, opcodeStats.Bytes,
+                uint64(duration_cast<milliseconds>(opcodeStats.TotalTime).count()),
+                uint64(duration_cast<microseconds>(opcodeStats.TotalTime / opcodeStats.Count).count()),
+                uint64(opcodeStats.GetTimePercentile(50.0f).count()),
+                uint64(opcodeStats.GetTimePercentile(99.0f).count()),
+                uint64(duration_cast<microseconds>(opcodeStats.MaxTime).count()),
+                uint64(duration_cast<microseconds>(opcodeStats.TotalQueueWait / opcodeStats.Count).count()));
+        }
+
+        std::vector<WorldSession const*> sessions;
+        for (auto const& [accountId, session] : sWorld->GetAllSessions())
+            if (session->GetPacketStats().Count)
+                sessions.push_back(session);
+
+        std::sort(sessions.begin(), sessions.end(), [](WorldSession const* left, WorldSession const* right)
+        {
+            return left->GetPacketStats().HandlerTime > right->GetPacketStats().HandlerTime;
+        });
+        sessions.resize(std::min<std::size_t>(sessions.size(), count));
+
+        handler->PSendSysMessage("Top %u sessions by handler time since login:", uint32(sessions.size()));
+        for (WorldSession const* session : sessions)
+        {
+            WorldSession::PacketStats const& packetStats = session->GetPacketStats();
+            handler->PSendSysMessage("%s: " UI64FMTD " packets, " UI64FMTD " bytes, total " UI64FMTD " ms",
+                session->GetPlayerInfo().c_str(), packetStats.Count, packetStats.Bytes,
+                uint64(duration_cast<milliseconds>(packetStats.HandlerTime).count()));
+        }
+
+        return true;
+    }
+
+    static bool HandleDebugMapUpdateCommand(ChatHandler* handler)
+    {
+        Map const* map = handler->GetPlayer()->GetMap();
+        MapUpdateProfiler const& profiler = map->GetUpdateProfiler();
+
+        handler->PSendSysMessage("Map %u instance %u, update phase times of the last %u ticks (p50 / p99 / max):", map->GetId(), map->GetInstanceId(), profiler.GetSampleCount());
+        for (uint8 i = 0; i <= MAX_MAP_UPDATE_PHASES; ++i)
+        {
+            MapUpdatePhase phase = MapUpdatePhase(i);
+            handler->PSendSysMessage("%s: " UI64FMTD " / " UI64FMTD " / " UI64FMTD " us", MapUpdateProfiler::GetPhaseName(phase),
+                uint64(profiler.GetPercentile(phase, 50.0f).count()),
+                uint64(profiler.GetPercentile(phase, 99.0f).count()),
+                uint64(profiler.GetPercentile(phase, 100.0f).count()));
+        }
+
+        MapUpdateProfiler::TickTimes const& spike = profiler.GetLastSpike();
+        if (spike.TotalTime)
+            handler->PSendSysMessage("Last spike: %u ms (%s)", spike.TotalTime / 1000, MapUpdateProfiler::FormatPhaseBreakdown(spike).c_str());
+
+        return true;
+    }
+
+    static bool HandleDebugSmartAICommand(ChatHandler* handler, Optional<uint32> iterations)
+    {
+        using namespace std::chrono;
+
+        Creature* target = handler->getSelectedCreature();
+        SmartAI* ai = target ? dynamic_cast<SmartAI*>(target->AI()) : nullptr;
+        if (!ai)
+        {
+            handler->SendSysMessage(LANG_SELECT_CREATURE);
+            handler->SetSentErrorMessage(true);
+            return false;
+        }
+
+        uint32 count = std::max<uint32>(iterations.value_or(1), 1);
+        SmartActionBenchmark benchmark = ai->GetScript()->BenchmarkActions(sSmartScriptMgr->GetAllScripts(), handler->GetPlayer(), count);
+
+        handler->PSendSysMessage("%u smart_scripts actions (%u compiled) run %u times with %s as owner:", benchmark.Actions, benchmark.CompiledActions, count, target->GetName().c_str());
+        handler->PSendSysMessage("Target selection: interpreted " UI64FMTD " us, compiled " UI64FMTD " us",
+            uint64(duration_cast<microseconds>(benchmark.InterpretedTargetTime).count()), uint64(duration_cast<microseconds>(benchmark.CompiledTargetTime).count()));
+        handler->PSendSysMessage("Dispatch of compiled actions: interpreted " UI64FMTD " us, compiled " UI64FMTD " us",
+            uint64(duration_cast<microseconds>(benchmark.InterpretedDispatchTime).count()), uint64(duration_cast<microseconds>(benchmark.CompiledDispatchTime).count()));
+        return true;
+    }
+
     static bool HandleDebugDummyCommand(ChatHandler* handler)
     {
         handler->SendSysMessage("This command does nothing right now. Edit your local core (cs_debug.cpp) to make it do whatever you need for testing.");
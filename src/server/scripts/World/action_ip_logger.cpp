@@ -170,7 +170,7 @@ class AccountActionIpLogger : public AccountScript
 class CharacterActionIpLogger : public PlayerScript
 {
     public:
-        CharacterActionIpLogger() : PlayerScript("CharacterActionIpLogger") { }
+        CharacterActionIpLogger() : PlayerScript("CharacterActionIpLogger", ScriptHooksOf<CharacterActionIpLogger>()) { }
 
         // CHARACTER_CREATE = 7
         void OnCreate(Player* player) override
@@ -256,7 +256,7 @@ class CharacterActionIpLogger : public PlayerScript
 class CharacterDeleteActionIpLogger : public PlayerScript
 {
 public:
-    CharacterDeleteActionIpLogger() : PlayerScript("CharacterDeleteActionIpLogger") { }
+    CharacterDeleteActionIpLogger() : PlayerScript("CharacterDeleteActionIpLogger", ScriptHooksOf<CharacterDeleteActionIpLogger>()) { }
 
     // CHARACTER_DELETE = 10
     void OnDelete(ObjectGuid guid, uint32 accountId) override
@@ -36,7 +36,7 @@ namespace
 class xp_boost_PlayerScript : public PlayerScript
 {
 public:
-    xp_boost_PlayerScript() : PlayerScript("xp_boost_PlayerScript") { }
+    xp_boost_PlayerScript() : PlayerScript("xp_boost_PlayerScript", ScriptHooksOf<xp_boost_PlayerScript>()) { }
 
     void OnGiveXP(Player* /*player*/, uint32& amount, Unit* /*unit*/) override
     {
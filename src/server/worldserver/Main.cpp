@@ -37,6 +37,7 @@
 #include "Metric.h"
 #include "MySQLThreading.h"
 #include "ObjectAccessor.h"
+#include "OpcodeProfiler.h"
 #include "OpenSSLCrypto.h"
 #include "OutdoorPvP/OutdoorPvPMgr.h"
 #include "ProcessPriority.h"
@@ -279,6 +280,7 @@ extern int main(int argc, char** argv)
         TC_METRIC_VALUE("db_queue_login", uint64(LoginDatabase.QueueSize()));
         TC_METRIC_VALUE("db_queue_character", uint64(CharacterDatabase.QueueSize()));
         TC_METRIC_VALUE("db_queue_world", uint64(WorldDatabase.QueueSize()));
+        sOpcodeProfiler->UpdateMetrics();
     });
 
     TC_METRIC_EVENT("events", "Worldserver started", "");
@@ -0,0 +1,129 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tc_catch2.h"
+
+#include "BoundingIntervalHierarchy.h"
+#include <random>
+#include <string>
+
+namespace
+{
+    struct TestBox
+    {
+        G3D::AABox Bounds;
+    };
+
+    struct TestBoxBounds
+    {
+        void operator()(TestBox const& box, G3D::AABox& bounds) const { bounds = box.Bounds; }
+    };
+
+    // same contract as MapRayCallback, shortens the ray on a hit
+    struct FirstHitCallback
+    {
+        std::vector<TestBox> const& Boxes;
+
+        bool operator()(G3D::Ray const& ray, uint32 entry, float& maxDist, bool /*stopAtFirstHit*/)
+        {
+            float time = ray.intersectionTime(Boxes[entry].Bounds);
+            if (time < maxDist)
+            {
+                maxDist = time;
+                return true;
+            }
+            return false;
+        }
+    };
+
+    std::vector<TestBox> CreateBoxes(std::mt19937& rng, uint32 count)
+    {
+        std::uniform_real_distribution<float> position(0.0f, 1000.0f);
+        std::uniform_real_distribution<float> size(0.5f, 20.0f);
+
+        std::vector<TestBox> boxes(count);
+        for (TestBox& box : boxes)
+        {
+            G3D::Vector3 low(position(rng), position(rng), position(rng) * 0.1f);
+            box.Bounds = G3D::AABox(low, low + G3D::Vector3(size(rng), size(rng), size(rng)));
+        }
+        return boxes;
+    }
+
+    G3D::Vector3 CreatePoint(std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> position(0.0f, 1000.0f);
+        return G3D::Vector3(position(rng), position(rng), position(rng) * 0.1f);
+    }
+
+    // compares every packet with rays traced one by one
+    void CheckPackets(BIH const& tree, std::vector<TestBox> const& boxes, std::mt19937& rng, bool sharedOrigin)
+    {
+        std::uniform_real_distribution<float> jitter(-5.0f, 5.0f);
+        for (uint32 packet = 0; packet < 200; ++packet)
+        {
+            uint32 count = 1 + packet % BIH_RAY_PACKET_SIZE;
+            G3D::Vector3 center = CreatePoint(rng);
+
+            G3D::Ray rays[BIH_RAY_PACKET_SIZE];
+            float maxDist[BIH_RAY_PACKET_SIZE];
+            bool expected[BIH_RAY_PACKET_SIZE];
+            for (uint32 i = 0; i < count; ++i)
+            {
+                // area target selection traces from every target to the spell center
+                G3D::Vector3 start = sharedOrigin ? center : center + G3D::Vector3(jitter(rng), jitter(rng), 0.0f);
+                G3D::Vector3 end = CreatePoint(rng);
+                // axis aligned rays hit the special cases of the node tests
+                if (packet % 7 == 0)
+                    end.z = start.z;
+
+                maxDist[i] = (end - start).magnitude();
+                rays[i] = G3D::Ray::fromOriginAndDirection(start, (end - start) / maxDist[i]);
+
+                FirstHitCallback callback{ boxes };
+                float dist = maxDist[i];
+                tree.intersectRay(rays[i], callback, dist, true);
+                expected[i] = dist < maxDist[i];
+            }
+
+            FirstHitCallback callback{ boxes };
+            bool hits[BIH_RAY_PACKET_SIZE];
+            tree.intersectRayPacket(rays, count, maxDist, callback, hits);
+            for (uint32 i = 0; i < count; ++i)
+                REQUIRE(hits[i] == expected[i]);
+        }
+    }
+}
+
+TEST_CASE("BIH: Ray packets give the same results as single rays", "[BIH]")
+{
+    std::mt19937 rng(27);
+
+    for (uint32 boxCount : { 1u, 50u, 500u, 2000u })
+    {
+        std::vector<TestBox> boxes = CreateBoxes(rng, boxCount);
+        BIH tree;
+        TestBoxBounds getBounds;
+        tree.build(boxes, getBounds);
+
+        SECTION("Rays from one source, boxes: " + std::to_string(boxCount))
+            CheckPackets(tree, boxes, rng, true);
+
+        SECTION("Rays from different sources, boxes: " + std::to_string(boxCount))
+            CheckPackets(tree, boxes, rng, false);
+    }
+}
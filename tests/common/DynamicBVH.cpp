@@ -0,0 +1,319 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tc_catch2.h"
+
+#include "BoundingIntervalHierarchyWrapper.h"
+#include "DynamicBoundingVolumeHierarchy.h"
+#include <random>
+#include <set>
+
+namespace
+{
+    struct TestModel
+    {
+        G3D::AABox Bounds;
+
+        void MoveBy(G3D::Vector3 const& offset) { Bounds = G3D::AABox(Bounds.low() + offset, Bounds.high() + offset); }
+    };
+
+    // collects every model whose exact bounds are hit, never stops the traversal
+    struct CollectCallback
+    {
+        std::set<TestModel const*> Hits;
+
+        bool operator()(G3D::Ray const& ray, TestModel const& model, float& maxDist)
+        {
+            float time = ray.intersectionTime(model.Bounds);
+            if (time <= maxDist)
+                Hits.insert(&model);
+            return false;
+        }
+
+        void operator()(G3D::Vector3 const& point, TestModel const& model)
+        {
+            if (model.Bounds.contains(point))
+                Hits.insert(&model);
+        }
+    };
+
+    struct AnyHitCallback
+    {
+        bool Hit = false;
+
+        bool operator()(G3D::Ray const& ray, TestModel const& model, float& maxDist)
+        {
+            Hit = ray.intersectionTime(model.Bounds) <= maxDist;
+            return Hit;
+        }
+    };
+
+    // same contract as DynamicTreeIntersectionCallback, shortens the ray on every hit
+    struct NearestHitCallback
+    {
+        bool Hit = false;
+
+        bool operator()(G3D::Ray const& ray, TestModel const& model, float& maxDist)
+        {
+            float time = ray.intersectionTime(model.Bounds);
+            if (time > maxDist)
+                return false;
+
+            maxDist = time;
+            Hit = true;
+            return true;
+        }
+    };
+
+    std::vector<TestModel> CreateModels(std::mt19937& rng, uint32 count)
+    {
+        std::uniform_real_distribution<float> position(0.0f, 500.0f);
+        std::uniform_real_distribution<float> size(1.0f, 15.0f);
+
+        std::vector<TestModel> models(count);
+        for (TestModel& model : models)
+        {
+            G3D::Vector3 low(position(rng), position(rng), position(rng) * 0.1f);
+            model.Bounds = G3D::AABox(low, low + G3D::Vector3(size(rng), size(rng), size(rng)));
+        }
+        return models;
+    }
+
+    G3D::Ray CreateRay(std::mt19937& rng, float& length)
+    {
+        std::uniform_real_distribution<float> position(0.0f, 500.0f);
+        G3D::Vector3 start(position(rng), position(rng), position(rng) * 0.1f);
+        G3D::Vector3 end(position(rng), position(rng), position(rng) * 0.1f);
+        length = (end - start).magnitude();
+        return G3D::Ray::fromOriginAndDirection(start, (end - start) / length);
+    }
+
+    std::set<TestModel const*> BruteForce(std::vector<TestModel> const& models, G3D::Ray const& ray, float maxDist)
+    {
+        std::set<TestModel const*> hits;
+        for (TestModel const& model : models)
+            if (ray.intersectionTime(model.Bounds) <= maxDist)
+                hits.insert(&model);
+        return hits;
+    }
+
+    std::vector<TestModel const*> MoveModels(std::mt19937& rng, std::vector<TestModel>& models, uint32 count)
+    {
+        std::uniform_int_distribution<std::size_t> index(0, models.size() - 1);
+        std::uniform_real_distribution<float> offset(-5.0f, 5.0f);
+        std::vector<TestModel const*> moved;
+        for (uint32 i = 0; i < count; ++i)
+        {
+            TestModel& model = models[index(rng)];
+            model.MoveBy(G3D::Vector3(offset(rng), offset(rng), 0.0f));
+            moved.push_back(&model);
+        }
+        return moved;
+    }
+}
+
+template<> struct BoundsTrait<TestModel>
+{
+    static void getBounds(TestModel const& model, G3D::AABox& out) { out = model.Bounds; }
+    static void getBounds2(TestModel const* model, G3D::AABox& out) { out = model->Bounds; }
+};
+
+TEST_CASE("DynamicBVH: queries match brute force", "[DynamicBVH]")
+{
+    std::mt19937 rng(1234);
+    std::vector<TestModel> models = CreateModels(rng, 500);
+
+    DynamicBVH<TestModel> tree;
+    for (TestModel const& model : models)
+        tree.insert(model);
+
+    REQUIRE(tree.size() == 500);
+    // AVL balanced tree, height is bounded by ~1.44 * log2(n)
+    REQUIRE(tree.getHeight() <= 13);
+
+    auto checkQueries = [&]()
+    {
+        for (uint32 i = 0; i < 200; ++i)
+        {
+            float length;
+            G3D::Ray ray = CreateRay(rng, length);
+
+            CollectCallback callback;
+            float maxDist = length;
+            tree.intersectRay(ray, callback, maxDist);
+            std::set<TestModel const*> expectedHits = BruteForce(models, ray, length);
+            REQUIRE(callback.Hits == expectedHits);
+
+            NearestHitCallback nearestCallback;
+            float nearestDist = length;
+            tree.intersectRay(ray, nearestCallback, nearestDist);
+            float expectedDist = length;
+            for (TestModel const* model : expectedHits)
+                expectedDist = std::min(expectedDist, ray.intersectionTime(model->Bounds));
+            REQUIRE(nearestCallback.Hit == !expectedHits.empty());
+            REQUIRE(nearestDist == expectedDist);
+
+            CollectCallback pointCallback;
+            tree.intersectPoint(ray.origin(), pointCallback);
+            std::set<TestModel const*> expected;
+            for (TestModel const& model : models)
+                if (model.Bounds.contains(ray.origin()))
+                    expected.insert(&model);
+            REQUIRE(pointCallback.Hits == expected);
+        }
+    };
+
+    checkQueries();
+
+    SECTION("after moving models without maintenance")
+    {
+        MoveModels(rng, models, 300);
+        for (TestModel const& model : models)
+            tree.update(model);
+
+        REQUIRE(tree.getPendingReinsertCount() > 0);
+        checkQueries();
+    }
+
+    SECTION("after moving models with bounded maintenance")
+    {
+        for (uint32 tick = 0; tick < 20; ++tick)
+        {
+            MoveModels(rng, models, 50);
+            for (TestModel const& model : models)
+                tree.update(model);
+            tree.balance();
+        }
+
+        checkQueries();
+
+        while (tree.getPendingReinsertCount())
+            tree.balance();
+
+        REQUIRE(tree.getHeight() <= 13);
+        checkQueries();
+    }
+
+    SECTION("after removing models")
+    {
+        for (std::size_t i = 0; i < models.size(); i += 2)
+            tree.remove(models[i]);
+
+        REQUIRE(tree.size() == 250);
+        REQUIRE_FALSE(tree.contains(models[0]));
+        REQUIRE(tree.contains(models[1]));
+
+        for (uint32 i = 0; i < 100; ++i)
+        {
+            float length;
+            G3D::Ray ray = CreateRay(rng, length);
+
+            CollectCallback callback;
+            float maxDist = length;
+            tree.intersectRay(ray, callback, maxDist);
+            for (TestModel const* hit : callback.Hits)
+                REQUIRE((hit - models.data()) % 2 == 1);
+        }
+
+        for (std::size_t i = 1; i < models.size(); i += 2)
+            tree.remove(models[i]);
+
+        REQUIRE(tree.empty());
+    }
+}
+
+TEST_CASE("DynamicBVH: moving models compared to BIHWrap", "[!benchmark][DynamicBVH]")
+{
+    uint32 const modelCount = 2000;
+    uint32 const movedPerTick = 200;
+    uint32 const raysPerTick = 500;
+
+    std::mt19937 rng(4321);
+    std::vector<TestModel> models = CreateModels(rng, modelCount);
+    std::vector<std::pair<G3D::Ray, float>> rays;
+    for (uint32 i = 0; i < raysPerTick; ++i)
+    {
+        float length;
+        G3D::Ray ray = CreateRay(rng, length);
+        rays.emplace_back(ray, length);
+    }
+
+    // line of sight checks, BIHWrap always stops at the first hit
+    auto queryAll = [&](auto& tree, auto&&... stopAtFirst)
+    {
+        uint32 hits = 0;
+        for (std::pair<G3D::Ray, float> const& ray : rays)
+        {
+            AnyHitCallback callback;
+            float maxDist = ray.second;
+            tree.intersectRay(ray.first, callback, maxDist, stopAtFirst...);
+            hits += callback.Hit ? 1 : 0;
+        }
+        return hits;
+    };
+
+    BIHWrap<TestModel> bih;
+    DynamicBVH<TestModel> bvh;
+    for (TestModel const& model : models)
+    {
+        bih.insert(model);
+        bvh.insert(model);
+    }
+    bih.balance();
+
+    BENCHMARK("BIHWrap: query")
+    {
+        return queryAll(bih);
+    };
+
+    BENCHMARK("DynamicBVH: query")
+    {
+        return queryAll(bvh, true);
+    };
+
+    // hit position queries, these need the nearest hit
+    BENCHMARK("DynamicBVH: nearest hit query")
+    {
+        float distance = 0.0f;
+        for (std::pair<G3D::Ray, float> const& ray : rays)
+        {
+            NearestHitCallback callback;
+            float maxDist = ray.second;
+            bvh.intersectRay(ray.first, callback, maxDist);
+            distance += maxDist;
+        }
+        return distance;
+    };
+
+    BENCHMARK("BIHWrap: move, rebuild and query")
+    {
+        for (TestModel const* model : MoveModels(rng, models, movedPerTick))
+        {
+            bih.remove(*model);
+            bih.insert(*model);
+        }
+        return queryAll(bih);
+    };
+
+    BENCHMARK("DynamicBVH: move, refit and query")
+    {
+        for (TestModel const* model : MoveModels(rng, models, movedPerTick))
+            bvh.update(*model);
+        bvh.balance();
+        return queryAll(bvh, true);
+    };
+}
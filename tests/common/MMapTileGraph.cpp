@@ -0,0 +1,206 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tc_catch2.h"
+
+#include "MMapTileGraph.h"
+#include "DetourNavMesh.h"
+#include <cstring>
+#include <vector>
+
+using namespace MMAP;
+
+namespace
+{
+    float const TileSize = 10.0f;
+
+    // flat tile made of axis aligned quads, coordinates are relative to the tile origin
+    class TestTile
+    {
+    public:
+        TestTile(int32 tileX, int32 tileY) : _tileX(tileX), _tileY(tileY)
+        {
+            memset(&_header, 0, sizeof(_header));
+            memset(_tileData, 0, sizeof(_tileData));
+            _header.x = tileX;
+            _header.y = tileY;
+        }
+
+        // linkedSides is a mask of the tile sides (0 = +x, 2 = +z, 4 = -x, 6 = -z) the quad has external links on
+        void AddQuad(float minX, float minZ, float maxX, float maxZ, uint8 linkedSides)
+        {
+            float const originX = _tileX * TileSize;
+            float const originZ = _tileY * TileSize;
+            float const corners[4][2] = { { minX, minZ }, { minX, maxZ }, { maxX, maxZ }, { maxX, minZ } };
+            // side of the edge starting at every corner
+            uint8 const edgeSides[4] = { 4, 2, 0, 6 };
+
+            dtPoly poly;
+            memset(&poly, 0, sizeof(poly));
+            poly.vertCount = 4;
+            poly.setType(DT_POLYTYPE_GROUND);
+            for (uint8 i = 0; i < 4; ++i)
+            {
+                poly.verts[i] = uint16(_verts.size() / 3);
+                _verts.insert(_verts.end(), { originX + corners[i][0], 0.0f, originZ + corners[i][1] });
+                if (linkedSides & (1 << edgeSides[i]))
+                    poly.neis[i] = DT_EXT_LINK | edgeSides[i];
+            }
+
+            _polys.push_back(poly);
+        }
+
+        dtMeshTile const* Get()
+        {
+            _header.polyCount = int32(_polys.size());
+            _header.vertCount = int32(_verts.size() / 3);
+            // dtMeshTile can only be created by dtNavMesh, the graph only reads these fields
+            dtMeshTile* tile = reinterpret_cast<dtMeshTile*>(_tileData);
+            tile->header = &_header;
+            tile->polys = _polys.data();
+            tile->verts = _verts.data();
+            return tile;
+        }
+
+    private:
+        int32 _tileX;
+        int32 _tileY;
+        dtMeshHeader _header;
+        alignas(dtMeshTile) unsigned char _tileData[sizeof(dtMeshTile)];
+        std::vector<float> _verts;
+        std::vector<dtPoly> _polys;
+    };
+
+    uint8 const SidePosX = 1 << 0;
+    uint8 const SideNegX = 1 << 4;
+}
+
+TEST_CASE("MMapTileGraph: Tile ids", "[MMapTileGraph]")
+{
+    REQUIRE(MMapTileGraph::PackTileID(0, 0) == 0);
+    REQUIRE(MMapTileGraph::PackTileID(1, 2) == 0x00010002);
+    REQUIRE(MMapTileGraph::PackTileID(-1, -2) == 0xFFFFFFFE);
+    REQUIRE(MMapTileGraph::PackTileID(-1, 0) != MMapTileGraph::PackTileID(0, -1));
+}
+
+TEST_CASE("MMapTileGraph: Portals", "[MMapTileGraph]")
+{
+    MMapTileGraph graph;
+
+    SECTION("Connected border edges are one portal")
+    {
+        TestTile tile(0, 0);
+        tile.AddQuad(0.0f, 0.0f, 10.0f, 5.0f, SidePosX);
+        tile.AddQuad(0.0f, 5.0f, 10.0f, 10.0f, SidePosX);
+        graph.AddTile(tile.Get());
+
+        REQUIRE(graph.GetNodeCount() == 1);
+        REQUIRE(graph.GetPortalCount(0, 0, 0) == 1);
+        REQUIRE(graph.GetPortalCount(0, 0, 4) == 0);
+    }
+
+    SECTION("Separated border edges are separate portals")
+    {
+        TestTile tile(0, 0);
+        tile.AddQuad(0.0f, 0.0f, 10.0f, 3.0f, SidePosX);
+        tile.AddQuad(0.0f, 7.0f, 10.0f, 10.0f, SidePosX);
+        graph.AddTile(tile.Get());
+
+        REQUIRE(graph.GetPortalCount(0, 0, 0) == 2);
+    }
+
+    REQUIRE(graph.GetPortalCount(1, 0, 0) == 0);
+}
+
+TEST_CASE("MMapTileGraph: Routes", "[MMapTileGraph]")
+{
+    MMapTileGraph graph;
+    std::vector<MMapTileRouteStep> route;
+
+    SECTION("The portal closest to the line between start and end is used")
+    {
+        // both tiles have a corridor at each end of their shared border
+        TestTile left(0, 0);
+        left.AddQuad(0.0f, 0.0f, 10.0f, 3.0f, SidePosX);
+        left.AddQuad(0.0f, 7.0f, 10.0f, 10.0f, SidePosX);
+        TestTile right(1, 0);
+        right.AddQuad(0.0f, 0.0f, 10.0f, 3.0f, SideNegX);
+        right.AddQuad(0.0f, 7.0f, 10.0f, 10.0f, SideNegX);
+        graph.AddTile(left.Get());
+        graph.AddTile(right.Get());
+
+        float const start[3] = { 2.0f, 0.0f, 1.0f };
+        float const nearEnd[3] = { 18.0f, 0.0f, 1.0f };
+        REQUIRE(graph.FindRoute(0, 0, start, 1, 0, nearEnd, route));
+        REQUIRE(route.size() == 2);
+        REQUIRE(route[1].tileX == 1);
+        REQUIRE(route[1].tileY == 0);
+
+        // the portal is on the polygon, just inside the border
+        REQUIRE(route[1].portal[0] < 10.0f);
+        REQUIRE(route[1].portal[0] > 9.5f);
+        REQUIRE(route[1].portal[2] > 0.0f);
+        REQUIRE(route[1].portal[2] < 3.0f);
+
+        float const farEnd[3] = { 18.0f, 0.0f, 9.0f };
+        float const farStart[3] = { 2.0f, 0.0f, 9.0f };
+        REQUIRE(graph.FindRoute(0, 0, farStart, 1, 0, farEnd, route));
+        REQUIRE(route[1].portal[2] > 7.0f);
+        REQUIRE(route[1].portal[2] < 10.0f);
+    }
+
+    SECTION("Routes cross several tiles and need every tile to be loaded")
+    {
+        // a row of tiles from -1 to 1, connected on their x borders
+        TestTile west(-1, -1);
+        west.AddQuad(0.0f, 0.0f, 10.0f, 10.0f, SidePosX);
+        TestTile middle(0, -1);
+        middle.AddQuad(0.0f, 0.0f, 10.0f, 10.0f, SidePosX | SideNegX);
+        TestTile east(1, -1);
+        east.AddQuad(0.0f, 0.0f, 10.0f, 10.0f, SideNegX);
+        graph.AddTile(west.Get());
+        graph.AddTile(middle.Get());
+        graph.AddTile(east.Get());
+
+        float const start[3] = { -5.0f, 0.0f, -5.0f };
+        float const end[3] = { 15.0f, 0.0f, -5.0f };
+        REQUIRE(graph.FindRoute(-1, -1, start, 1, -1, end, route));
+        REQUIRE(route.size() == 3);
+        REQUIRE(route[0].tileX == -1);
+        REQUIRE(route[1].tileX == 0);
+        REQUIRE(route[2].tileX == 1);
+        REQUIRE(route[2].tileY == -1);
+
+        graph.RemoveTile(0, -1);
+        REQUIRE_FALSE(graph.FindRoute(-1, -1, start, 1, -1, end, route));
+        REQUIRE(route.empty());
+    }
+
+    SECTION("Tiles without portals towards each other are not connected")
+    {
+        TestTile left(0, 0);
+        left.AddQuad(0.0f, 0.0f, 10.0f, 10.0f, SidePosX);
+        TestTile right(1, 0);
+        right.AddQuad(0.0f, 0.0f, 10.0f, 10.0f, 0);
+        graph.AddTile(left.Get());
+        graph.AddTile(right.Get());
+
+        float const start[3] = { 5.0f, 0.0f, 5.0f };
+        float const end[3] = { 15.0f, 0.0f, 5.0f };
+        REQUIRE_FALSE(graph.FindRoute(0, 0, start, 1, 0, end, route));
+    }
+}
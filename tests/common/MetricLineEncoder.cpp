@@ -0,0 +1,143 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tc_catch2.h"
+
+#include "Metric.h"
+#include "MetricLineEncoder.h"
+#include <sstream>
+
+namespace
+{
+    SystemTimePoint const Timestamp = SystemTimePoint(std::chrono::nanoseconds(1664755200000000000));
+}
+
+TEST_CASE("MetricLineEncoder: Encodes values and events", "[MetricLineEncoder]")
+{
+    std::string buffer;
+    MetricLineEncoder encoder(buffer);
+
+    encoder.BeginLine("world_update_time");
+    encoder.AddTag("realm", "Trinity");
+    encoder.AddTag("type", "Update maps");
+    encoder.AddField("value", uint64(12));
+    encoder.AddField("count", int64(-3));
+    encoder.EndLine(Timestamp);
+
+    encoder.BeginLine("events");
+    encoder.AddStringField("title", "Worldserver started");
+    encoder.AddStringField("text", "say \"hello\" \\o/");
+    encoder.AddField("ratio", 0.5);
+    encoder.AddField("enabled", true);
+    encoder.EndLine(Timestamp);
+
+    REQUIRE(buffer ==
+        "world_update_time,realm=Trinity,type=Update\\ maps value=12i,count=-3i 1664755200000000000\n"
+        "events title=\"Worldserver started\",text=\"say \\\"hello\\\" \\\\o/\",ratio=0.500000,enabled=t 1664755200000000000");
+}
+
+TEST_CASE("MetricLineEncoder: Escapes measurements, tags and field keys", "[MetricLineEncoder]")
+{
+    std::string buffer;
+    MetricLineEncoder encoder(buffer);
+
+    encoder.BeginLine("map update,time");
+    encoder.AddTag("map id", "a=b,c");
+    encoder.AddEncodedField("field=key", "1i");
+    encoder.EndLine(Timestamp);
+
+    REQUIRE(buffer == "map\\ update\\,time,map\\ id=a\\=b\\,c field\\=key=1i 1664755200000000000");
+}
+
+TEST_CASE("MetricLineEncoder: Does not allocate once the buffer is large enough", "[MetricLineEncoder]")
+{
+    std::string buffer;
+    buffer.reserve(1024);
+    char const* data = buffer.data();
+
+    for (uint32 i = 0; i < 2; ++i)
+    {
+        buffer.clear();
+        MetricLineEncoder encoder(buffer);
+        for (uint32 j = 0; j < 8; ++j)
+        {
+            encoder.BeginLine("processed_packets");
+            encoder.AddTag("realm", "Trinity");
+            encoder.AddField("value", uint64(j));
+            encoder.EndLine(Timestamp);
+        }
+    }
+
+    REQUIRE(buffer.data() == data);
+}
+
+TEST_CASE("Metric: Timer percentiles", "[Metric]")
+{
+    // 90 fast and 10 slow measurements
+    std::array<uint64, Metric::TIMER_BUCKETS> buckets = { };
+    buckets[Metric::GetTimerBucket(100)] += 90;
+    buckets[Metric::GetTimerBucket(5000)] += 10;
+
+    REQUIRE(Metric::GetTimerBucket(0) == 0);
+    REQUIRE(Metric::GetTimerBucket(1) == 1);
+    REQUIRE(Metric::GetTimerBucket(100) == 7);
+    REQUIRE(Metric::GetTimerBucket(uint64(-1)) == Metric::TIMER_BUCKETS - 1);
+
+    REQUIRE(Metric::GetTimerPercentile(buckets, 100, 5000, 50.0f) == 128);
+    REQUIRE(Metric::GetTimerPercentile(buckets, 100, 5000, 99.0f) == 5000);
+}
+
+TEST_CASE("MetricLineEncoder: Batch encoding", "[MetricLineEncoder][!benchmark]")
+{
+    std::vector<MetricTagsVector> tags;
+    for (uint32 i = 0; i < 32; ++i)
+        tags.push_back({ MetricTag("type", "Update " + std::to_string(i)), MetricTag("parent_type", "Update sessions") });
+
+    // what Metric::SendBatch did before
+    BENCHMARK("std::stringstream")
+    {
+        std::stringstream batchedData;
+        for (MetricTagsVector const& lineTags : tags)
+        {
+            batchedData << "world_update_time" << ",realm=" << "Trinity";
+            for (MetricTag const& tag : lineTags)
+                batchedData << "," << tag.first << "=" << tag.second;
+
+            batchedData << " value=" << std::to_string(12) + 'i' << " "
+                << std::to_string(std::chrono::duration_cast<std::chrono::nanoseconds>(Timestamp.time_since_epoch()).count()) << "\n";
+        }
+        return batchedData.tellp();
+    };
+
+    std::string buffer;
+    BENCHMARK("MetricLineEncoder")
+    {
+        buffer.clear();
+        MetricLineEncoder encoder(buffer);
+        for (MetricTagsVector const& lineTags : tags)
+        {
+            encoder.BeginLine("world_update_time");
+            encoder.AddTag("realm", "Trinity");
+            for (MetricTag const& tag : lineTags)
+                encoder.AddTag(tag.first, tag.second);
+
+            encoder.AddField("value", uint64(12));
+            encoder.EndLine(Timestamp);
+        }
+        return buffer.size();
+    };
+}
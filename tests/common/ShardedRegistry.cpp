@@ -0,0 +1,207 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tc_catch2.h"
+
+#include "ShardedRegistry.h"
+#include <shared_mutex>
+#include <thread>
+
+namespace
+{
+    struct TestPlayer
+    {
+        uint64 Guid;
+    };
+
+    // the previous HashMapHolder storage, for comparison
+    class LockedRegistry
+    {
+    public:
+        TestPlayer* Find(uint64 guid) const
+        {
+            std::shared_lock<std::shared_mutex> lock(_lock);
+            auto itr = _map.find(guid);
+            return itr != _map.end() ? itr->second : nullptr;
+        }
+
+        void Insert(uint64 guid, TestPlayer* player)
+        {
+            std::unique_lock<std::shared_mutex> lock(_lock);
+            _map[guid] = player;
+        }
+
+        void Remove(uint64 guid)
+        {
+            std::unique_lock<std::shared_mutex> lock(_lock);
+            _map.erase(guid);
+        }
+
+    private:
+        mutable std::shared_mutex _lock;
+        std::unordered_map<uint64, TestPlayer*> _map;
+    };
+
+    // map threads look up players (group members, whisper targets, ...) while the world thread logs players in and out
+    template<class Registry>
+    uint64 SimulateMapThreads(Registry& registry, std::vector<TestPlayer>& players, uint32 mapThreads, uint32 lookupsPerThread)
+    {
+        std::atomic<bool> done(false);
+        std::atomic<uint64> found(0);
+
+        std::thread world([&]
+        {
+            uint32 i = 0;
+            while (!done.load(std::memory_order_relaxed))
+            {
+                TestPlayer& player = players[i++ % players.size()];
+                registry.Remove(player.Guid);
+                registry.Insert(player.Guid, &player);
+                std::this_thread::yield();
+            }
+        });
+
+        std::vector<std::thread> maps;
+        for (uint32 t = 0; t < mapThreads; ++t)
+        {
+            maps.emplace_back([&, t]
+            {
+                uint64 hits = 0;
+                for (uint32 i = 0; i < lookupsPerThread; ++i)
+                    if (registry.Find(players[(i * 7 + t) % players.size()].Guid))
+                        ++hits;
+                found += hits;
+            });
+        }
+
+        for (std::thread& thread : maps)
+            thread.join();
+
+        done = true;
+        world.join();
+        return found;
+    }
+}
+
+TEST_CASE("ShardedRegistry: single threaded operations", "[ShardedRegistry]")
+{
+    Trinity::ShardedRegistry<uint64, TestPlayer*> registry;
+    std::vector<TestPlayer> players(500);
+    for (uint32 i = 0; i < players.size(); ++i)
+        players[i].Guid = i + 1;
+
+    REQUIRE(registry.Find(1) == nullptr);
+
+    for (TestPlayer& player : players)
+        registry.Insert(player.Guid, &player);
+
+    for (TestPlayer& player : players)
+        REQUIRE(registry.Find(player.Guid) == &player);
+
+    for (uint32 i = 0; i < players.size(); i += 2)
+        registry.Remove(players[i].Guid);
+
+    registry.Remove(100000);
+
+    for (uint32 i = 0; i < players.size(); ++i)
+        REQUIRE(registry.Find(players[i].Guid) == (i % 2 ? &players[i] : nullptr));
+
+    registry.Insert(players[1].Guid, &players[0]);
+    REQUIRE(registry.Find(players[1].Guid) == &players[0]);
+}
+
+TEST_CASE("ShardedRegistry: lookups during concurrent logins and logouts", "[ShardedRegistry]")
+{
+    Trinity::ShardedRegistry<uint64, TestPlayer*> registry;
+    std::vector<TestPlayer> players(1000);
+    for (uint32 i = 0; i < players.size(); ++i)
+    {
+        players[i].Guid = i + 1;
+        registry.Insert(players[i].Guid, &players[i]);
+    }
+
+    std::atomic<bool> done(false);
+    std::atomic<uint32> mismatches(0);
+
+    std::thread world([&]
+    {
+        for (uint32 i = 0; i < 20000; ++i)
+        {
+            TestPlayer& player = players[i % players.size()];
+            registry.Remove(player.Guid);
+            registry.Insert(player.Guid, &player);
+        }
+        done = true;
+    });
+
+    std::vector<std::thread> maps;
+    for (uint32 t = 0; t < 4; ++t)
+    {
+        maps.emplace_back([&, t]
+        {
+            uint32 i = t;
+            while (!done.load(std::memory_order_relaxed))
+            {
+                uint64 guid = i++ % players.size() + 1;
+                if (TestPlayer* player = registry.Find(guid))
+                    if (player->Guid != guid)
+                        ++mismatches;
+            }
+        });
+    }
+
+    world.join();
+    for (std::thread& thread : maps)
+        thread.join();
+
+    REQUIRE(mismatches == 0);
+    for (TestPlayer& player : players)
+        REQUIRE(registry.Find(player.Guid) == &player);
+
+    // no reader is left inside a critical section, everything retired must be reclaimable
+    for (uint32 i = 0; i < 3 && sEpochReclaimer->Collect(); ++i)
+        ;
+    REQUIRE(sEpochReclaimer->Collect() == 0);
+}
+
+TEST_CASE("Player registry contention", "[!benchmark][ShardedRegistry]")
+{
+    uint32 const lookupsPerThread = 200000;
+    uint32 const mapThreads = std::max(2u, std::thread::hardware_concurrency());
+
+    std::vector<TestPlayer> players(3000);
+    for (uint32 i = 0; i < players.size(); ++i)
+        players[i].Guid = i + 1;
+
+    LockedRegistry locked;
+    Trinity::ShardedRegistry<uint64, TestPlayer*> sharded;
+    for (TestPlayer& player : players)
+    {
+        locked.Insert(player.Guid, &player);
+        sharded.Insert(player.Guid, &player);
+    }
+
+    BENCHMARK("std::shared_mutex: lookups during logins and logouts")
+    {
+        return SimulateMapThreads(locked, players, mapThreads, lookupsPerThread);
+    };
+
+    BENCHMARK("ShardedRegistry: lookups during logins and logouts")
+    {
+        return SimulateMapThreads(sharded, players, mapThreads, lookupsPerThread);
+    };
+}
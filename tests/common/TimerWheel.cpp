@@ -0,0 +1,415 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define CATCH_CONFIG_ENABLE_CHRONO_STRINGMAKER
+#include "tc_catch2.h"
+
+#include "EventMap.h"
+#include "EventProcessor.h"
+#include "TaskScheduler.h"
+#include "TimerWheel.h"
+#include <algorithm>
+#include <map>
+#include <random>
+
+namespace
+{
+    // std::multimap keeps equal keys in insertion order, the same order the wheel guarantees
+    struct ReferenceQueue
+    {
+        std::multimap<uint64, uint32> Timers;
+        std::map<uint32, std::multimap<uint64, uint32>::iterator> Handles;
+
+        void Schedule(uint64 expiry, uint32 value) { Handles[value] = Timers.emplace(expiry, value); }
+
+        void Remove(uint32 value)
+        {
+            Timers.erase(Handles[value]);
+            Handles.erase(value);
+        }
+
+        std::vector<uint32> PopDue(uint64 now)
+        {
+            std::vector<uint32> due;
+            while (!Timers.empty() && Timers.begin()->first <= now)
+            {
+                due.push_back(Timers.begin()->second);
+                Handles.erase(Timers.begin()->second);
+                Timers.erase(Timers.begin());
+            }
+            return due;
+        }
+    };
+
+    class CountingEvent : public BasicEvent
+    {
+    public:
+        CountingEvent(std::vector<uint32>& executed, uint32 id) : _executed(executed), _id(id) { }
+
+        bool Execute(uint64, uint32) override
+        {
+            _executed.push_back(_id);
+            return true;
+        }
+
+    private:
+        std::vector<uint32>& _executed;
+        uint32 _id;
+    };
+}
+
+TEST_CASE("TimerWheel: expiry order matches a sorted multimap", "[TimerWheel]")
+{
+    // few timers stay in the sorted list, many use the wheel, the middle one keeps switching between them
+    uint32 const maxSize = GENERATE(uint32(TimerWheel<uint32>::SMALL_QUEUE_SIZE / 2), uint32(TimerWheel<uint32>::SMALL_QUEUE_SIZE + 8), 100000u);
+    std::mt19937 rng(2024);
+    // short spell timers, boss ability timers, minute long timers and timers beyond the top level
+    std::discrete_distribution<uint32> range({ 50, 30, 15, 5 });
+    uint64 const ranges[] = { 64, 5000, 400000, 40000000 };
+
+    TimerWheel<uint32> wheel;
+    ReferenceQueue reference;
+    std::map<uint32, TimerWheel<uint32>::NodeId> nodes;
+    uint32 nextValue = 0;
+    uint64 now = 0;
+
+    for (uint32 step = 0; step < 20000; ++step)
+    {
+        switch (rng() % 4)
+        {
+            case 0:
+            case 1:
+            {
+                if (nodes.size() >= maxSize)
+                    break;
+
+                uint64 expiry = now + rng() % ranges[range(rng)];
+                nodes[nextValue] = wheel.Schedule(expiry, nextValue);
+                reference.Schedule(expiry, nextValue);
+                ++nextValue;
+                break;
+            }
+            case 2:
+            {
+                if (nodes.empty())
+                    break;
+
+                auto itr = std::next(nodes.begin(), rng() % nodes.size());
+                if (rng() % 2)
+                {
+                    uint64 expiry = now + rng() % ranges[range(rng)];
+                    wheel.Reschedule(itr->second, expiry);
+                    reference.Remove(itr->first);
+                    reference.Schedule(expiry, itr->first);
+                }
+                else
+                {
+                    REQUIRE(wheel.Remove(itr->second) == itr->first);
+                    reference.Remove(itr->first);
+                    nodes.erase(itr);
+                }
+                break;
+            }
+            default:
+            {
+                now += rng() % ranges[range(rng)];
+                wheel.Advance(now);
+
+                std::vector<uint32> due;
+                uint32 value;
+                while (wheel.PopDue(value))
+                {
+                    due.push_back(value);
+                    nodes.erase(value);
+                }
+
+                REQUIRE(due == reference.PopDue(now));
+                break;
+            }
+        }
+
+        REQUIRE(wheel.GetSize() == reference.Timers.size());
+    }
+
+    now += 50000000;
+    wheel.Advance(now);
+    std::vector<uint32> due;
+    uint32 value;
+    while (wheel.PopDue(value))
+        due.push_back(value);
+
+    REQUIRE(due == reference.PopDue(now));
+    REQUIRE(wheel.IsEmpty());
+}
+
+TEST_CASE("TimerWheel: switches between the sorted list and the wheel", "[TimerWheel]")
+{
+    TimerWheel<uint32> wheel;
+    uint32 const count = TimerWheel<uint32>::SMALL_QUEUE_SIZE + 1;
+    for (uint32 i = 0; i < count; ++i)
+        wheel.Schedule(count - i, i);
+
+    REQUIRE(wheel.IsUsingWheel());
+
+    std::vector<uint32> due;
+    uint32 value;
+    for (uint64 now = 1; now <= count; ++now)
+    {
+        wheel.Advance(now);
+        REQUIRE(wheel.IsUsingWheel() == (wheel.GetSize() > TimerWheel<uint32>::SMALL_QUEUE_SIZE / 2));
+
+        while (wheel.PopDue(value))
+            due.push_back(value);
+    }
+
+    REQUIRE(due.size() == count);
+    REQUIRE(std::is_sorted(due.rbegin(), due.rend()));
+
+    // copies keep their own wheel
+    for (uint32 i = 0; i < count; ++i)
+        wheel.Schedule(100 + i, i);
+
+    TimerWheel<uint32> copy(wheel);
+    wheel.Clear();
+    copy.Advance(100 + count);
+    due.clear();
+    while (copy.PopDue(value))
+        due.push_back(value);
+
+    REQUIRE(due.size() == count);
+    REQUIRE(std::is_sorted(due.begin(), due.end()));
+}
+
+TEST_CASE("TimerWheel: timers scheduled in the past expire first", "[TimerWheel]")
+{
+    TimerWheel<uint32> wheel;
+    wheel.Advance(1000);
+    wheel.Schedule(1000, 1);
+    wheel.Schedule(500, 2);
+    wheel.Schedule(1000, 3);
+    wheel.Schedule(1001, 4);
+
+    std::vector<uint32> due;
+    uint32 value;
+    while (wheel.PopDue(value))
+        due.push_back(value);
+
+    REQUIRE(due == std::vector<uint32>{ 2, 1, 3 });
+    REQUIRE(wheel.GetSize() == 1);
+}
+
+TEST_CASE("EventProcessor: events execute in time and insertion order", "[EventProcessor]")
+{
+    std::vector<uint32> executed;
+    EventProcessor events;
+
+    BasicEvent* delayed = new CountingEvent(executed, 1);
+    events.AddEventAtOffset(delayed, 100ms);
+    events.AddEventAtOffset(new CountingEvent(executed, 2), 100ms);
+    events.AddEventAtOffset(new CountingEvent(executed, 3), 50ms);
+
+    events.Update(60);
+    REQUIRE(executed == std::vector<uint32>{ 3 });
+
+    events.ModifyEventTime(delayed, events.CalculateTime(100ms));
+    events.Update(40);
+    REQUIRE(executed == std::vector<uint32>{ 3, 2 });
+
+    events.Update(100);
+    REQUIRE(executed == std::vector<uint32>{ 3, 2, 1 });
+
+    events.AddEventAtOffset(new CountingEvent(executed, 4), 10ms);
+    events.KillAllEvents(false);
+    events.Update(20);
+    REQUIRE(executed.size() == 3);
+}
+
+TEST_CASE("TaskScheduler: repeated and delayed tasks", "[TaskScheduler]")
+{
+    TaskScheduler scheduler;
+    std::vector<uint32> executed;
+
+    scheduler.Schedule(100ms, [&](TaskContext context)
+    {
+        executed.push_back(1);
+        if (context.GetRepeatCounter() < 2)
+            context.Repeat(100ms);
+    });
+    scheduler.Schedule(150ms, 1, [&](TaskContext /*context*/)
+    {
+        executed.push_back(2);
+    });
+
+    scheduler.Update(100ms);
+    REQUIRE(executed == std::vector<uint32>{ 1 });
+
+    scheduler.DelayGroup(1, 100ms);
+    scheduler.Update(100ms);
+    REQUIRE(executed == std::vector<uint32>{ 1, 1 });
+
+    scheduler.Update(50ms);
+    REQUIRE(executed == std::vector<uint32>{ 1, 1, 2 });
+
+    scheduler.Update(50ms);
+    REQUIRE(executed == std::vector<uint32>{ 1, 1, 2, 1 });
+}
+
+TEST_CASE("TaskScheduler: tasks are due when their duration has elapsed", "[TaskScheduler]")
+{
+    TaskScheduler scheduler;
+    std::vector<uint32> executed;
+
+    scheduler.Schedule(std::chrono::microseconds(1500), [&](TaskContext /*context*/)
+    {
+        executed.push_back(1);
+    });
+    scheduler.Schedule(std::chrono::microseconds(1900), [&](TaskContext /*context*/)
+    {
+        executed.push_back(2);
+    });
+
+    scheduler.Update(std::chrono::microseconds(1400));
+    REQUIRE(executed.empty());
+
+    scheduler.Update(std::chrono::microseconds(300));
+    REQUIRE(executed == std::vector<uint32>{ 1 });
+
+    scheduler.Update(std::chrono::microseconds(200));
+    REQUIRE(executed == std::vector<uint32>{ 1, 2 });
+}
+
+TEST_CASE("Timer wheel schedulers under script loads", "[!benchmark][TimerWheel]")
+{
+    uint32 const bossCount = 200;
+    uint32 const unitCount = 2000;
+    uint32 const diff = 50;
+
+    // boss scripts: a dozen repeating abilities with 5 to 40 second timers, some of them cancelled and rescheduled
+    BENCHMARK_ADVANCED("EventMap: boss scripts, 60 seconds")(Catch::Benchmark::Chronometer meter)
+    {
+        std::vector<EventMap> bosses(bossCount);
+        for (EventMap& events : bosses)
+            for (uint32 eventId = 1; eventId <= 12; ++eventId)
+                events.ScheduleEvent(eventId, Milliseconds(5000 + eventId * 2500), eventId % 3);
+
+        meter.measure([&]
+        {
+            uint32 executed = 0;
+            for (uint32 time = 0; time < 60000; time += diff)
+            {
+                for (EventMap& events : bosses)
+                {
+                    events.Update(diff);
+                    while (uint32 eventId = events.ExecuteEvent())
+                    {
+                        ++executed;
+                        if (eventId % 4 == 0)
+                            events.RescheduleEvent(eventId % 12 + 1, 8s);
+                        events.Repeat(Milliseconds(5000 + eventId * 2500));
+                    }
+                }
+            }
+            return executed;
+        });
+    };
+
+    // units: short lived spell cast and hit events added every few ticks
+    BENCHMARK_ADVANCED("EventProcessor: unit spell events, 10 seconds")(Catch::Benchmark::Chronometer meter)
+    {
+        std::vector<uint32> executed;
+        executed.reserve(unitCount * 200);
+        std::vector<EventProcessor> units(unitCount);
+
+        meter.measure([&]
+        {
+            executed.clear();
+            for (uint32 time = 0; time < 10000; time += diff)
+            {
+                for (uint32 i = 0; i < unitCount; ++i)
+                {
+                    if ((time / diff + i) % 30 == 0)
+                        units[i].AddEventAtOffset(new CountingEvent(executed, i), Milliseconds(1500 + i % 500));
+                    if ((time / diff + i) % 7 == 0)
+                        units[i].AddEventAtOffset(new CountingEvent(executed, i), Milliseconds(i % 300));
+                    units[i].Update(diff);
+                }
+            }
+            return executed.size();
+        });
+    };
+
+    BENCHMARK_ADVANCED("TaskScheduler: repeating script tasks, 60 seconds")(Catch::Benchmark::Chronometer meter)
+    {
+        uint32 executed = 0;
+        std::vector<std::unique_ptr<TaskScheduler>> schedulers;
+        for (uint32 i = 0; i < bossCount; ++i)
+        {
+            schedulers.push_back(std::make_unique<TaskScheduler>());
+            for (uint32 task = 1; task <= 8; ++task)
+            {
+                schedulers.back()->Schedule(Milliseconds(2000 * task), task % 3, [&executed, task](TaskContext context)
+                {
+                    ++executed;
+                    context.Repeat(Milliseconds(3000 + 1000 * task));
+                });
+            }
+        }
+
+        meter.measure([&]
+        {
+            for (uint32 time = 0; time < 60000; time += diff)
+                for (std::unique_ptr<TaskScheduler>& scheduler : schedulers)
+                    scheduler->Update(Milliseconds(diff));
+            return executed;
+        });
+    };
+
+    // the previous storage of EventMap, for comparison with the boss script load
+    BENCHMARK_ADVANCED("std::multimap: boss scripts, 60 seconds")(Catch::Benchmark::Chronometer meter)
+    {
+        std::vector<std::multimap<uint64, uint32>> bosses(bossCount);
+        for (std::multimap<uint64, uint32>& events : bosses)
+            for (uint32 eventId = 1; eventId <= 12; ++eventId)
+                events.emplace(5000 + eventId * 2500, eventId);
+
+        meter.measure([&]
+        {
+            uint32 executed = 0;
+            for (uint64 time = diff; time <= 60000; time += diff)
+            {
+                for (std::multimap<uint64, uint32>& events : bosses)
+                {
+                    while (!events.empty() && events.begin()->first <= time)
+                    {
+                        uint32 eventId = events.begin()->second;
+                        events.erase(events.begin());
+                        ++executed;
+                        if (eventId % 4 == 0)
+                        {
+                            uint32 cancelled = eventId % 12 + 1;
+                            for (auto itr = events.begin(); itr != events.end();)
+                                itr = itr->second == cancelled ? events.erase(itr) : std::next(itr);
+                            events.emplace(time + 8000, cancelled);
+                        }
+                        events.emplace(time + 5000 + eventId * 2500, eventId);
+                    }
+                }
+            }
+            return executed;
+        });
+    };
+}
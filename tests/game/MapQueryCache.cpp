@@ -0,0 +1,118 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tc_catch2.h"
+
+#include "MapQueryCache.h"
+
+namespace
+{
+    MapLineOfSightCacheKey MakeLineOfSightKey(float x1, float y1, float z1, float x2, float y2, float z2)
+    {
+        return { { GetExactMapQueryCoord(x1), GetExactMapQueryCoord(y1), GetExactMapQueryCoord(z1),
+            GetExactMapQueryCoord(x2), GetExactMapQueryCoord(y2), GetExactMapQueryCoord(z2), 0 } };
+    }
+
+    MapHeightCacheKey MakeHeightKey(int32 i)
+    {
+        return { { i, i, i, i } };
+    }
+}
+
+TEST_CASE("MapQueryCache: Line of sight keys are exact", "[MapQueryCache]")
+{
+    MapQueryCache<MapLineOfSightCacheKey, bool> cache;
+    cache.Resize(64);
+    REQUIRE(cache.IsEnabled());
+
+    cache.Insert(MakeLineOfSightKey(100.0f, 200.0f, 10.0f, 120.0f, 210.0f, 12.0f), false);
+
+    bool result = true;
+    REQUIRE(cache.Find(MakeLineOfSightKey(100.0f, 200.0f, 10.0f, 120.0f, 210.0f, 12.0f), result));
+    REQUIRE(!result);
+
+    // a hundredth of a yard away is a different segment
+    REQUIRE(!cache.Find(MakeLineOfSightKey(100.01f, 200.0f, 10.0f, 120.0f, 210.0f, 12.0f), result));
+    REQUIRE(GetExactMapQueryCoordValue(GetExactMapQueryCoord(-1234.5678f)) == -1234.5678f);
+
+    REQUIRE(cache.GetHits() == 1);
+    REQUIRE(cache.GetMisses() == 1);
+    REQUIRE(cache.GetEntryCount() == 1);
+    REQUIRE(cache.GetMemoryUsage() > 0);
+
+    cache.ResetHitCounters();
+    REQUIRE(cache.GetHits() == 0);
+    REQUIRE(cache.GetMisses() == 0);
+    REQUIRE(cache.GetEntryCount() == 1);
+}
+
+TEST_CASE("MapQueryCache: Least recently used entries are replaced", "[MapQueryCache]")
+{
+    // a single set of 4 ways
+    MapQueryCache<MapHeightCacheKey, float> cache;
+    cache.Resize(4);
+
+    for (int32 i = 0; i < 4; ++i)
+        cache.Insert(MakeHeightKey(i), float(i));
+
+    float height;
+    REQUIRE(cache.Find(MakeHeightKey(0), height));
+    REQUIRE(height == 0.0f);
+
+    // 1 is the oldest entry now
+    cache.Insert(MakeHeightKey(4), 4.0f);
+    REQUIRE(!cache.Find(MakeHeightKey(1), height));
+    REQUIRE(cache.Find(MakeHeightKey(0), height));
+    REQUIRE(cache.Find(MakeHeightKey(4), height));
+    REQUIRE(height == 4.0f);
+    REQUIRE(cache.GetEntryCount() == 4);
+
+    // many accesses later the newest entry is still not the one replaced
+    for (uint32 i = 0; i < 100000; ++i)
+        cache.Find(MakeHeightKey(2), height);
+
+    cache.Insert(MakeHeightKey(5), 5.0f);
+    REQUIRE(cache.Find(MakeHeightKey(5), height));
+    REQUIRE(cache.Find(MakeHeightKey(2), height));
+}
+
+TEST_CASE("MapQueryCache: Invalidate and clear", "[MapQueryCache]")
+{
+    MapQueryCache<MapHeightCacheKey, float> cache;
+    cache.Resize(64);
+
+    for (int32 i = 0; i < 8; ++i)
+        cache.Insert(MakeHeightKey(i), float(i));
+
+    REQUIRE(cache.GetEntryCount() == 8);
+
+    cache.Invalidate([](MapHeightCacheKey const& key) { return key.Values[0] % 2 == 0; });
+    REQUIRE(cache.GetEntryCount() == 4);
+
+    float height;
+    REQUIRE(!cache.Find(MakeHeightKey(2), height));
+    REQUIRE(cache.Find(MakeHeightKey(3), height));
+    REQUIRE(height == 3.0f);
+
+    cache.Clear();
+    REQUIRE(cache.GetEntryCount() == 0);
+    REQUIRE(!cache.Find(MakeHeightKey(3), height));
+
+    MapQueryCache<MapHeightCacheKey, float> disabled;
+    disabled.Resize(0);
+    REQUIRE(!disabled.IsEnabled());
+}
@@ -0,0 +1,79 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tc_catch2.h"
+
+#include "OpcodeProfiler.h"
+#include "Opcodes.h"
+
+TEST_CASE("OpcodeProfiler: Handler time percentiles", "[OpcodeProfiler]")
+{
+    // 90 fast and 10 slow packets
+    OpcodeProfiler::OpcodeStats stats;
+    stats.Count = 100;
+    stats.TimeHistogram[3] = 90;    // [4us, 8us)
+    stats.TimeHistogram[10] = 10;   // [512us, 1024us)
+    stats.MaxTime = std::chrono::microseconds(700);
+
+    REQUIRE(stats.GetTimePercentile(50.0f) == std::chrono::microseconds(8));
+    REQUIRE(stats.GetTimePercentile(90.0f) == std::chrono::microseconds(1024));
+    REQUIRE(stats.GetTimePercentile(99.0f) == std::chrono::microseconds(1024));
+    // every packet is below the percentile, only the maximum is left
+    REQUIRE(stats.GetTimePercentile(100.0f) == std::chrono::microseconds(700));
+
+    OpcodeProfiler::OpcodeStats empty;
+    REQUIRE(empty.GetTimePercentile(50.0f) == std::chrono::microseconds(0));
+}
+
+TEST_CASE("OpcodeProfiler: Deltas across a reset", "[OpcodeProfiler]")
+{
+    uint16 const opcode = CMSG_PING;
+    std::chrono::nanoseconds const queueWait = std::chrono::microseconds(1);
+    std::chrono::nanoseconds const handlerTime = std::chrono::microseconds(5);
+
+    // starts over from whatever was recorded before
+    sOpcodeProfiler->Reset();
+    sOpcodeProfiler->GetStatsSinceLastDelta();
+
+    for (uint32 i = 0; i < 3; ++i)
+        sOpcodeProfiler->Record(opcode, 100, queueWait, handlerTime);
+
+    std::vector<OpcodeProfiler::OpcodeStats> delta = sOpcodeProfiler->GetStatsSinceLastDelta();
+    REQUIRE(delta[opcode].Count == 3);
+    REQUIRE(delta[opcode].Bytes == 300);
+    REQUIRE(delta[opcode].TotalTime == 3 * handlerTime);
+    REQUIRE(delta[opcode].TimeHistogram[3] == 3);
+
+    delta = sOpcodeProfiler->GetStatsSinceLastDelta();
+    REQUIRE(delta[opcode].Count == 0);
+    REQUIRE(delta[opcode].Bytes == 0);
+
+    // more packets than before the reset, the counters must not be compared with the old ones
+    sOpcodeProfiler->Reset();
+    for (uint32 i = 0; i < 5; ++i)
+        sOpcodeProfiler->Record(opcode, 10, queueWait, handlerTime);
+
+    delta = sOpcodeProfiler->GetStatsSinceLastDelta();
+    REQUIRE(delta[opcode].Count == 5);
+    REQUIRE(delta[opcode].Bytes == 50);
+    REQUIRE(delta[opcode].TotalTime == 5 * handlerTime);
+    REQUIRE(delta[opcode].TotalQueueWait == 5 * queueWait);
+    REQUIRE(delta[opcode].TimeHistogram[3] == 5);
+    REQUIRE(delta[opcode].GetTimePercentile(50.0f) == std::chrono::microseconds(8));
+
+    REQUIRE(sOpcodeProfiler->GetStats()[opcode].Count == 5);
+}
@@ -0,0 +1,67 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tc_catch2.h"
+
+#include "DummyData.h"
+#include "SmartScript.h"
+#include "SpellDefines.h"
+#include "SpellInfo.h"
+#include "SpellMgr.h"
+
+namespace
+{
+    SmartScriptHolder CreateAction(SMART_ACTION action, uint32 param1, uint32 param2, SMARTAI_TARGETS target)
+    {
+        return SmartScript::CreateSmartEvent(SMART_EVENT_UPDATE_IC, 0, 0, 0, 0, 0, 0, action, param1, param2, 0, 0, 0, 0, target, 0, 0, 0, 0, 0);
+    }
+}
+
+TEST_CASE("SmartScript: CompileAction resolves handlers, spells and targets", "[SmartScript]")
+{
+    UnitTestDataLoader::LoadSpellInfo();
+
+    SmartScriptHolder cast = CreateAction(SMART_ACTION_CAST, 51562, SMARTCAST_TRIGGERED, SMART_TARGET_VICTIM);
+    REQUIRE(cast.compiled.Handler);
+    REQUIRE(cast.compiled.Spell == sSpellMgr->GetSpellInfo(51562));
+    REQUIRE(cast.compiled.TriggerFlags == uint32(TRIGGERED_FULL_MASK));
+    REQUIRE(cast.compiled.TargetSelector);
+    REQUIRE(cast.compiled.UsesTargets);
+
+    // casts by id through the interpreter
+    SmartScriptHolder unknownSpell = CreateAction(SMART_ACTION_SELF_CAST, 1, 0, SMART_TARGET_SELF);
+    REQUIRE(!unknownSpell.compiled.Handler);
+    REQUIRE(!unknownSpell.compiled.Spell);
+    REQUIRE(unknownSpell.compiled.TriggerFlags == uint32(TRIGGERED_NONE));
+
+    SmartScriptHolder phase = CreateAction(SMART_ACTION_SET_EVENT_PHASE, 2, 0, SMART_TARGET_SELF);
+    REQUIRE(phase.compiled.Handler);
+    REQUIRE(!phase.compiled.TargetSelector);
+    REQUIRE(!phase.compiled.UsesTargets);
+
+    // interpreted actions still get their targets resolved
+    SmartScriptHolder talk = CreateAction(SMART_ACTION_TALK, 0, 0, SMART_TARGET_ACTION_INVOKER);
+    REQUIRE(!talk.compiled.Handler);
+    REQUIRE(talk.compiled.TargetSelector);
+
+    SmartScriptHolder searched = CreateAction(SMART_ACTION_TALK, 0, 0, SMART_TARGET_CLOSEST_CREATURE);
+    REQUIRE(!searched.compiled.TargetSelector);
+    REQUIRE(searched.compiled.UsesTargets);
+
+    SmartScriptHolder untargeted = CreateAction(SMART_ACTION_TALK, 0, 0, SMART_TARGET_NONE);
+    REQUIRE(!untargeted.compiled.UsesTargets);
+}
@@ -0,0 +1,269 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tc_catch2.h"
+
+#include "DBCStructure.h"
+#include "DummyData.h"
+#include "SharedDefines.h"
+#include "SpellInfo.h"
+#include "SpellMgr.h"
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <set>
+
+// fields read by target, location, aura state and cost checks of a cast
+#define SPELL_INFO_CAST_PATH_FIELDS(FIELD) \
+    FIELD(Attributes) FIELD(AttributesEx) FIELD(AttributesEx2) FIELD(AttributesEx3) FIELD(AttributesEx4) FIELD(AttributesEx5) \
+    FIELD(AttributesEx6) FIELD(AttributesEx7) FIELD(AttributesCu) FIELD(Dispel) FIELD(Mechanic) FIELD(SchoolMask) FIELD(DmgClass) \
+    FIELD(PreventionType) FIELD(SpellFamilyName) FIELD(SpellFamilyFlags) FIELD(ExplicitTargetMask) FIELD(Targets) \
+    FIELD(TargetCreatureType) FIELD(FacingCasterFlags) FIELD(RequiresSpellFocus) FIELD(Stances) FIELD(StancesNot) \
+    FIELD(CasterAuraState) FIELD(TargetAuraState) FIELD(CasterAuraStateNot) FIELD(TargetAuraStateNot) FIELD(CasterAuraSpell) \
+    FIELD(TargetAuraSpell) FIELD(ExcludeCasterAuraSpell) FIELD(ExcludeTargetAuraSpell) FIELD(MaxTargetLevel) \
+    FIELD(MaxAffectedTargets) FIELD(AreaGroupId) FIELD(CastTimeEntry) FIELD(DurationEntry) FIELD(RangeEntry) FIELD(Speed) \
+    FIELD(InterruptFlags) FIELD(PowerType) FIELD(ManaCost) FIELD(ManaCostPercentage) FIELD(RuneCostID) FIELD(EquippedItemClass)
+
+namespace
+{
+    uint32 const SpellCount = 50000;
+
+    // the public fields of SpellInfo in their order before they were grouped by the cast path
+    struct SpellInfoOldLayoutFields
+    {
+        uint32 Id;
+        SpellCategoryEntry const* CategoryEntry;
+        uint32 Dispel;
+        uint32 Mechanic;
+        uint32 Attributes;
+        uint32 AttributesEx;
+        uint32 AttributesEx2;
+        uint32 AttributesEx3;
+        uint32 AttributesEx4;
+        uint32 AttributesEx5;
+        uint32 AttributesEx6;
+        uint32 AttributesEx7;
+        uint32 AttributesCu;
+        uint64 Stances;
+        uint64 StancesNot;
+        uint32 Targets;
+        uint32 TargetCreatureType;
+        uint32 RequiresSpellFocus;
+        uint32 FacingCasterFlags;
+        uint32 CasterAuraState;
+        uint32 TargetAuraState;
+        uint32 CasterAuraStateNot;
+        uint32 TargetAuraStateNot;
+        uint32 CasterAuraSpell;
+        uint32 TargetAuraSpell;
+        uint32 ExcludeCasterAuraSpell;
+        uint32 ExcludeTargetAuraSpell;
+        SpellCastTimesEntry const* CastTimeEntry;
+        uint32 RecoveryTime;
+        uint32 CategoryRecoveryTime;
+        uint32 StartRecoveryCategory;
+        uint32 StartRecoveryTime;
+        uint32 InterruptFlags;
+        uint32 AuraInterruptFlags;
+        uint32 ChannelInterruptFlags;
+        uint32 ProcFlags;
+        uint32 ProcChance;
+        uint32 ProcCharges;
+        uint32 MaxLevel;
+        uint32 BaseLevel;
+        uint32 SpellLevel;
+        SpellDurationEntry const* DurationEntry;
+        Powers PowerType;
+        uint32 ManaCost;
+        uint32 ManaCostPerlevel;
+        uint32 ManaPerSecond;
+        uint32 ManaPerSecondPerLevel;
+        uint32 ManaCostPercentage;
+        uint32 RuneCostID;
+        SpellRangeEntry const* RangeEntry;
+        float  Speed;
+        uint32 StackAmount;
+        std::array<uint32, 2> Totem;
+        std::array<int32, MAX_SPELL_REAGENTS>  Reagent;
+        std::array<uint32, MAX_SPELL_REAGENTS> ReagentCount;
+        int32  EquippedItemClass;
+        int32  EquippedItemSubClassMask;
+        int32  EquippedItemInventoryTypeMask;
+        std::array<uint32, 2> TotemCategory;
+        std::array<uint32, 2> SpellVisual;
+        uint32 SpellIconID;
+        uint32 ActiveIconID;
+        uint32 Priority;
+        std::array<char const*, 16> SpellName;
+        std::array<char const*, 16> Rank;
+        uint32 MaxTargetLevel;
+        uint32 MaxAffectedTargets;
+        uint32 SpellFamilyName;
+        flag96 SpellFamilyFlags;
+        uint32 DmgClass;
+        uint32 PreventionType;
+        int32  AreaGroupId;
+        uint32 SchoolMask;
+        std::array<SpellEffectInfo, MAX_SPELL_EFFECTS> _effects;
+        uint32 ExplicitTargetMask;
+        SpellChainNode const* ChainEntry;
+    };
+
+    // padded with the private data of SpellInfo, so both layouts have the same size and spacing in an array
+    struct SpellInfoOldLayout : SpellInfoOldLayoutFields
+    {
+        std::array<char, sizeof(SpellInfo) - sizeof(SpellInfoOldLayoutFields)> PrivateData;
+    };
+
+    static_assert(sizeof(SpellInfoOldLayout) == sizeof(SpellInfo), "SpellInfoOldLayout must mirror the size of SpellInfo");
+
+    SpellInfoOldLayout CreateOldLayout(SpellInfo const& spellInfo)
+    {
+        SpellInfoOldLayout old = {};
+        old.Id = spellInfo.Id;
+#define COPY_FIELD(field) old.field = spellInfo.field;
+        SPELL_INFO_CAST_PATH_FIELDS(COPY_FIELD)
+#undef COPY_FIELD
+        old._effects = spellInfo._effects;
+        return old;
+    }
+
+    // byte ranges of the cast path fields, relative to the start of the object
+    template<class Layout>
+    std::vector<std::pair<std::size_t, std::size_t>> GetCastPathFieldRanges(Layout const& layout)
+    {
+        char const* base = reinterpret_cast<char const*>(&layout);
+        std::vector<std::pair<std::size_t, std::size_t>> ranges;
+#define ADD_FIELD_RANGE(field) ranges.emplace_back(reinterpret_cast<char const*>(&layout.field) - base, sizeof(layout.field));
+        SPELL_INFO_CAST_PATH_FIELDS(ADD_FIELD_RANGE)
+        ADD_FIELD_RANGE(_effects[EFFECT_0].Effect)
+        ADD_FIELD_RANGE(_effects[EFFECT_0].ApplyAuraName)
+        ADD_FIELD_RANGE(_effects[EFFECT_0].TargetA)
+        ADD_FIELD_RANGE(_effects[EFFECT_0].TargetB)
+#undef ADD_FIELD_RANGE
+        return ranges;
+    }
+
+    // cache lines touched by the cast path, summed over every 8 byte aligned position of the object within a cache line
+    template<class Layout>
+    uint32 CountCastPathCacheLines(Layout const& layout)
+    {
+        uint32 lines = 0;
+        for (std::size_t start = 0; start < 64; start += 8)
+        {
+            std::set<std::size_t> touched;
+            for (std::pair<std::size_t, std::size_t> const& range : GetCastPathFieldRanges(layout))
+                for (std::size_t line = (start + range.first) / 64; line <= (start + range.first + range.second - 1) / 64; ++line)
+                    touched.insert(line);
+
+            lines += uint32(touched.size());
+        }
+
+        return lines;
+    }
+
+    SpellEntry CreateSpellEntry(uint32 id)
+    {
+        SpellEntry entry = {};
+        entry.ID = id;
+        entry.Attributes = id % 3 ? uint32(SPELL_ATTR0_PASSIVE) : 0;
+        entry.AttributesExC = id % 5 ? uint32(SPELL_ATTR3_IGNORE_HIT_RESULT) : 0;
+        entry.Targets = id % 7;
+        entry.SchoolMask = 1 << (id % 7);
+        entry.Effect = { SPELL_EFFECT_SCHOOL_DAMAGE, 0, 0 };
+        entry.EffectChainAmplitude.fill(1.0f);
+        return entry;
+    }
+
+    // what a cast reads in CheckTarget, CheckLocation, CheckPower and IsPositive like checks
+    template<class Layout>
+    uint32 CastPathChecks(Layout const& spellInfo)
+    {
+        uint32 result = 0;
+        if (!(spellInfo.Attributes & SPELL_ATTR0_PASSIVE))
+            ++result;
+        if (spellInfo.AttributesEx3 & SPELL_ATTR3_IGNORE_HIT_RESULT)
+            ++result;
+        if (spellInfo.AttributesCu & SPELL_ATTR0_CU_NEGATIVE)
+            ++result;
+        result += spellInfo.SchoolMask + spellInfo.Targets + spellInfo.ExplicitTargetMask + spellInfo.Mechanic + spellInfo.AreaGroupId;
+        result += spellInfo.CasterAuraState + spellInfo.TargetAuraSpell + spellInfo.PowerType + spellInfo.ManaCost;
+        if (spellInfo.CastTimeEntry || spellInfo.RangeEntry)
+            ++result;
+        result += spellInfo._effects[EFFECT_0].Effect + spellInfo._effects[EFFECT_0].TargetA.GetTarget();
+        return result;
+    }
+}
+
+TEST_CASE("SpellInfo: Cast path fields share fewer cache lines", "[SpellInfo]")
+{
+    UnitTestDataLoader::LoadSpellInfo();
+    SpellInfo const* spellInfo = sSpellMgr->AssertSpellInfo(51562);
+    SpellInfoOldLayout old = CreateOldLayout(*spellInfo);
+
+    REQUIRE(CastPathChecks(*spellInfo) == CastPathChecks(old));
+
+    uint32 oldLines = CountCastPathCacheLines(old);
+    uint32 newLines = CountCastPathCacheLines(*spellInfo);
+    UNSCOPED_INFO("cache lines per cast, 8 alignments summed: old layout " << oldLines << ", new layout " << newLines);
+    REQUIRE(newLines < oldLines);
+}
+
+TEST_CASE("SpellInfo: Cast path layout", "[!benchmark][SpellInfo]")
+{
+    std::vector<SpellEntry> entries;
+    entries.reserve(SpellCount);
+    for (uint32 i = 0; i < SpellCount; ++i)
+        entries.push_back(CreateSpellEntry(i + 1));
+
+    // random cast order, like spells cast on a busy map
+    std::vector<uint32> castOrder(SpellCount);
+    for (uint32 i = 0; i < SpellCount; ++i)
+        castOrder[i] = i;
+    std::shuffle(castOrder.begin(), castOrder.end(), std::mt19937(1234));
+
+    // both layouts in one block in id order, as SpellMgr::LoadSpellInfoStore stores them
+    std::allocator<SpellInfo> allocator;
+    SpellInfo* current = allocator.allocate(SpellCount);
+    for (uint32 i = 0; i < SpellCount; ++i)
+        new (&current[i]) SpellInfo(&entries[i]);
+
+    std::vector<SpellInfoOldLayout> old;
+    old.reserve(SpellCount);
+    for (uint32 i = 0; i < SpellCount; ++i)
+        old.push_back(CreateOldLayout(current[i]));
+
+    BENCHMARK("old field order")
+    {
+        uint32 result = 0;
+        for (uint32 index : castOrder)
+            result += CastPathChecks(old[index]);
+        return result;
+    };
+
+    BENCHMARK("cast path fields first")
+    {
+        uint32 result = 0;
+        for (uint32 index : castOrder)
+            result += CastPathChecks(current[index]);
+        return result;
+    };
+
+    for (uint32 i = 0; i < SpellCount; ++i)
+        current[i].~SpellInfo();
+    allocator.deallocate(current, SpellCount);
+}
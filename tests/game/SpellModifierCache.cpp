@@ -0,0 +1,138 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tc_catch2.h"
+
+#include "DummyData.h"
+#include "Player.h"
+#include "SpellInfo.h"
+#include "SpellMgr.h"
+#include "SpellModifierCache.h"
+#include <memory>
+
+namespace
+{
+    SpellModifier* CreateSpellMod(std::vector<std::unique_ptr<SpellModifier>>& storage, uint32 spellId, SpellModOp op, SpellModType type, int32 value, flag96 mask)
+    {
+        SpellModifier* mod = storage.emplace_back(std::make_unique<SpellModifier>(nullptr)).get();
+        mod->op = op;
+        mod->type = type;
+        mod->value = value;
+        mod->mask = mask;
+        mod->spellId = spellId;
+        return mod;
+    }
+
+    // the modifier scan Player::ApplySpellMod did for every call
+    float ScanSpellMods(SpellInfo const* spellInfo, SpellModContainer const& mods, float basevalue)
+    {
+        float totalmul = 1.0f;
+        int32 totalflat = 0;
+        for (SpellModifier* mod : mods)
+        {
+            if (!Player::IsAffectedBySpellmod(spellInfo, mod))
+                continue;
+
+            if (mod->type == SPELLMOD_FLAT)
+                totalflat += mod->value;
+            else
+                totalmul += CalculatePct(1.0f, mod->value);
+        }
+
+        return (basevalue + totalflat) * totalmul;
+    }
+
+    float ApplyResolvedSpellMods(SpellModifierCache::Entry const& entry, float basevalue)
+    {
+        return (basevalue + entry.Flat) * (1.0f + entry.Pct);
+    }
+}
+
+TEST_CASE("SpellModifierCache resolves modifiers like a full scan", "[SpellModifierCache]")
+{
+    UnitTestDataLoader::LoadSpellInfo();
+    SpellInfo const* earthShield = sSpellMgr->AssertSpellInfo(974);
+    SpellInfo const* tidalWaves = sSpellMgr->AssertSpellInfo(51562);
+
+    std::vector<std::unique_ptr<SpellModifier>> storage;
+    SpellModContainer mods;
+    // Improved Earth Shield affects Earth Shield, Tidal Waves does not
+    mods.insert(CreateSpellMod(storage, 51560, SPELLMOD_DAMAGE, SPELLMOD_FLAT, 10, flag96(0, 1024, 0)));
+    mods.insert(CreateSpellMod(storage, 51560, SPELLMOD_DAMAGE, SPELLMOD_PCT, 5, flag96(0, 1024, 0)));
+    mods.insert(CreateSpellMod(storage, 51562, SPELLMOD_DAMAGE, SPELLMOD_PCT, 20, flag96(64, 0, 0)));
+
+    SpellModifierCache cache;
+    SpellModifierCache::Entry const& entry = cache.Get(earthShield, SPELLMOD_DAMAGE, mods);
+    REQUIRE(entry.Flat == 10);
+    REQUIRE(entry.Pct == Approx(0.05f));
+    REQUIRE(entry.Applied.size() == 2);
+    REQUIRE(entry.Dynamic.empty());
+    REQUIRE(ApplyResolvedSpellMods(entry, 100.0f) == Approx(ScanSpellMods(earthShield, mods, 100.0f)));
+
+    SpellModifierCache::Entry const& unaffected = cache.Get(tidalWaves, SPELLMOD_DAMAGE, mods);
+    REQUIRE(unaffected.Flat == 0);
+    REQUIRE(unaffected.Applied.empty());
+
+    SECTION("entries are reused until invalidated")
+    {
+        mods.insert(CreateSpellMod(storage, 51560, SPELLMOD_DAMAGE, SPELLMOD_FLAT, 7, flag96(0, 1024, 0)));
+        REQUIRE(cache.Get(earthShield, SPELLMOD_DAMAGE, mods).Flat == 10);
+
+        cache.Invalidate();
+        REQUIRE(cache.Get(earthShield, SPELLMOD_DAMAGE, mods).Flat == 17);
+        REQUIRE(ApplyResolvedSpellMods(cache.Get(earthShield, SPELLMOD_DAMAGE, mods), 100.0f) == Approx(ScanSpellMods(earthShield, mods, 100.0f)));
+    }
+
+    SECTION("special cased percent modifiers are checked per call")
+    {
+        SpellModContainer castTimeMods;
+        castTimeMods.insert(CreateSpellMod(storage, 51560, SPELLMOD_CASTING_TIME, SPELLMOD_PCT, -100, flag96(0, 1024, 0)));
+        castTimeMods.insert(CreateSpellMod(storage, 51560, SPELLMOD_CASTING_TIME, SPELLMOD_PCT, -10, flag96(0, 1024, 0)));
+
+        SpellModifierCache::Entry const& castTime = cache.Get(earthShield, SPELLMOD_CASTING_TIME, castTimeMods);
+        REQUIRE(castTime.Pct == Approx(-0.1f));
+        REQUIRE(castTime.Applied.size() == 1);
+        REQUIRE(castTime.Dynamic.size() == 1);
+    }
+}
+
+TEST_CASE("SpellModifierCache compared to a full modifier scan", "[!benchmark][SpellModifierCache]")
+{
+    UnitTestDataLoader::LoadSpellInfo();
+    SpellInfo const* earthShield = sSpellMgr->AssertSpellInfo(974);
+
+    // a caster with plenty of talents, most of them not affecting the spell
+    std::vector<std::unique_ptr<SpellModifier>> storage;
+    SpellModContainer mods;
+    for (int32 i = 0; i < 40; ++i)
+    {
+        bool affects = i % 8 == 0;
+        mods.insert(CreateSpellMod(storage, affects ? 51560 : 51562, SPELLMOD_DAMAGE, i % 2 ? SPELLMOD_PCT : SPELLMOD_FLAT, i + 1, affects ? flag96(0, 1024, 0) : flag96(64, 0, 0)));
+    }
+
+    SpellModifierCache cache;
+
+    BENCHMARK("full scan")
+    {
+        return ScanSpellMods(earthShield, mods, 100.0f);
+    };
+
+    BENCHMARK("cached")
+    {
+        return ApplyResolvedSpellMods(cache.Get(earthShield, SPELLMOD_DAMAGE, mods), 100.0f);
+    };
+}
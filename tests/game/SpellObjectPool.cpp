@@ -0,0 +1,130 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tc_catch2.h"
+
+#include "SpellObjectPool.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // every test runs on its own thread, so it starts with empty free lists
+    template<class Test>
+    void RunOnNewThread(Test&& test)
+    {
+        std::thread thread(std::forward<Test>(test));
+        thread.join();
+    }
+
+    // destroyed after the free lists of the thread if it is constructed before them
+    struct LateDestroyedObject
+    {
+        ~LateDestroyedObject()
+        {
+            void* block = SpellObjectPool::Allocate(SPELL_OBJECT_POOL_SPELL_EVENT, 48);
+            SpellObjectPool::Deallocate(SPELL_OBJECT_POOL_SPELL_EVENT, block, 48);
+            SpellObjectPool::Deallocate(SPELL_OBJECT_POOL_SPELL_EVENT, Block, 48);
+        }
+
+        void* Block = nullptr;
+    };
+}
+
+TEST_CASE("SpellObjectPool: Freed blocks are reused", "[SpellObjectPool]")
+{
+    RunOnNewThread([]
+    {
+        void* first = SpellObjectPool::Allocate(SPELL_OBJECT_POOL_SPELL, 64);
+        void* second = SpellObjectPool::Allocate(SPELL_OBJECT_POOL_SPELL, 64);
+        SpellObjectPool::Deallocate(SPELL_OBJECT_POOL_SPELL, first, 64);
+        SpellObjectPool::Deallocate(SPELL_OBJECT_POOL_SPELL, second, 64);
+
+        // last freed, first reused
+        REQUIRE(SpellObjectPool::Allocate(SPELL_OBJECT_POOL_SPELL, 64) == second);
+        REQUIRE(SpellObjectPool::Allocate(SPELL_OBJECT_POOL_SPELL, 64) == first);
+
+        // every pool keeps its own blocks
+        SpellObjectPool::Deallocate(SPELL_OBJECT_POOL_SPELL, first, 64);
+        void* aura = SpellObjectPool::Allocate(SPELL_OBJECT_POOL_UNIT_AURA, 64);
+        REQUIRE(aura != first);
+
+        SpellObjectPool::Deallocate(SPELL_OBJECT_POOL_UNIT_AURA, aura, 64);
+        SpellObjectPool::Deallocate(SPELL_OBJECT_POOL_SPELL, second, 64);
+    });
+}
+
+TEST_CASE("SpellObjectPool: Blocks of another size are not pooled", "[SpellObjectPool]")
+{
+    RunOnNewThread([]
+    {
+        // the first freed block fixes the block size of the pool
+        void* block = SpellObjectPool::Allocate(SPELL_OBJECT_POOL_AURA_EFFECT, 64);
+        SpellObjectPool::Deallocate(SPELL_OBJECT_POOL_AURA_EFFECT, block, 64);
+
+        void* smaller = SpellObjectPool::Allocate(SPELL_OBJECT_POOL_AURA_EFFECT, 32);
+        REQUIRE(smaller != block);
+
+        SpellObjectPool::Deallocate(SPELL_OBJECT_POOL_AURA_EFFECT, smaller, 32);
+        REQUIRE(SpellObjectPool::Allocate(SPELL_OBJECT_POOL_AURA_EFFECT, 64) == block);
+
+        SpellObjectPool::Deallocate(SPELL_OBJECT_POOL_AURA_EFFECT, block, 64);
+    });
+}
+
+TEST_CASE("SpellObjectPool: Free lists are capped", "[SpellObjectPool]")
+{
+    RunOnNewThread([]
+    {
+        std::vector<void*> blocks;
+        for (uint32 i = 0; i <= SPELL_OBJECT_POOL_MAX_FREE_BLOCKS; ++i)
+            blocks.push_back(SpellObjectPool::Allocate(SPELL_OBJECT_POOL_AURA_APPLICATION, 32));
+
+        // the last block goes over the cap and is returned to the heap
+        for (void* block : blocks)
+            SpellObjectPool::Deallocate(SPELL_OBJECT_POOL_AURA_APPLICATION, block, 32);
+
+        std::vector<void*> reused;
+        for (uint32 i = 0; i < SPELL_OBJECT_POOL_MAX_FREE_BLOCKS; ++i)
+            reused.push_back(SpellObjectPool::Allocate(SPELL_OBJECT_POOL_AURA_APPLICATION, 32));
+
+        REQUIRE(reused.front() == blocks[SPELL_OBJECT_POOL_MAX_FREE_BLOCKS - 1]);
+        REQUIRE(reused.back() == blocks.front());
+        REQUIRE(std::find(reused.begin(), reused.end(), blocks.back()) == reused.end());
+
+        for (void* block : reused)
+            SpellObjectPool::Deallocate(SPELL_OBJECT_POOL_AURA_APPLICATION, block, 32);
+    });
+}
+
+TEST_CASE("SpellObjectPool: Objects destroyed after the free lists of their thread", "[SpellObjectPool]")
+{
+    RunOnNewThread([]
+    {
+        // constructed before the first use of the pool on this thread
+        thread_local LateDestroyedObject lateObject;
+        LateDestroyedObject& late = lateObject;
+        late.Block = SpellObjectPool::Allocate(SPELL_OBJECT_POOL_SPELL_EVENT, 48);
+
+        void* block = SpellObjectPool::Allocate(SPELL_OBJECT_POOL_SPELL_EVENT, 48);
+        SpellObjectPool::Deallocate(SPELL_OBJECT_POOL_SPELL_EVENT, block, 48);
+        // lateObject is destroyed when the thread exits, after the free lists, and must not touch freed blocks
+    });
+
+    SUCCEED();
+}